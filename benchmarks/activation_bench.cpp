@@ -0,0 +1,55 @@
+#include <benchmark/benchmark.h>
+#include "cppgrad/tensor/tensor.hpp"
+
+// Forward + backward through one activation on an N-element tensor.
+// Arg 1 = 0 composes it from exp / + / * / (several graph nodes and buffers),
+// 1 uses the fused op (one node, derivative from the saved output).
+
+static void BM_Sigmoid(benchmark::State& state) {
+    const size_t N = static_cast<size_t>(state.range(0));
+    const bool fused = state.range(1) != 0;
+    cppgrad::Tensor x = cppgrad::Tensor::randn({N}, /*requires_grad=*/true);
+
+    for (auto _ : state) {
+        auto y = fused ? sigmoid(x) : 1.0f / (1.0f + exp(-x));
+        y.sum().backward();
+        af::eval(x.grad());
+        af::sync();
+        x.zero_grad();
+    }
+    state.SetItemsProcessed(state.iterations() * N);
+}
+
+static void BM_Tanh(benchmark::State& state) {
+    const size_t N = static_cast<size_t>(state.range(0));
+    const bool fused = state.range(1) != 0;
+    cppgrad::Tensor x = cppgrad::Tensor::randn({N}, /*requires_grad=*/true);
+
+    for (auto _ : state) {
+        auto y = fused ? tanh(x) : 2.0f / (1.0f + exp(-2.0f * x)) - 1.0f;
+        y.sum().backward();
+        af::eval(x.grad());
+        af::sync();
+        x.zero_grad();
+    }
+    state.SetItemsProcessed(state.iterations() * N);
+}
+
+static void BM_Silu(benchmark::State& state) {
+    const size_t N = static_cast<size_t>(state.range(0));
+    const bool fused = state.range(1) != 0;
+    cppgrad::Tensor x = cppgrad::Tensor::randn({N}, /*requires_grad=*/true);
+
+    for (auto _ : state) {
+        auto y = fused ? silu(x) : x / (1.0f + exp(-x));
+        y.sum().backward();
+        af::eval(x.grad());
+        af::sync();
+        x.zero_grad();
+    }
+    state.SetItemsProcessed(state.iterations() * N);
+}
+
+BENCHMARK(BM_Sigmoid)->Args({1 << 20, 0})->Args({1 << 20, 1});
+BENCHMARK(BM_Tanh)->Args({1 << 20, 0})->Args({1 << 20, 1});
+BENCHMARK(BM_Silu)->Args({1 << 20, 0})->Args({1 << 20, 1});
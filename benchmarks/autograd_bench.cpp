@@ -0,0 +1,88 @@
+#include <benchmark/benchmark.h>
+#include "cppgrad/tensor/tensor.hpp"
+#include "cppgrad/tensor/tensorutils.hpp"
+#include "cppgrad/autograd/engine.hpp"
+
+// Benchmark: backward through a stack of diamonds, x_{k+1} = x_k * x_k - x_k.
+// Every level reuses x_k twice, so a recursive walk would be O(2^depth);
+// the engine applies each node once and should scale linearly with depth.
+static void BM_BackwardDiamond(benchmark::State& state) {
+    const int depth = static_cast<int>(state.range(0));
+    cppgrad::Tensor x = cppgrad::Tensor::full({4}, 0.5f, /*requires_grad=*/true);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        cppgrad::Tensor y = x;
+        for (int i = 0; i < depth; ++i) y = y * y - y;
+        state.ResumeTiming();
+
+        y.backward();
+        af::sync();
+    }
+    state.SetComplexityN(depth);
+}
+
+// Benchmark: backward through a long linear chain of unary ops.
+static void BM_BackwardChain(benchmark::State& state) {
+    const int depth = static_cast<int>(state.range(0));
+    cppgrad::Tensor x = cppgrad::Tensor::full({4}, 1.0f, /*requires_grad=*/true);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        cppgrad::Tensor y = x;
+        for (int i = 0; i < depth; ++i) y = -y;
+        state.ResumeTiming();
+
+        y.backward();
+        af::sync();
+    }
+    state.SetComplexityN(depth);
+}
+
+BENCHMARK(BM_BackwardDiamond)
+    ->RangeMultiplier(2)
+    ->Range(8, 256)
+    ->Complexity(benchmark::oN);
+
+BENCHMARK(BM_BackwardChain)
+    ->Arg(1000)
+    ->Arg(5000)
+    ->Arg(10000)
+    ->Complexity(benchmark::oN);
+
+// Benchmark: backward through a wide graph of independent matmul branches,
+// out = sum_i (x @ W_i) @ V_i. Args: {branches, worker threads}.
+static void BM_BackwardWideParallel(benchmark::State& state) {
+    const int branches = static_cast<int>(state.range(0));
+    const size_t N = 256;
+    cppgrad::Engine::set_num_threads(static_cast<size_t>(state.range(1)));
+
+    cppgrad::Tensor x = cppgrad::Tensor::randn({N, N}, /*requires_grad=*/true);
+    std::vector<cppgrad::Tensor> W, V;
+    for (int i = 0; i < branches; ++i) {
+        W.push_back(cppgrad::Tensor::randn({N, N}, true));
+        V.push_back(cppgrad::Tensor::randn({N, N}, true));
+    }
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        cppgrad::Tensor out = cppgrad::TensorUtils::matmul(cppgrad::TensorUtils::matmul(x, W[0]), V[0]);
+        for (int i = 1; i < branches; ++i) {
+            out = out + cppgrad::TensorUtils::matmul(cppgrad::TensorUtils::matmul(x, W[i]), V[i]);
+        }
+        cppgrad::Tensor loss = out.sum();
+        af::sync();
+        state.ResumeTiming();
+
+        loss.backward();
+        af::sync();
+    }
+    cppgrad::Engine::set_num_threads(1);
+}
+
+BENCHMARK(BM_BackwardWideParallel)
+    ->Args({16, 1})
+    ->Args({16, 2})
+    ->Args({16, 4})
+    ->Args({16, 8})
+    ->UseRealTime();
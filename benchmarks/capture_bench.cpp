@@ -0,0 +1,50 @@
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <vector>
+#include "cppgrad/tensor/tensor.hpp"
+#include "cppgrad/autograd/capture.hpp"
+#include "cppgrad/nn/linear.hpp"
+#include "cppgrad/nn/sequential.hpp"
+#include "cppgrad/optim/sgd.hpp"
+
+// Benchmark: training step of a narrow, deep MLP, where graph construction
+// rather than arithmetic dominates.
+// Args: depth, width, batch, captured (0 = eager, 1 = capture() replay).
+static void BM_TrainStepCapture(benchmark::State& state) {
+    const size_t depth = static_cast<size_t>(state.range(0));
+    const size_t width = static_cast<size_t>(state.range(1));
+    const size_t batch = static_cast<size_t>(state.range(2));
+    const bool captured = state.range(3) != 0;
+
+    cppgrad::nn::Sequential mlp;
+    for (size_t i = 0; i < depth; ++i) {
+        mlp.push_back(std::make_shared<cppgrad::nn::Linear>(width, width, cppgrad::Activation::Tanh));
+    }
+    cppgrad::optim::SGD opt(mlp.parameters(), { .lr = 1e-3f });
+    cppgrad::Tensor x = cppgrad::Tensor::randn({batch, width});
+    cppgrad::Tensor y = cppgrad::Tensor::randn({batch, width});
+
+    auto loss_fn = [&](const std::vector<cppgrad::Tensor>& in) {
+        return pow(mlp(in[0]) - in[1], 2.0f).mean();
+    };
+    cppgrad::CapturedStep step = cppgrad::capture(loss_fn);
+
+    for (auto _ : state) {
+        opt.zero_grad();
+        if (captured) {
+            step({ x, y });
+        } else {
+            loss_fn({ x, y }).backward();
+        }
+        opt.step();
+        af::sync();
+    }
+    state.counters["replays"] = static_cast<double>(step.replays());
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+
+BENCHMARK(BM_TrainStepCapture)
+    ->Args({64, 32, 16, 0})
+    ->Args({64, 32, 16, 1})
+    ->Args({8, 1024, 256, 0})
+    ->Args({8, 1024, 256, 1});
@@ -0,0 +1,57 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "cppgrad/tensor/tensor.hpp"
+#include "cppgrad/autograd/checkpoint.hpp"
+#include "cppgrad/memory/memorypool.hpp"
+#include "cppgrad/nn/linear.hpp"
+#include "cppgrad/nn/sequential.hpp"
+
+// Benchmark: forward + backward of a deep MLP, with the step's peak device
+// memory reported as a counter.
+// Args: depth, width, batch, segment length (0 = no checkpointing, k = one
+//       checkpoint per k layers).
+static void BM_DeepMlpCheckpoint(benchmark::State& state) {
+    const size_t depth = static_cast<size_t>(state.range(0));
+    const size_t width = static_cast<size_t>(state.range(1));
+    const size_t batch = static_cast<size_t>(state.range(2));
+    const size_t segment = static_cast<size_t>(state.range(3));
+
+    if (!cppgrad::MemoryPool::is_installed()) cppgrad::MemoryPool::install();
+
+    std::vector<std::shared_ptr<cppgrad::nn::Sequential>> blocks;
+    for (size_t i = 0; i < depth; i += segment == 0 ? depth : segment) {
+        auto block = std::make_shared<cppgrad::nn::Sequential>();
+        for (size_t j = i; j < std::min(depth, i + (segment == 0 ? depth : segment)); ++j) {
+            block->push_back(std::make_shared<cppgrad::nn::Linear>(width, width, cppgrad::Activation::Tanh));
+        }
+        blocks.push_back(block);
+    }
+    cppgrad::Tensor x = cppgrad::Tensor::randn({batch, width}, /*requires_grad=*/true);
+
+    size_t peak = 0;
+    for (auto _ : state) {
+        cppgrad::MemoryStepGuard step;
+        cppgrad::Tensor h = x;
+        for (auto& block : blocks) {
+            h = segment == 0
+                ? (*block)(h)
+                : cppgrad::checkpoint([&block](const cppgrad::Tensor& in) { return (*block)(in); }, h);
+        }
+        h.sum().backward();
+        x.grad().eval();
+        af::sync();
+        for (auto& block : blocks) block->zero_grad();
+        x.zero_grad();
+        peak = std::max(peak, cppgrad::memory_stats().step_peak_bytes);
+    }
+    state.counters["peak_MiB"] = static_cast<double>(peak) / (1 << 20);
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+
+BENCHMARK(BM_DeepMlpCheckpoint)
+    ->Args({32, 1024, 512, 0})
+    ->Args({32, 1024, 512, 8})
+    ->Args({32, 1024, 512, 4})
+    ->Args({32, 1024, 512, 1});
@@ -0,0 +1,57 @@
+#include <benchmark/benchmark.h>
+#include "cppgrad/tensor/tensor.hpp"
+#include "cppgrad/ops/conv2d.hpp"
+#include "cppgrad/ops/max_pool2d.hpp"
+
+// Benchmark: forward + backward of a 3×3, padding 1 convolution (a ResNet block layer).
+// Args: batch, channels, spatial size, stride, algorithm (1 = im2col, 2 = direct).
+static void BM_Conv2d(benchmark::State& state) {
+    const size_t N = static_cast<size_t>(state.range(0));
+    const size_t C = static_cast<size_t>(state.range(1));
+    const size_t HW = static_cast<size_t>(state.range(2));
+    cppgrad::Conv2dOptions opts;
+    opts.stride = static_cast<size_t>(state.range(3));
+    opts.padding = 1;
+    opts.algorithm = static_cast<cppgrad::ConvAlgorithm>(state.range(4));
+
+    cppgrad::Tensor x = cppgrad::Tensor::randn({N, C, HW, HW}, /*requires_grad=*/true);
+    cppgrad::Tensor W = cppgrad::Tensor::randn({C, C, 3, 3}, /*requires_grad=*/true);
+    cppgrad::Tensor b = cppgrad::Tensor::zeros({C}, /*requires_grad=*/true);
+
+    const size_t out = (HW - 1) / opts.stride + 1;
+    for (auto _ : state) {
+        conv2d(x, W, b, opts).sum().backward();
+        af::eval(x.grad(), W.grad(), b.grad());
+        af::sync();
+        x.zero_grad();
+        W.zero_grad();
+        b.zero_grad();
+    }
+    // Forward plus the data and filter gradients, 2 FLOPs per multiply-add
+    state.counters["FLOPS"] = benchmark::Counter(
+        6.0 * N * C * C * 9 * out * out, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+BENCHMARK(BM_Conv2d)
+    ->Args({32, 64, 56, 1, 1})
+    ->Args({32, 64, 56, 1, 2})
+    ->Args({32, 128, 28, 2, 1})
+    ->Args({32, 128, 28, 2, 2})
+    ->Args({32, 256, 14, 1, 1})
+    ->Args({32, 256, 14, 1, 2});
+
+// Benchmark: forward + backward of 3×3 stride 2 max pooling (the ResNet stem).
+static void BM_MaxPool2d(benchmark::State& state) {
+    const size_t N = static_cast<size_t>(state.range(0));
+    const size_t HW = static_cast<size_t>(state.range(1));
+    cppgrad::Tensor x = cppgrad::Tensor::randn({N, 64, HW, HW}, /*requires_grad=*/true);
+
+    for (auto _ : state) {
+        max_pool2d(x, 3, 2, 1).sum().backward();
+        af::eval(x.grad());
+        af::sync();
+        x.zero_grad();
+    }
+}
+
+BENCHMARK(BM_MaxPool2d)->Args({32, 112});
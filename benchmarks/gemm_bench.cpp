@@ -0,0 +1,59 @@
+#include <benchmark/benchmark.h>
+#include "cppgrad/tensor/tensor.hpp"
+#include "cppgrad/tensor/tensorutils.hpp"
+#include "cppgrad/ops/linear.hpp"
+
+// Benchmark: forward + backward of one MLP layer, relu(x @ Wᵀ + b).
+// Args: batch, in, out, fused (0 = matmul / + / relu nodes, 1 = linear()).
+static void BM_LinearLayer(benchmark::State& state) {
+    const size_t batch = static_cast<size_t>(state.range(0));
+    const size_t in = static_cast<size_t>(state.range(1));
+    const size_t out = static_cast<size_t>(state.range(2));
+    const bool fused = state.range(3) != 0;
+
+    cppgrad::Tensor x = cppgrad::Tensor::randn({batch, in}, /*requires_grad=*/false);
+    cppgrad::Tensor W = cppgrad::Tensor::randn({out, in}, /*requires_grad=*/true);
+    cppgrad::Tensor b = cppgrad::Tensor::zeros({out}, /*requires_grad=*/true);
+
+    for (auto _ : state) {
+        cppgrad::Tensor y = fused
+            ? linear(x, W, b, cppgrad::Activation::Relu)
+            : relu(cppgrad::TensorUtils::matmul(x, W.transpose()) + b);
+        y.sum().backward();
+        af::eval(W.grad(), b.grad());
+        af::sync();
+        W.zero_grad();
+        b.zero_grad();
+    }
+    // Forward GEMM plus the two backward GEMMs
+    state.counters["FLOPS"] = benchmark::Counter(
+        6.0 * batch * in * out, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+BENCHMARK(BM_LinearLayer)
+    ->Args({64, 784, 256, 0})
+    ->Args({64, 784, 256, 1})
+    ->Args({256, 1024, 1024, 0})
+    ->Args({256, 1024, 1024, 1});
+
+// Benchmark: forward + backward of a batched matmul, (B, N, N) @ (B, N, N).
+static void BM_BatchedMatmul(benchmark::State& state) {
+    const size_t B = static_cast<size_t>(state.range(0));
+    const size_t N = static_cast<size_t>(state.range(1));
+    cppgrad::Tensor a = cppgrad::Tensor::randn({B, N, N}, /*requires_grad=*/true);
+    cppgrad::Tensor c = cppgrad::Tensor::randn({B, N, N}, /*requires_grad=*/true);
+
+    for (auto _ : state) {
+        cppgrad::TensorUtils::matmul(a, c).sum().backward();
+        af::eval(a.grad(), c.grad());
+        af::sync();
+        a.zero_grad();
+        c.zero_grad();
+    }
+    state.counters["FLOPS"] = benchmark::Counter(
+        6.0 * B * N * N * N, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+BENCHMARK(BM_BatchedMatmul)
+    ->Args({16, 64})
+    ->Args({8, 256});
@@ -0,0 +1,45 @@
+#include <benchmark/benchmark.h>
+#include "cppgrad/tensor/tensor.hpp"
+#include "cppgrad/lazy/lazymode.hpp"
+
+// Benchmark: forward + backward of an elementwise-heavy loss (a GELU-style
+// tanh approximation written with primitive ops), eager vs LazyMode.
+// Args: rows, cols, lazy (0 = eager, 1 = LazyMode).
+static void BM_ElementwiseLoss(benchmark::State& state) {
+    const size_t rows = static_cast<size_t>(state.range(0));
+    const size_t cols = static_cast<size_t>(state.range(1));
+    const bool lazy = state.range(2) != 0;
+
+    cppgrad::Tensor x = cppgrad::Tensor::randn({rows, cols}, true);
+    cppgrad::Tensor scale = cppgrad::Tensor::randn({cols}, true);
+
+    auto loss_fn = [&] {
+        cppgrad::Tensor u = x * scale;
+        cppgrad::Tensor inner = (u + pow(u, 3.0f) * cppgrad::Tensor::full({rows, cols}, 0.044715f)) * 0.7978845608f;
+        cppgrad::Tensor y = u * 0.5f * (tanh(inner) + 1.0f);
+        return (y * y).mean();
+    };
+
+    for (auto _ : state) {
+        x.zero_grad();
+        scale.zero_grad();
+        if (lazy) {
+            cppgrad::Tensor loss = [&] {
+                cppgrad::LazyMode mode;
+                return loss_fn();
+            }();
+            loss.backward();
+        } else {
+            loss_fn().backward();
+        }
+        af::sync();
+    }
+    state.counters["evals"] = static_cast<double>(cppgrad::LazyMode::stats().evals);
+    state.SetItemsProcessed(state.iterations() * rows * cols);
+}
+
+BENCHMARK(BM_ElementwiseLoss)
+    ->Args({256, 256, 0})
+    ->Args({256, 256, 1})
+    ->Args({2048, 2048, 0})
+    ->Args({2048, 2048, 1});
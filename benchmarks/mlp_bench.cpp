@@ -0,0 +1,76 @@
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <vector>
+#include "cppgrad/tensor/tensor.hpp"
+#include "cppgrad/ops/cross_entropy.hpp"
+#include "cppgrad/nn/dropout.hpp"
+#include "cppgrad/nn/linear.hpp"
+#include "cppgrad/nn/sequential.hpp"
+#include "cppgrad/optim/adam.hpp"
+
+namespace {
+
+    // 784 -> hidden -> hidden -> 10 classifier on MNIST-shaped inputs
+    std::shared_ptr<cppgrad::nn::Sequential> make_mlp(size_t hidden) {
+        using cppgrad::Activation;
+        namespace nn = cppgrad::nn;
+        return std::make_shared<nn::Sequential>(std::vector<std::shared_ptr<nn::Module>>{
+            std::make_shared<nn::Linear>(784, hidden, Activation::Relu),
+            std::make_shared<nn::Dropout>(0.1f),
+            std::make_shared<nn::Linear>(hidden, hidden, Activation::Relu),
+            std::make_shared<nn::Linear>(hidden, 10),
+        });
+    }
+
+    std::vector<int> make_labels(size_t batch) {
+        std::vector<int> labels(batch);
+        for (size_t i = 0; i < batch; ++i) labels[i] = static_cast<int>(i % 10);
+        return labels;
+    }
+
+}
+
+// Benchmark: one training step (forward, cross-entropy, backward, Adam) of an MLP.
+// Args: batch size, hidden width.
+static void BM_MlpTrainStep(benchmark::State& state) {
+    const size_t batch = static_cast<size_t>(state.range(0));
+    const size_t hidden = static_cast<size_t>(state.range(1));
+
+    auto mlp = make_mlp(hidden);
+    cppgrad::optim::Adam opt(mlp->parameters());
+    cppgrad::Tensor x = cppgrad::Tensor::randn({batch, 784});
+    const std::vector<int> labels = make_labels(batch);
+
+    for (auto _ : state) {
+        opt.zero_grad();
+        cross_entropy((*mlp)(x), labels).backward();
+        opt.step();
+        af::sync();
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+
+BENCHMARK(BM_MlpTrainStep)
+    ->Args({64, 256})
+    ->Args({256, 1024});
+
+// Benchmark: eval-mode forward of the same MLP (no graph recorded).
+static void BM_MlpInference(benchmark::State& state) {
+    const size_t batch = static_cast<size_t>(state.range(0));
+    const size_t hidden = static_cast<size_t>(state.range(1));
+
+    auto mlp = make_mlp(hidden);
+    mlp->eval();
+    cppgrad::Tensor x = cppgrad::Tensor::randn({batch, 784});
+
+    for (auto _ : state) {
+        cppgrad::Tensor logits = (*mlp)(x);
+        logits.data().eval();
+        af::sync();
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+
+BENCHMARK(BM_MlpInference)
+    ->Args({64, 256})
+    ->Args({256, 1024});
@@ -0,0 +1,59 @@
+#include <benchmark/benchmark.h>
+#include "cppgrad/tensor/tensor.hpp"
+#include "cppgrad/ops/batch_norm.hpp"
+#include "cppgrad/ops/layer_norm.hpp"
+
+// Benchmark: forward + backward of layer norm over the hidden axis of a
+// (tokens, hidden) activation.
+// Args: tokens, hidden, fused (0 = mean / var / pow / * / + nodes, 1 = layer_norm()).
+static void BM_LayerNorm(benchmark::State& state) {
+    const size_t tokens = static_cast<size_t>(state.range(0));
+    const size_t hidden = static_cast<size_t>(state.range(1));
+    const bool fused = state.range(2) != 0;
+
+    cppgrad::Tensor x = cppgrad::Tensor::randn({tokens, hidden}, /*requires_grad=*/true);
+    cppgrad::Tensor w = cppgrad::Tensor::ones({hidden}, /*requires_grad=*/true);
+    cppgrad::Tensor b = cppgrad::Tensor::zeros({hidden}, /*requires_grad=*/true);
+
+    for (auto _ : state) {
+        cppgrad::Tensor y = fused
+            ? layer_norm(x, {hidden}, w, b)
+            : (x - x.mean(1, true)) * pow(x.var(1, false, true) + 1e-5f, -0.5f) * w + b;
+        y.sum().backward();
+        af::eval(x.grad(), w.grad(), b.grad());
+        af::sync();
+        x.zero_grad();
+        w.zero_grad();
+        b.zero_grad();
+    }
+    state.SetItemsProcessed(state.iterations() * tokens * hidden);
+}
+
+BENCHMARK(BM_LayerNorm)
+    ->Args({4096, 768, 0})
+    ->Args({4096, 768, 1});
+
+// Benchmark: forward + backward of training-mode batch norm on an NCHW activation.
+static void BM_BatchNorm2d(benchmark::State& state) {
+    const size_t N = static_cast<size_t>(state.range(0));
+    const size_t C = static_cast<size_t>(state.range(1));
+    const size_t HW = static_cast<size_t>(state.range(2));
+
+    cppgrad::Tensor x = cppgrad::Tensor::randn({N, C, HW, HW}, /*requires_grad=*/true);
+    cppgrad::Tensor gamma = cppgrad::Tensor::ones({C}, /*requires_grad=*/true);
+    cppgrad::Tensor beta = cppgrad::Tensor::zeros({C}, /*requires_grad=*/true);
+    cppgrad::Tensor running_mean = cppgrad::Tensor::zeros({C});
+    cppgrad::Tensor running_var = cppgrad::Tensor::ones({C});
+
+    for (auto _ : state) {
+        batch_norm(x, running_mean, running_var, gamma, beta).sum().backward();
+        af::eval(x.grad(), gamma.grad(), beta.grad());
+        af::sync();
+        x.zero_grad();
+        gamma.zero_grad();
+        beta.zero_grad();
+    }
+    state.SetItemsProcessed(state.iterations() * N * C * HW * HW);
+}
+
+BENCHMARK(BM_BatchNorm2d)->Args({32, 64, 56});
@@ -0,0 +1,93 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "cppgrad/tensor/tensor.hpp"
+#include "cppgrad/optim/adam.hpp"
+
+// Benchmark: one Adam step over many small parameters (a deep MLP's weights
+// and biases).
+// Args: parameter count, elements per parameter,
+//       fused (0 = one evaluation per parameter, 1 = optim::Adam over flat buffers).
+static void BM_AdamStep(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    const size_t size = static_cast<size_t>(state.range(1));
+    const bool fused = state.range(2) != 0;
+
+    std::vector<cppgrad::Tensor> params;
+    for (size_t i = 0; i < count; ++i) {
+        params.push_back(cppgrad::Tensor::randn({size}, /*requires_grad=*/true));
+        (params.back() * params.back()).sum().backward();
+    }
+    cppgrad::optim::Adam adam(params);
+
+    // Per-parameter baseline state
+    std::vector<af::array> p, g, m, v;
+    for (const auto& t : params) {
+        p.push_back(t.data().copy());
+        g.push_back(t.grad());
+        m.push_back(af::constant(0, static_cast<dim_t>(size)));
+        v.push_back(af::constant(0, static_cast<dim_t>(size)));
+    }
+
+    int t = 0;
+    for (auto _ : state) {
+        if (fused) {
+            adam.step();
+        } else {
+            ++t;
+            const float bias1 = 1.0f - std::pow(0.9f, static_cast<float>(t));
+            const float bias2_sqrt = std::sqrt(1.0f - std::pow(0.999f, static_cast<float>(t)));
+            for (size_t i = 0; i < count; ++i) {
+                m[i] = 0.9f * m[i] + 0.1f * g[i];
+                v[i] = 0.999f * v[i] + 0.001f * g[i] * g[i];
+                p[i] = p[i] - (1e-3f / bias1) * m[i] / (af::sqrt(v[i]) / bias2_sqrt + 1e-8f);
+                af::eval(m[i], v[i], p[i]);
+            }
+        }
+        af::sync();
+    }
+    state.SetItemsProcessed(state.iterations() * count * size);
+}
+
+BENCHMARK(BM_AdamStep)
+    ->Args({200, 4096, 0})
+    ->Args({200, 4096, 1})
+    ->Args({20, 1 << 20, 0})
+    ->Args({20, 1 << 20, 1});
+
+// Benchmark: the per-step gradient copy of the fused optimizers on its own
+// (every gradient joined into one flat buffer, as Optimizer::step does), to
+// compare against BM_AdamStep with the same arguments.
+// Args: parameter count, elements per parameter.
+static void BM_OptimGather(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    const size_t size = static_cast<size_t>(state.range(1));
+
+    std::vector<af::array> grads;
+    for (size_t i = 0; i < count; ++i) grads.push_back(af::randn(static_cast<dim_t>(size)));
+
+    for (auto _ : state) {
+        // Batches of 10 inputs per af_join_many, like the optimizer
+        std::vector<af::array> parts = grads;
+        while (parts.size() > 1) {
+            std::vector<af::array> joined;
+            for (size_t i = 0; i < parts.size(); i += 10) {
+                const size_t n = std::min<size_t>(10, parts.size() - i);
+                std::vector<af_array> handles;
+                for (size_t k = 0; k < n; ++k) handles.push_back(parts[i + k].get());
+                af_array out = nullptr;
+                af_join_many(&out, 0, static_cast<unsigned>(n), handles.data());
+                joined.emplace_back(out);
+            }
+            parts = std::move(joined);
+        }
+        parts.front().eval();
+        af::sync();
+    }
+    state.SetBytesProcessed(state.iterations() * count * size * sizeof(float));
+}
+
+BENCHMARK(BM_OptimGather)
+    ->Args({200, 4096})
+    ->Args({20, 1 << 20});
@@ -0,0 +1,40 @@
+#include <benchmark/benchmark.h>
+#include "cppgrad/tensor/tensor.hpp"
+
+// Benchmark: forward + backward of a row-wise max; backward scatters one
+// gradient per row to the saved argmax.
+// Args: rows, cols.
+static void BM_MaxBackward(benchmark::State& state) {
+    const size_t rows = static_cast<size_t>(state.range(0));
+    const size_t cols = static_cast<size_t>(state.range(1));
+    cppgrad::Tensor x = cppgrad::Tensor::randn({rows, cols}, /*requires_grad=*/true);
+
+    for (auto _ : state) {
+        x.max(1).sum().backward();
+        af::eval(x.grad());
+        af::sync();
+        x.zero_grad();
+    }
+    state.SetItemsProcessed(state.iterations() * rows * cols);
+}
+
+BENCHMARK(BM_MaxBackward)->Args({4096, 1024})->Args({64, 65536});
+
+// Benchmark: forward + backward of per-channel variance over (N, H, W) of an
+// NCHW activation, the batch-norm statistics pattern.
+static void BM_VarOverAxes(benchmark::State& state) {
+    const size_t N = static_cast<size_t>(state.range(0));
+    const size_t C = static_cast<size_t>(state.range(1));
+    const size_t HW = static_cast<size_t>(state.range(2));
+    cppgrad::Tensor x = cppgrad::Tensor::randn({N, C, HW, HW}, /*requires_grad=*/true);
+
+    for (auto _ : state) {
+        x.var({0, 2, 3}, /*unbiased=*/false).sum().backward();
+        af::eval(x.grad());
+        af::sync();
+        x.zero_grad();
+    }
+    state.SetItemsProcessed(state.iterations() * N * C * HW * HW);
+}
+
+BENCHMARK(BM_VarOverAxes)->Args({32, 64, 56});
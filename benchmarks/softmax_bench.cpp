@@ -0,0 +1,37 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "cppgrad/tensor/tensor.hpp"
+#include "cppgrad/ops/cross_entropy.hpp"
+
+// Forward + backward of a classification loss on (batch × classes) logits.
+// Arg 2 = 0 composes it from exp / sum / log and a one-hot mask,
+// 1 uses the fused cross_entropy with integer labels.
+static void BM_CrossEntropy(benchmark::State& state) {
+    const size_t batch = static_cast<size_t>(state.range(0));
+    const size_t classes = static_cast<size_t>(state.range(1));
+    const bool fused = state.range(2) != 0;
+
+    cppgrad::Tensor logits = cppgrad::Tensor::randn({batch, classes}, /*requires_grad=*/true);
+    std::vector<int> labels(batch);
+    std::vector<float> onehot(batch * classes, 0.0f);
+    for (size_t i = 0; i < batch; ++i) {
+        labels[i] = static_cast<int>(i % classes);
+        onehot[i * classes + labels[i]] = -1.0f / static_cast<float>(batch);
+    }
+    cppgrad::Tensor mask({batch, classes}, onehot, /*requires_grad=*/false);
+
+    for (auto _ : state) {
+        cppgrad::Tensor loss = fused
+            ? cross_entropy(logits, labels)
+            : (log(exp(logits) / exp(logits).sum(1, true)) * mask).sum();
+        loss.backward();
+        af::eval(logits.grad());
+        af::sync();
+        logits.zero_grad();
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+
+BENCHMARK(BM_CrossEntropy)
+    ->Args({256, 1000, 0})
+    ->Args({256, 1000, 1});
@@ -1,5 +1,6 @@
 #include <benchmark/benchmark.h>
 #include "cppgrad/tensor/tensor.hpp"
+#include "cppgrad/tensor/tensorutils.hpp"
 
 // Benchmark: Elementwise addition of two N×N tensors
 static void BM_TensorAdd(benchmark::State& state) {
@@ -25,4 +26,115 @@ BENCHMARK(BM_TensorAdd)
     ->Arg(2000)
     ->Complexity();
 
+// Benchmark: tensor-scalar expression x * 0.5f + 1.0f (forward + backward).
+// Scalars are passed to ArrayFire directly, so no N×N constant is allocated.
+static void BM_TensorScalarOps(benchmark::State& state) {
+    std::vector<unsigned long>::size_type N = state.range(0);
+    cppgrad::Tensor x = cppgrad::Tensor::randn({N, N}, /*requires_grad=*/true);
+
+    for (auto _ : state) {
+        auto y = x * 0.5f + 1.0f;
+        y.backward();
+        af::array g = x.grad();
+        af::eval(g);
+        af::sync();
+        x.zero_grad();
+    }
+    state.SetComplexityN(N);
+}
+
+BENCHMARK(BM_TensorScalarOps)
+    ->Arg(1024)
+    ->Arg(4096)
+    ->Complexity();
+
+// Benchmark: aᵀ·b with the transpose copied first (arg1 = 0) versus left as
+// a view that matmul hands to the GEMM as AF_MAT_TRANS (arg1 = 1).
+static void BM_TransposeMatmul(benchmark::State& state) {
+    std::vector<unsigned long>::size_type N = state.range(0);
+    const bool lazy = state.range(1) != 0;
+    cppgrad::Tensor a = cppgrad::Tensor::randn({N, N}, /*requires_grad=*/false);
+    cppgrad::Tensor b = cppgrad::Tensor::randn({N, N}, /*requires_grad=*/false);
+
+    for (auto _ : state) {
+        auto at = lazy ? a.transpose() : a.transpose().reshape({N, N});
+        auto c = cppgrad::TensorUtils::matmul(at, b);
+        af::eval(c.data());
+        af::sync();
+    }
+    state.SetComplexityN(N);
+}
+
+BENCHMARK(BM_TransposeMatmul)
+    ->Args({1024, 0})
+    ->Args({1024, 1})
+    ->Args({2048, 0})
+    ->Args({2048, 1});
+
+// Benchmark: host-side dispatch cost of a short op chain on 2×2 tensors.
+// The data is never evaluated, so this measures shape handling, broadcasting
+// checks and graph recording rather than ArrayFire kernels.
+static void BM_TinyOpDispatch(benchmark::State& state) {
+    const bool requires_grad = state.range(0) != 0;
+    cppgrad::Tensor a = cppgrad::Tensor::randn({2, 2}, requires_grad);
+    cppgrad::Tensor b = cppgrad::Tensor::randn({2, 2}, requires_grad);
+
+    for (auto _ : state) {
+        auto c = (a + b) * a - b / 2.0f;
+        benchmark::DoNotOptimize(c.shape().size());
+    }
+    state.SetItemsProcessed(state.iterations() * 4);
+}
+
+BENCHMARK(BM_TinyOpDispatch)
+    ->Arg(0)
+    ->Arg(1);
+
+// Benchmark: ingest a row-major host buffer and multiply it.
+// Arg 1 = 0 forces the reorder up front (contiguous copy), 1 keeps the
+// reversed-axis view and lets matmul consume it as a transposed operand.
+static void BM_RowMajorIngestMatmul(benchmark::State& state) {
+    std::vector<unsigned long>::size_type N = state.range(0);
+    const bool lazy = state.range(1) != 0;
+    std::vector<float> host(N * N, 0.5f);
+    cppgrad::Tensor b = cppgrad::Tensor::randn({N, N}, /*requires_grad=*/false);
+
+    for (auto _ : state) {
+        auto a = cppgrad::Tensor::from_blob(std::span<const float>(host), {N, N});
+        if (!lazy) af::eval(a.data());
+        auto c = cppgrad::TensorUtils::matmul(a, b);
+        af::eval(c.data());
+        af::sync();
+    }
+    state.SetBytesProcessed(state.iterations() * N * N * sizeof(float));
+}
+
+BENCHMARK(BM_RowMajorIngestMatmul)
+    ->Args({1024, 0})
+    ->Args({1024, 1});
+
+// Benchmark: SGD-style parameter update, w -= lr * g.
+// Arg 1 = 0 rebinds w to a freshly allocated result, 1 updates it in place.
+static void BM_ParameterUpdate(benchmark::State& state) {
+    std::vector<unsigned long>::size_type N = state.range(0);
+    const bool inplace = state.range(1) != 0;
+    cppgrad::Tensor w = cppgrad::Tensor::randn({N, N}, /*requires_grad=*/false);
+    cppgrad::Tensor g = cppgrad::Tensor::randn({N, N}, /*requires_grad=*/false);
+
+    for (auto _ : state) {
+        if (inplace) {
+            w.sub_(g * 0.01f);
+        } else {
+            w = w - g * 0.01f;
+        }
+        af::eval(w.data());
+        af::sync();
+    }
+    state.SetBytesProcessed(state.iterations() * N * N * sizeof(float));
+}
+
+BENCHMARK(BM_ParameterUpdate)
+    ->Args({1024, 0})
+    ->Args({1024, 1});
+
 BENCHMARK_MAIN();
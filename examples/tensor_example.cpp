@@ -74,6 +74,8 @@ int main() {
         Tensor d = Tensor::full({2,2}, 2.0, true);
         Tensor c = a * b;
         Tensor e = c + d;
+        c.retain_grad();  // intermediates only keep grads on request
+        e.retain_grad();
         e.backward();
         printGrads(a, b, d, c, e);
         // Expected:
@@ -176,8 +178,8 @@ int main() {
         Tensor a = Tensor::full({}, 2.0, true);
         Tensor b = Tensor::full({}, 2.0, true);
         Tensor c = a * b;
-        c.backward();
-        c.backward();  // debug-only warning
+        c.backward(af::array(), /*retain_graph=*/true);
+        c.backward();  // debug-only warning; would throw without retain_graph
     }
 
     // 16. Separate backward on components
@@ -220,6 +222,7 @@ int main() {
     {
         Tensor a = Tensor::full({2,2}, 3.0f, true);
         Tensor b = TensorUtils::clone_with_grad(a);
+        b.retain_grad();
         Tensor c = b * 2.0f;
         c.backward();
         printGrads(a, b);
@@ -283,7 +286,7 @@ int main() {
         auto expp     = exp(-a);
         auto powp     = pow(b, a);
         auto out      = logp + expp + powp;
-        out.backward();
+        out.backward(af::array(), /*retain_graph=*/true);  // keep graph for the visualizer
         printGrads(a, b);
         // Expected a.grad ≈ 6.362, b.grad ≈ 10.7
 
@@ -427,7 +430,7 @@ int main() {
 
         Tensor t({2,3}, {1,2,3,4,5,6});
         auto s_dim0 = t.sum(0);
-        if (s_dim0.shape() == std::vector<size_t>{2}) {
+        if (s_dim0.shape() == std::vector<size_t>{3}) {
             std::cout << "Shape check passed\n";
         }
     }
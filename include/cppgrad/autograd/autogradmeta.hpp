@@ -15,19 +15,25 @@ class Function;
      * - the accumulated gradient (`grad`),
      * - the backward function (`grad_fn`) that created the tensor,
      * - whether the tensor requires gradients (`requires_grad`),
+     * - whether a non-leaf tensor opted in to keep its gradient (`retains_grad`),
      * - and a flag to track if `.backward()` has already been called on it.
      *
+     * `grad` starts out empty and is only allocated on the first accumulation.
+     * By default gradients are only stored on leaf tensors (no `grad_fn`);
+     * intermediates only pass gradients through unless `retains_grad` is set.
+     *
      * Similar to PyTorch's `AutogradMeta`, it enables construction and traversal
      * of the dynamic computation graph during backward passes.
      */
     class AutogradMeta {
         public:
-            AutogradMeta(bool req, const af::array &data);
+            explicit AutogradMeta(bool req);
 
             af::array grad;
             std::shared_ptr<Function> grad_fn;
             bool requires_grad;
+            bool retains_grad = false;
             bool has_called_backward = false;
     };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <arrayfire.h>
+
+#include "cppgrad/tensor/shape.hpp"
+
+namespace cppgrad {
+
+    /**
+     * @file capture.hpp
+     * @brief Trace-and-replay of a training step whose graph is the same every time.
+     *
+     * Eager execution rebuilds an identical graph each step: per op a
+     * `TensorImpl`, an `AutogradMeta`, a `Function` node and a round of shape
+     * validation. `capture(step)` runs `step` once eagerly while recording a
+     * flat tape: one entry per op, holding its output `TensorImpl` (the
+     * buffer slot), its input slots and a kernel that recomputes the output
+     * and the node's saved arrays with every shape already resolved. The
+     * graph of that first run is kept (backward with `retain_graph`).
+     *
+     * Later calls with inputs of the captured shapes replay the tape:
+     *   1. the new input data is bound to the tape's input slots,
+     *   2. every kernel runs in recorded order, writing into the existing
+     *      output slots and refreshing each node's saved arrays and input
+     *      versions (parameters updated by an optimizer are fine),
+     *   3. backward runs over the retained graph.
+     * No graph object is allocated and no shape is checked again.
+     *
+     * Any call whose input shapes or `requires_grad` flags differ from the
+     * capture runs eagerly instead. A tape that could not be recorded
+     * completely also runs every call eagerly: any tensor created during
+     * capture that no op recorded makes it non-replayable, for example from
+     * factories, views, in-place writes or ops without a kernel. Recorded ops:
+     * elementwise arithmetic (tensor and scalar forms), `neg`, `exp`, `log`,
+     * `pow`, the activations, `linear`, `TensorUtils::matmul`, `softmax`,
+     * `log_softmax`, `sum` / `mean`, `reshape` / `view` and `dropout` (a new
+     * mask per replay).
+     *
+     * Replay semantics follow CUDA graphs:
+     * - Only the tensors passed to the step are rebound. Anything else the
+     *   step reads is frozen at capture time: scalars, host-side arguments
+     *   (e.g. `cross_entropy` labels, which is why it is not recorded), and
+     *   which ops run.
+     * - Outputs live in the tape's slots, so the returned tensor is overwritten
+     *   by the next replay.
+     * - Gradients accumulate exactly as in eager mode: into the parameters the
+     *   step reads, and into the caller's inputs that require grad. An input
+     *   computed by ops outside the step (e.g. `encoder(raw)`) passes its
+     *   gradient on through that graph, which is released afterwards.
+     *
+     * Typical Usage:
+     * ```cpp
+     * auto step = cppgrad::capture([&](const std::vector<Tensor>& in) {
+     *     return pow(model(in[0]) - in[1], 2.0f).mean();
+     * });
+     * for (auto& [x, y] : batches) {
+     *     opt.zero_grad();
+     *     Tensor loss = step({ x, y });   // forward + backward
+     *     opt.step();
+     * }
+     * ```
+     *
+     * Analogy: `torch.cuda.graphs` / `torch.compile(mode="reduce-overhead")`.
+    */
+
+    class Tensor;
+    class TensorImpl;
+
+    /// Flat list of recorded ops.
+    class Tape {
+    public:
+        using Arrays = std::vector<af::array>;
+
+        /// Recomputes one op from its inputs' current data: returns the output
+        /// followed by the arrays its node saves for backward (if any).
+        using Kernel = std::function<Arrays(const Arrays& inputs)>;
+
+        /// True while a `CapturedStep` records on this thread.
+        static bool is_recording();
+
+        /// Append an op producing `out`. Ops call this after building their
+        /// result, guarded by `is_recording()`.
+        static void record(const std::shared_ptr<TensorImpl>& out,
+                           std::vector<std::shared_ptr<TensorImpl>> inputs,
+                           Kernel kernel);
+
+        /// Called for every new `TensorImpl`; one that no op records makes the
+        /// tape non-replayable.
+        static void note_allocation();
+
+        size_t size() const { return entries_.size(); }
+        /// Every tensor created while recording came from a recorded op.
+        bool is_complete() const { return allocations_ == entries_.size(); }
+        /// True if `impl` is the output slot of some entry.
+        bool produces(const TensorImpl* impl) const;
+
+        /// Run every entry in order on the current data of its inputs.
+        void replay();
+
+    private:
+        struct Entry {
+            std::shared_ptr<TensorImpl> output;
+            std::vector<std::shared_ptr<TensorImpl>> inputs;
+            Kernel kernel;
+        };
+
+        std::vector<Entry> entries_;
+        size_t allocations_ = 0;      // TensorImpls created while recording
+        Arrays scratch_;              // Input data of the entry being replayed
+
+        friend class CapturedStep;
+    };
+
+    /// A step (forward returning a scalar loss, then backward) that is
+    /// recorded on its first call and replayed on later ones.
+    class CapturedStep {
+    public:
+        using Step = std::function<Tensor(const std::vector<Tensor>&)>;
+
+        explicit CapturedStep(Step step);
+        ~CapturedStep();
+
+        CapturedStep(CapturedStep&&) noexcept;
+        CapturedStep& operator=(CapturedStep&&) noexcept;
+
+        /// `step(inputs)` followed by its backward; returns the step output.
+        /// Without grad mode only the forward runs, eagerly.
+        Tensor operator()(const std::vector<Tensor>& inputs);
+
+        bool is_captured() const { return tape_ != nullptr; }
+        bool is_replayable() const { return replayable_; }
+        /// Recorded ops (0 before the first call).
+        size_t tape_size() const { return tape_ ? tape_->size() : 0; }
+        size_t replays() const { return replays_; }
+        /// Calls after the capture that ran eagerly.
+        size_t fallbacks() const { return fallbacks_; }
+
+        /// Drop the tape and its graph; the next call captures again.
+        void reset();
+
+    private:
+        Tensor record(const std::vector<Tensor>& inputs);
+        Tensor replay(const std::vector<Tensor>& inputs);
+        Tensor run_eager(const std::vector<Tensor>& inputs);
+        bool matches(const std::vector<Tensor>& inputs) const;
+        /// Move gradients of the tape's input slots to the caller's tensors.
+        void export_grads(const std::vector<Tensor>& inputs);
+
+        Step step_;
+        std::unique_ptr<Tape> tape_;
+        std::vector<std::shared_ptr<TensorImpl>> slots_;   // Leaves the tape reads the inputs from
+        std::vector<Shape> shapes_;
+        std::vector<bool> requires_grad_;
+        std::shared_ptr<TensorImpl> output_;
+        bool replayable_ = false;
+        size_t replays_ = 0;
+        size_t fallbacks_ = 0;
+    };
+
+    CapturedStep capture(CapturedStep::Step step);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+namespace cppgrad {
+
+    /**
+     * @file checkpoint.hpp
+     * @brief Gradient checkpointing: trade recomputation for activation memory.
+     *
+     * `checkpoint(segment, inputs)` runs `segment` with graph recording
+     * disabled, so none of its intermediates are kept alive by `Function`
+     * nodes. The output gets a single `CheckpointFunction` node that holds only
+     * the segment inputs. During backward that node re-runs the segment on
+     * detached copies of the inputs with recording enabled, backpropagates
+     * through the rebuilt local graph and frees it again before the pass moves on.
+     *
+     * Peak memory of a deep network checkpointed every k layers is roughly the
+     * segment boundaries plus one segment's activations, at the cost of one
+     * extra forward per segment.
+     *
+     * Notes:
+     * - Parameters read inside the segment (e.g. a module's weights) need not be
+     *   passed as inputs: they receive their gradients from the inner backward.
+     *   As the forward records nothing, the output requires grad whenever grad
+     *   mode is enabled.
+     * - The ArrayFire RNG is re-seeded before the segment and again before the
+     *   recomputation, so `dropout` masks match between the two runs.
+     * - Inputs modified in place between forward and backward throw, as for any
+     *   other node (see `Function::input_data`).
+     * - With grad mode disabled, `checkpoint` just calls the segment.
+     *
+     * Typical Usage:
+     * ```cpp
+     * Tensor h = x;
+     * for (auto& block : blocks) {
+     *     h = cppgrad::checkpoint([&](const Tensor& in) { return (*block)(in); }, h);
+     * }
+     * loss(h).backward();
+     * ```
+     *
+     * Analogy: `torch.utils.checkpoint.checkpoint`.
+    */
+
+    class Tensor;
+
+    /// A forward segment: maps the checkpoint inputs to one output tensor.
+    using CheckpointSegment = std::function<Tensor(const std::vector<Tensor>&)>;
+
+    Tensor checkpoint(const CheckpointSegment& segment, const std::vector<Tensor>& inputs);
+
+    /// Single-input form (e.g. one block of a sequential model).
+    Tensor checkpoint(const std::function<Tensor(const Tensor&)>& segment, const Tensor& input);
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <arrayfire.h>
+#include <cstddef>
+#include <memory>
+
+namespace cppgrad {
+
+    /**
+     * @file engine.hpp
+     * @brief Graph executor that drives the backward pass.
+     *
+     * `Engine::backward()` walks the autograd graph rooted at a tensor in two phases:
+     *
+     * 1. **Dependency counting** – a breadth-first sweep over `grad_fn` edges records,
+     *    for every `Function`, how many downstream edges will deliver a gradient to it.
+     * 2. **Execution** – starting from the root's `grad_fn`, nodes are popped from an
+     *    explicit ready queue. Each node is applied exactly once with the *sum* of all
+     *    gradients flowing into it, and its results are accumulated into the buffers of
+     *    its producers. A producer becomes ready when its dependency count drops to zero.
+     *    Gradients are only written to `TensorImpl::grad()` for leaves and for
+     *    tensors that called `retain_grad()`; everything else lives in the per-node
+     *    buffers only for as long as it is needed.
+     *
+     * Unless `retain_graph` is set, each node is released as soon as it has run,
+     * dropping its saved inputs so intermediates are freed during the pass rather
+     * than when the output tensor dies. A second backward through a released node
+     * throws.
+     *
+     * Execution is single-threaded and deterministic by default. With
+     * `set_num_threads(n > 1)` ready nodes are dispatched to a pool of worker threads,
+     * so independent branches (e.g. both operands of an `Add`, or the heads of a
+     * multi-head network) are applied concurrently. Gradients are summed in
+     * completion order in that mode, so results may differ in the last bits between
+     * runs; `set_deterministic(true)` forces the serial FIFO order regardless of the
+     * thread count. A backward started from inside a worker always runs inline.
+     *
+     * This processes the graph in reverse topological order, so shared sub-graphs
+     * (e.g. `x*x + x`) are walked once instead of once per consumer, and no recursion
+     * is involved, so arbitrarily deep chains do not grow the C++ stack.
+     *
+     * Analogy: Similar to `torch::autograd::Engine` in PyTorch.
+    */
+
+    class TensorImpl;
+
+    class Engine {
+        public:
+            /// Run backward from `root`, seeding it with `grad_output`
+            /// (ones if empty). Keeps the graph alive if `retain_graph` is true.
+            static void backward(const std::shared_ptr<TensorImpl>& root,
+                                 const af::array& grad_output,
+                                 bool retain_graph = false);
+
+            /// Size of the backward worker pool; 1 runs every pass on the calling thread.
+            static void set_num_threads(size_t num_threads);
+            static size_t num_threads();
+
+            /// Force the single-threaded, reproducible execution order.
+            static void set_deterministic(bool deterministic);
+            static bool is_deterministic();
+    };
+
+}
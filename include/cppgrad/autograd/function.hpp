@@ -1,8 +1,18 @@
 #pragma once
+#include <array>
+#include <cstdint>
+#include <string>
 #include <vector>
 #include <arrayfire.h>
 #include <memory>
 
+#include "cppgrad/autograd/checkpoint.hpp"
+#include "cppgrad/lazy/graph.hpp"
+#include "cppgrad/ops/conv2d.hpp"
+#include "cppgrad/ops/linear.hpp"
+#include "cppgrad/tensor/reduction.hpp"
+#include "cppgrad/tensor/shape.hpp"
+
 namespace cppgrad {
 
     /**
@@ -11,6 +21,8 @@ namespace cppgrad {
      *
      * Each subclass of `Function` represents a specific operation in the computation graph
      * and implements how to backpropagate through it by overriding the `apply()` method.
+     * `apply()` only computes the local gradients for its inputs; traversal of the graph
+     * and accumulation of gradients is handled by the `Engine` (see engine.hpp).
      *
      * This design allows dynamic computation graph construction (define-by-run),
      * similar to PyTorch's autograd system. During the forward pass, a `Function`
@@ -20,15 +32,46 @@ namespace cppgrad {
      * The base `Function` class manages input tensor references and visitation state
      * (to avoid duplicate traversal). Derived classes implement custom gradient logic.
      *
+     * Once a node has been applied during a backward pass that does not retain the
+     * graph, the engine calls `release()`, which drops the input references (and any
+     * state a subclass saved for backward) so intermediates can be freed early.
+     * Applying a released node again is an error.
+     *
      * Categories of supported operations:
      * - Elementwise operations: Add, Sub, Mul, Div
+     * - Tensor-scalar operations: AddScalar, MulScalar, RSubScalar, RDivScalar,
+     *   PowScalar, RPowScalar (the scalar is kept as a float, never materialized)
      * - Unary operations: Neg, Exp, Log, Pow, Clone
-     * - Matrix operations: MatMul
-     * - Reductions: Sum, Mean, Max
+     * - Activations: Relu, Sigmoid, Tanh, Gelu, Silu (one node each; the
+     *   derivative is a single JIT expression over forward-time saved arrays)
+     * - Softmax family: Softmax, LogSoftmax, LogSumExp, CrossEntropy (closed-form
+     *   backward; cross-entropy scatters -1 at the label positions instead of
+     *   building a one-hot tensor)
+     * - Matrix operations: MatMul (batched over leading axes), Linear (GEMM + bias
+     *   + activation in one node)
+     * - Convolution & pooling: Conv2d (im2col + GEMM, or ArrayFire's direct
+     *   kernels), MaxPool2d, AvgPool2d over NCHW tensors
+     * - Normalization: LayerNorm, BatchNorm (one node each, closed-form backward
+     *   from the saved mean / rstd)
+     * - Embedding (scatter-add of the rows by sorted index), Dropout (saved mask)
+     * - Checkpoint: a whole segment recorded as one node that recomputes its
+     *   graph during backward (see checkpoint.hpp)
+     * - Lazy: the result of a lazy region, differentiated symbolically through
+     *   its IR down to the tensors the region read (see lazymode.hpp)
+     * - Reductions: Sum, Mean, Max, Min, Prod, Var, Std over any set of axes
+     *   (Max / Min scatter to the saved argmax instead of re-reducing)
+     *
+     * Inputs are attached with `set_inputs()`, which records each input's version
+     * counter. `apply()` reads input data through `input_data()`, which throws if
+     * the tensor was modified in place since the forward pass (see `Tensor::add_`).
      *
      * Each `Function` subclass is expected to:
      *   - Store any info needed for backward computation (e.g., input shape, dim).
-     *   - Implement `apply()` for computing gradients.
+     *     Arrays computed in forward that backward can reuse (an op's output, a
+     *     reciprocal, an argmax mask, ...) go through `save_for_backward()` rather
+     *     than being recomputed in `apply()`.
+     *   - Implement `apply()` returning one gradient per entry of `inputs`
+     *     (an empty `af::array` for inputs that do not require grad).
      *   - Provide a `name()` for graph visualization/debugging.
     */
 
@@ -43,8 +86,16 @@ namespace cppgrad {
         /// Pointers to input tensors used in the forward pass.
         std::vector<std::shared_ptr<TensorImpl>> inputs;
 
+        /// Attach the forward inputs and record their current versions.
+        void set_inputs(std::vector<std::shared_ptr<TensorImpl>> tensors);
+
+        /// Re-record the inputs' current versions, e.g. when a captured step is
+        /// replayed after the optimizer updated the parameters (see capture.hpp).
+        void refresh_versions();
+
         /// Compute gradient w.r.t. inputs, given gradient of the output.
-        virtual void apply(const af::array& grad_output) = 0;
+        /// Returns one entry per input; must not recurse into upstream nodes.
+        virtual std::vector<af::array> apply(const af::array& grad_output) = 0;
 
         /// Human-readable name of the function (used for graph display/debug).
         virtual std::string name() const = 0;
@@ -53,130 +104,521 @@ namespace cppgrad {
         void mark_visited() { visited_ = true; }
         bool is_visited() const { return visited_; }
 
+        /// Stash forward-time arrays for reuse in `apply()`. They are evaluated
+        /// here so backward reads materialized buffers instead of replaying
+        /// their JIT trees.
+        void save_for_backward(std::vector<af::array> arrays);
+        const std::vector<af::array>& saved_tensors() const { return saved_; }
+
+        /// Free inputs and saved state after backward; subclasses holding extra
+        /// buffers override this and chain to the base implementation.
+        virtual void release();
+        bool is_released() const { return released_; }
+
+    protected:
+        /// Data of input `i` as seen in forward; throws if the tensor has been
+        /// modified in place since.
+        const af::array& input_data(size_t i) const;
+        /// Same check, returning the input itself (e.g. to inspect a pending view).
+        const TensorImpl& checked_input(size_t i) const;
+
     private:
+        std::vector<uint64_t> input_versions_;
+        std::vector<af::array> saved_;
         bool visited_ = false;
+        bool released_ = false;
     };
 
     // --- Elementwise Operations ---
 
     class AddFunction : public Function {
-        void apply(const af::array& grad_output) override;
+        std::vector<af::array> apply(const af::array& grad_output) override;
         std::string name() const override;
     };
 
     class SubFunction : public Function {
-        void apply(const af::array& grad_output) override;
+        std::vector<af::array> apply(const af::array& grad_output) override;
         std::string name() const override;
     };
 
     class MulFunction : public Function {
-        void apply(const af::array& grad_output) override;
+        std::vector<af::array> apply(const af::array& grad_output) override;
         std::string name() const override;
     };
 
+    /// Saves `1 / b` and the output: `saved_tensors() = { 1/b, a/b }`.
     class DivFunction : public Function {
-        void apply(const af::array& grad_output) override;
+        std::vector<af::array> apply(const af::array& grad_output) override;
+        std::string name() const override;
+    };
+
+    // --- Tensor-Scalar Operations ---
+
+    /// x + s (also x - s, stored as x + (-s)).
+    class AddScalarFunction : public Function {
+        std::vector<af::array> apply(const af::array& grad_output) override;
+        std::string name() const override;
+    };
+
+    /// x * s (also x / s, stored as x * (1/s)).
+    class MulScalarFunction : public Function {
+        std::vector<af::array> apply(const af::array& grad_output) override;
+        std::string name() const override;
+
+    public:
+        explicit MulScalarFunction(float scalar);
+
+    private:
+        float scalar_;
+    };
+
+    /// s - x.
+    class RSubScalarFunction : public Function {
+        std::vector<af::array> apply(const af::array& grad_output) override;
+        std::string name() const override;
+    };
+
+    /// s / x. Saves the output `s / x`.
+    class RDivScalarFunction : public Function {
+        std::vector<af::array> apply(const af::array& grad_output) override;
+        std::string name() const override;
+
+    public:
+        explicit RDivScalarFunction(float scalar);
+
+    private:
+        float scalar_;
+    };
+
+    /// x ^ s.
+    class PowScalarFunction : public Function {
+        std::vector<af::array> apply(const af::array& grad_output) override;
         std::string name() const override;
+
+    public:
+        explicit PowScalarFunction(float exponent);
+
+    private:
+        float exponent_;
+    };
+
+    /// s ^ x. Saves the output `s ^ x`.
+    class RPowScalarFunction : public Function {
+        std::vector<af::array> apply(const af::array& grad_output) override;
+        std::string name() const override;
+
+    public:
+        explicit RPowScalarFunction(float base);
+
+    private:
+        float base_;
     };
 
     // --- Unary Operations ---
 
     class CloneFunction : public Function {
-        void apply(const af::array& grad_output) override;
+        std::vector<af::array> apply(const af::array& grad_output) override;
         std::string name() const override;
     };
 
     class NegFunction : public Function {
-        void apply(const af::array& grad_output) override;
+        std::vector<af::array> apply(const af::array& grad_output) override;
         std::string name() const override;
     };
 
+    /// Saves the output `exp(a)`.
     class ExpFunction : public Function {
-        void apply(const af::array& grad_output) override;
+        std::vector<af::array> apply(const af::array& grad_output) override;
         std::string name() const override;
     };
 
     class LogFunction : public Function {
-        void apply(const af::array& grad_output) override;
+        std::vector<af::array> apply(const af::array& grad_output) override;
         std::string name() const override;
     };
 
+    /// Saves the output `base ^ exponent`.
     class PowFunction : public Function {
-        void apply(const af::array& grad_output) override;
+        std::vector<af::array> apply(const af::array& grad_output) override;
         std::string name() const override;
     };
 
+    // --- Activations ---
+
+    /// Saves the output `max(a, 0)`.
+    class ReluFunction : public Function {
+        std::vector<af::array> apply(const af::array& grad_output) override;
+        std::string name() const override;
+    };
+
+    /// Saves the output `sigmoid(a)`.
+    class SigmoidFunction : public Function {
+        std::vector<af::array> apply(const af::array& grad_output) override;
+        std::string name() const override;
+    };
+
+    /// Saves the output `tanh(a)`.
+    class TanhFunction : public Function {
+        std::vector<af::array> apply(const af::array& grad_output) override;
+        std::string name() const override;
+    };
+
+    /// Saves `Φ(a)`; backward also reads the input.
+    class GeluFunction : public Function {
+        std::vector<af::array> apply(const af::array& grad_output) override;
+        std::string name() const override;
+    };
+
+    /// Saves `sigmoid(a)` and the output `a * sigmoid(a)`.
+    class SiluFunction : public Function {
+        std::vector<af::array> apply(const af::array& grad_output) override;
+        std::string name() const override;
+    };
+
+    // --- Softmax and Losses ---
+
+    /// Saves the output probabilities y; dx = y * (g - sum(g * y, dim)).
+    class SoftmaxFunction : public Function {
+        std::vector<af::array> apply(const af::array& grad_output) override;
+        std::string name() const override;
+
+    public:
+        SoftmaxFunction(const Shape& input_shape, int dim);
+
+    private:
+        Shape input_shape_;
+        int dim_;
+    };
+
+    /// Saves the output; dx = g - exp(output) * sum(g, dim).
+    class LogSoftmaxFunction : public Function {
+        std::vector<af::array> apply(const af::array& grad_output) override;
+        std::string name() const override;
+
+    public:
+        LogSoftmaxFunction(const Shape& input_shape, int dim);
+
+    private:
+        Shape input_shape_;
+        int dim_;
+    };
+
+    /// Saves the (before, 1, after) result; dx = g * exp(a - logsumexp(a)).
+    class LogSumExpFunction : public Function {
+        std::vector<af::array> apply(const af::array& grad_output) override;
+        std::string name() const override;
+
+    public:
+        explicit LogSumExpFunction(const Reduction& reduction);
+
+    private:
+        Reduction reduction_;
+    };
+
+    /// Saves the flat softmax probabilities and the flat target indices.
+    class CrossEntropyFunction : public Function {
+        std::vector<af::array> apply(const af::array& grad_output) override;
+        std::string name() const override;
+
+    public:
+        explicit CrossEntropyFunction(size_t count);
+
+    private:
+        size_t count_;       // Number of labels the loss is averaged over
+    };
+
     // --- Matrix Operations ---
 
+    /// Leading axes are batch axes (see gemm.hpp). Backward uses GEMM transpose
+    /// flags instead of `af::transpose`.
     class MatMulFunction : public Function {
-        void apply(const af::array& grad_output) override;
+        std::vector<af::array> apply(const af::array& grad_output) override;
+        std::string name() const override;
+    };
+
+    /// act(x @ Wᵀ + b). Inputs are { x, W } or { x, W, b }; with an activation the
+    /// output is saved and its derivative applied before the three GEMM-shaped
+    /// gradients (all computed with transpose flags).
+    class LinearFunction : public Function {
+        std::vector<af::array> apply(const af::array& grad_output) override;
+        std::string name() const override;
+
+    public:
+        explicit LinearFunction(Activation activation);
+
+    private:
+        Activation activation_;
+    };
+
+    // --- Convolution & Pooling ---
+
+    /// 2D convolution; `options.algorithm` is already resolved (never Auto).
+    /// Im2col saves one column matrix per group; Direct saves the un-biased
+    /// output in image layout, which ArrayFire's gradient kernels take.
+    class Conv2dFunction : public Function {
+        std::vector<af::array> apply(const af::array& grad_output) override;
         std::string name() const override;
+
+    public:
+        explicit Conv2dFunction(const Conv2dOptions& options);
+
+    private:
+        Conv2dOptions options_;
+    };
+
+    /// Saves the argmax of each window (row of the unwrapped, -inf padded image);
+    /// backward routes each output gradient to that position.
+    class MaxPool2dFunction : public Function {
+        std::vector<af::array> apply(const af::array& grad_output) override;
+        std::string name() const override;
+
+    public:
+        MaxPool2dFunction(const Shape& input_shape, size_t kernel, size_t stride, size_t padding);
+
+    private:
+        Shape input_shape_;
+        size_t kernel_, stride_, padding_;
+    };
+
+    /// Backward spreads each output gradient evenly over its window.
+    class AvgPool2dFunction : public Function {
+        std::vector<af::array> apply(const af::array& grad_output) override;
+        std::string name() const override;
+
+    public:
+        AvgPool2dFunction(const Shape& input_shape, size_t kernel, size_t stride, size_t padding);
+
+    private:
+        Shape input_shape_;
+        size_t kernel_, stride_, padding_;
+    };
+
+    // --- Normalization ---
+
+    /// Saves the per-row mean and 1/sqrt(var + eps) (`saved_tensors() = { mean, rstd }`);
+    /// backward recomputes x̂ from the input instead of keeping it. Inputs are
+    /// `{ x }` or `{ x, weight, bias }`.
+    class LayerNormFunction : public Function {
+        std::vector<af::array> apply(const af::array& grad_output) override;
+        std::string name() const override;
+
+    public:
+        explicit LayerNormFunction(const Reduction& reduction);
+
+    private:
+        Reduction reduction_;   // Trailing normalized axes, as (rows, n, 1)
+    };
+
+    /// Same saved state per channel. In eval mode the statistics are constants,
+    /// so dx is just g * weight * rstd.
+    class BatchNormFunction : public Function {
+        std::vector<af::array> apply(const af::array& grad_output) override;
+        std::string name() const override;
+
+    public:
+        BatchNormFunction(const Reduction& reduction, bool training);
+
+    private:
+        Reduction reduction_;   // Every axis but the channel axis
+        bool training_;
+    };
+
+    // --- Embedding & Dropout ---
+
+    /// Saves the flat u32 row indices; backward sorts them and sums the
+    /// gradient rows per index (`af::sumByKey`) into a zero `(num, dim)` grad.
+    class EmbeddingFunction : public Function {
+        std::vector<af::array> apply(const af::array& grad_output) override;
+        std::string name() const override;
+    };
+
+    /// Saves the b8 keep mask; dx = g * mask * scale.
+    class DropoutFunction : public Function {
+        std::vector<af::array> apply(const af::array& grad_output) override;
+        std::string name() const override;
+
+    public:
+        explicit DropoutFunction(float scale);
+
+    private:
+        float scale_;       // 1 / (1 - p)
+    };
+
+    // --- Checkpointing ---
+
+    /// Holds the segment and the RNG seed of its forward run. Backward re-runs
+    /// the segment on detached copies of the inputs with recording enabled,
+    /// runs a nested backward through the rebuilt graph (which also reaches the
+    /// parameters read inside) and returns the copies' gradients.
+    class CheckpointFunction : public Function {
+        std::vector<af::array> apply(const af::array& grad_output) override;
+        std::string name() const override;
+
+    public:
+        CheckpointFunction(CheckpointSegment segment, unsigned long long seed);
+
+        void release() override;
+
+        /// Seed drawn from the current ArrayFire RNG stream.
+        static unsigned long long fresh_seed();
+
+    private:
+        CheckpointSegment segment_;
+        unsigned long long seed_;
+    };
+
+    // --- Lazy ---
+
+    /// Backward of a lazy result. Inputs are the tensors its graph reads that
+    /// require grad; `apply()` builds their gradients as one lazy graph and
+    /// evaluates it in a single optimized batch.
+    class LazyFunction : public Function {
+        std::vector<af::array> apply(const af::array& grad_output) override;
+        std::string name() const override;
+
+    public:
+        explicit LazyFunction(lazy::NodePtr node);
+
+        void release() override;
+
+    private:
+        lazy::NodePtr node_;
+        std::vector<lazy::NodePtr> leaves_;     // Input nodes, one per entry of `inputs`
+    };
+
+    // --- View Operations ---
+
+    /// x[start:end:step] along one axis; backward scatters into a zero
+    /// gradient of the base shape.
+    class SliceFunction : public Function {
+        std::vector<af::array> apply(const af::array& grad_output) override;
+        std::string name() const override;
+
+    public:
+        SliceFunction(const Shape& input_shape, int dim, dim_t first, dim_t last, dim_t step);
+
+    private:
+        Shape input_shape_;  // Shape of the sliced tensor
+        int dim_;                          // Sliced axis
+        dim_t first_;                      // First index taken (inclusive)
+        dim_t last_;                       // Last index taken (inclusive)
+        dim_t step_;                       // Stride between taken indices
+    };
+
+    /// reshape / view / squeeze / unsqueeze.
+    class ReshapeFunction : public Function {
+        std::vector<af::array> apply(const af::array& grad_output) override;
+        std::string name() const override;
+
+    public:
+        explicit ReshapeFunction(const af::dim4& input_shape);
+
+    private:
+        af::dim4 input_shape_;  // Shape before the reshape
+    };
+
+    /// permute / transpose; backward applies the inverse permutation.
+    class PermuteFunction : public Function {
+        std::vector<af::array> apply(const af::array& grad_output) override;
+        std::string name() const override;
+
+    public:
+        explicit PermuteFunction(const std::array<unsigned, 4>& perm);
+        /// Rank above 4: `out_shape` is the output shape padded to `perm.size()` axes.
+        PermuteFunction(std::vector<unsigned> perm, Shape out_shape);
+
+    private:
+        std::vector<unsigned> perm_;    // Forward axis order
+        Shape out_shape_;               // Empty for rank <= 4
     };
 
     // --- Reduction Operations ---
 
+    /// Reductions keep the forward `Reduction` (axes, keepdim, grouped layout),
+    /// so any set of axes of any supported rank shares one backward.
     class SumFunction : public Function {
-        void apply(const af::array& grad_output) override;
+        std::vector<af::array> apply(const af::array& grad_output) override;
         std::string name() const override;
 
     public:
-        SumFunction(const af::dim4& input_shape, int dim, bool keepdim);
+        explicit SumFunction(const Reduction& reduction);
 
     private:
-        af::dim4 input_shape_;  // Shape of input before sum
-        int dim_;               // Reduction dimension
-        bool keepdim_;          // Whether output kept reduced dim
-
-        /// Compute how many times to tile the reduced gradient
-        af::dim4 get_tile_repeats(const af::dim4& target, const af::dim4& smaller) {
-            return af::dim4(
-                target[0] / std::max((dim_t)1, smaller[0]),
-                target[1] / std::max((dim_t)1, smaller[1]),
-                target[2] / std::max((dim_t)1, smaller[2]),
-                target[3] / std::max((dim_t)1, smaller[3])
-            );
-        }
+        Reduction reduction_;
     };
 
     class MeanFunction : public Function {
-        void apply(const af::array& grad_output) override;
+        std::vector<af::array> apply(const af::array& grad_output) override;
         std::string name() const override;
 
     public:
-        MeanFunction(const af::dim4& input_shape, int dim, bool keepdim);
+        explicit MeanFunction(const Reduction& reduction);
 
     private:
-        af::dim4 input_shape_;  // Original input shape
-        int dim_;               // Dimension reduced
-        bool keepdim_;          // Whether reduced dim is kept
-
-        /// Create tiling pattern to broadcast grad_output back to input shape
-        af::dim4 get_tile_dims(const af::dim4& input_dims, int dim) const {
-            af::dim4 tile_dims(1, 1, 1, 1);
-            tile_dims[dim] = input_dims[dim];
-            return tile_dims;
-        }
+        Reduction reduction_;
     };
 
+    /// Saves the argmax of each reduced column (`saved_tensors()[0]`, u32).
     class MaxFunction : public Function {
-        void apply(const af::array& grad_output) override;
+        std::vector<af::array> apply(const af::array& grad_output) override;
         std::string name() const override;
 
     public:
-        MaxFunction(const af::array& input_data, int dim, bool keepdim);
+        explicit MaxFunction(const Reduction& reduction);
 
     private:
-        af::array input_data_;  // Needed to identify max positions
-        int dim_;               // Axis along which max was computed
-        bool keepdim_;          // Whether reduced dim is kept
-        af::dim4 input_shape_;  // Original shape of input
+        Reduction reduction_;
+    };
 
-        /// Tiling pattern for broadcasting grad_output
-        af::dim4 get_tile_dims(const af::dim4& input_dims, int dim) const {
-            af::dim4 tile_dims(1, 1, 1, 1);
-            tile_dims[dim] = input_dims[dim];
-            return tile_dims;
-        }
+    /// Saves the argmin of each reduced column (`saved_tensors()[0]`, u32).
+    class MinFunction : public Function {
+        std::vector<af::array> apply(const af::array& grad_output) override;
+        std::string name() const override;
+
+    public:
+        explicit MinFunction(const Reduction& reduction);
+
+    private:
+        Reduction reduction_;
+    };
+
+    /// dx_i = g * prod_{j != i} x_j, from exclusive prefix and suffix products
+    /// so zeros in the input need no special case.
+    class ProdFunction : public Function {
+        std::vector<af::array> apply(const af::array& grad_output) override;
+        std::string name() const override;
+
+    public:
+        explicit ProdFunction(const Reduction& reduction);
+
+    private:
+        Reduction reduction_;
+    };
+
+    /// Saves the per-column mean; dx = g * 2 (x - mean) / (n - correction).
+    class VarFunction : public Function {
+        std::vector<af::array> apply(const af::array& grad_output) override;
+        std::string name() const override;
+
+    public:
+        VarFunction(const Reduction& reduction, bool unbiased);
+
+    private:
+        Reduction reduction_;
+        bool unbiased_;
+    };
+
+    /// Saves the per-column mean and the output; dx = g (x - mean) / ((n - correction) std).
+    class StdFunction : public Function {
+        std::vector<af::array> apply(const af::array& grad_output) override;
+        std::string name() const override;
+
+    public:
+        StdFunction(const Reduction& reduction, bool unbiased);
+
+    private:
+        Reduction reduction_;
+        bool unbiased_;
     };
 
 } // namespace cppgrad
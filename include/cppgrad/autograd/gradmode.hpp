@@ -0,0 +1,82 @@
+#pragma once
+
+namespace cppgrad {
+
+    /**
+     * @file gradmode.hpp
+     * @brief Thread-local switches that control graph recording.
+     *
+     * Ops consult `GradMode::is_enabled()` before attaching a `Function` to their
+     * output. While it is disabled, results are plain tensors: no `AutogradMeta`,
+     * no saved inputs and no graph edges, even if the operands require grad.
+     *
+     * RAII guards toggle the state for the current thread:
+     * - `NoGradGuard` disables recording; tensors created inside may still be
+     *   flagged `requires_grad` (e.g. freshly initialised parameters).
+     * - `EnableGradGuard` turns recording back on inside a no-grad scope (used
+     *   by checkpointed segments, which rebuild their graph during backward).
+     * - `InferenceMode` additionally forces every tensor created inside the scope
+     *   to be a plain tensor, ignoring `requires_grad=true` on factories, so nothing
+     *   autograd-related is allocated at all.
+     *
+     * Typical Usage:
+     * ```cpp
+     * {
+     *     cppgrad::NoGradGuard no_grad;
+     *     Tensor y = model_forward(x);   // no graph is built
+     * }
+     * ```
+     *
+     * Analogy: Similar to `torch::NoGradGuard` and `c10::InferenceMode`.
+    */
+
+    class GradMode {
+        public:
+            static bool is_enabled();
+            static void set_enabled(bool enabled);
+
+            static bool is_inference_mode();
+            static void set_inference_mode(bool enabled);
+    };
+
+    /// Disables graph recording on this thread for the guard's lifetime.
+    class NoGradGuard {
+        public:
+            NoGradGuard();
+            ~NoGradGuard();
+
+            NoGradGuard(const NoGradGuard&) = delete;
+            NoGradGuard& operator=(const NoGradGuard&) = delete;
+
+        private:
+            bool prev_enabled_;
+    };
+
+    /// Enables graph recording on this thread for the guard's lifetime.
+    class EnableGradGuard {
+        public:
+            EnableGradGuard();
+            ~EnableGradGuard();
+
+            EnableGradGuard(const EnableGradGuard&) = delete;
+            EnableGradGuard& operator=(const EnableGradGuard&) = delete;
+
+        private:
+            bool prev_enabled_;
+    };
+
+    /// Disables graph recording and autograd metadata allocation on this thread.
+    class InferenceMode {
+        public:
+            InferenceMode();
+            ~InferenceMode();
+
+            InferenceMode(const InferenceMode&) = delete;
+            InferenceMode& operator=(const InferenceMode&) = delete;
+
+        private:
+            bool prev_enabled_;
+            bool prev_inference_;
+    };
+
+}
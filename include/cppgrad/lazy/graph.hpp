@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <arrayfire.h>
+
+#include "cppgrad/tensor/reduction.hpp"
+#include "cppgrad/tensor/shape.hpp"
+
+namespace cppgrad {
+    class TensorImpl;
+}
+
+namespace cppgrad::lazy {
+
+    /**
+     * @file graph.hpp
+     * @brief IR recorded by ops inside a `LazyMode` scope (see lazymode.hpp).
+     *
+     * Each supported op appends one `Node` instead of calling ArrayFire and
+     * returns a tensor whose data is that node, computed when first read. A
+     * node names its operation, its operands and the logical shape of its
+     * result; scalar operands stay on the node. Nodes form a DAG shared by
+     * every tensor that refers to it:
+     * - `Input` holds the data of a tensor that was not produced lazily
+     *   (created outside the scope, or by an op without an IR form). The array
+     *   is taken when the node is recorded; ArrayFire is copy-on-write, so
+     *   later in-place writes to the tensor do not leak into the graph.
+     * - `Constant` is a `Tensor::full` / `zeros` / `ones` that does not require
+     *   grad; the passes fold it into the scalar forms of its consumers.
+     * - `Expand` broadcasts its operand to the node's shape. Binary ops insert
+     *   it, so the operands of an elementwise node always have its shape.
+     * - `ReduceTo`, `ExpandReduction` and `Step` only appear in gradients.
+     *
+     * Once emitted a node keeps its ArrayFire value (an evaluated buffer at an
+     * eval point, a JIT expression otherwise), and later materializations and
+     * gradient graphs start from it instead of recomputing the subgraph.
+    */
+
+    enum class Op {
+        Input, Constant,
+        // Elementwise, every operand has the node's shape
+        Add, Sub, Mul, Div,
+        AddScalar, MulScalar, DivScalar, RSubScalar, RDivScalar, PowScalar, RPowScalar,
+        Neg, Exp, Log, Relu, Sigmoid, Tanh, Step,
+        // Shape changing
+        Expand, ReduceTo, Sum, Mean, ExpandReduction
+    };
+
+    struct Node {
+        Op op;
+        std::vector<std::shared_ptr<Node>> inputs;
+        Shape shape;
+        float scalar = 0.0f;                    // Constant value, or the scalar operand
+        Reduction reduction;                    // Sum, Mean, ExpandReduction
+        bool requires_grad = false;             // Gradients flow through this node
+
+        std::shared_ptr<TensorImpl> source;     // Input: the tensor its data came from
+        uint64_t version = 0;                   // Input: version of `source` when recorded
+
+        af::array value;                        // Valid once `ready`
+        bool ready = false;
+    };
+
+    using NodePtr = std::shared_ptr<Node>;
+
+    /// Elementwise ops: ArrayFire keeps them as JIT nodes and fuses chains of
+    /// them into the kernel of their consumer.
+    bool is_elementwise(Op op);
+
+    /// New node of `op`; `requires_grad` is left to the caller.
+    NodePtr make_node(Op op, std::vector<NodePtr> inputs, Shape shape, float scalar = 0.0f);
+
+    /// Node standing for `impl`: the node that produced it if it is a lazy
+    /// result not written in place since, an `Input` holding its data otherwise.
+    NodePtr node_of(const std::shared_ptr<TensorImpl>& impl);
+
+    // -------- Recording (called by ops while LazyMode is enabled) --------
+    // The result requires grad when grad mode is on and an operand does.
+
+    /// `a op b` for Add, Sub, Mul, Div, broadcasting both operands (throws if
+    /// the shapes are incompatible).
+    std::shared_ptr<TensorImpl> record_binary(Op op, const std::shared_ptr<TensorImpl>& a,
+                                              const std::shared_ptr<TensorImpl>& b);
+
+    /// Unary and tensor-scalar ops.
+    std::shared_ptr<TensorImpl> record_unary(Op op, const std::shared_ptr<TensorImpl>& x, float scalar = 0.0f);
+
+    /// Sum or Mean over the axes of `r`.
+    std::shared_ptr<TensorImpl> record_reduction(Op op, const std::shared_ptr<TensorImpl>& x, const Reduction& r);
+
+    /// Tensor of `shape` filled with `value`.
+    std::shared_ptr<TensorImpl> record_constant(const Shape& shape, float value);
+
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <vector>
+
+#include "cppgrad/lazy/passes.hpp"
+
+namespace cppgrad {
+
+    /**
+     * @file lazymode.hpp
+     * @brief Opt-in lazy execution: ops record an IR, optimized as a whole before it runs.
+     *
+     * Eager ops each call ArrayFire right away, and several of them force
+     * evaluation at their boundary (saved arrays for backward are evaluated,
+     * reductions launch their own kernel), so fusion stops at every op.
+     * Inside a `LazyMode` scope the supported ops instead append a node to a
+     * graph (see lazy/graph.hpp) and return a tensor whose data is computed
+     * when first read. Reading it (`data()`, printing, backward, an op without
+     * a lazy form) or calling `materialize()` runs the passes of
+     * lazy/passes.hpp and emits the fewest ArrayFire calls and `af::eval`
+     * points for everything the result depends on.
+     *
+     * Lazy ops: elementwise arithmetic (tensor and scalar forms, with
+     * broadcasting), `neg`, `exp`, `log`, `pow` with a scalar operand, `relu`,
+     * `sigmoid`, `tanh`, `sum` / `mean`, and `Tensor::full` / `zeros` / `ones`
+     * without grad. Every other op reads its operands, which materializes
+     * them, and runs eagerly; the scope is only a hint.
+     *
+     * Autograd: a lazy result that requires grad gets a single `LazyFunction`
+     * node whose inputs are the non-lazy tensors the graph reads. Its backward
+     * builds the gradient graph of the whole lazy region symbolically and
+     * emits it in one batch, so gradient terms shared between ops are computed
+     * once and forward values are recomputed inside fused backward kernels
+     * instead of being saved. Gradients are not stored on lazy intermediates.
+     *
+     * Typical Usage:
+     * ```cpp
+     * Tensor loss = [&] {
+     *     cppgrad::LazyMode lazy;
+     *     Tensor h = tanh(x * w + b);
+     *     return (h * h).mean();     // nothing has run yet
+     * }();
+     * loss.backward();               // forward, then backward, each one batch
+     * ```
+     *
+     * Analogy: `torch.compile` / XLA's lazy tensors, at the granularity of
+     * ArrayFire calls.
+    */
+
+    class Tensor;
+
+    /// Records supported ops as IR on this thread for the guard's lifetime.
+    class LazyMode {
+        public:
+            LazyMode();
+            ~LazyMode();
+
+            LazyMode(const LazyMode&) = delete;
+            LazyMode& operator=(const LazyMode&) = delete;
+
+            static bool is_enabled();
+
+            /// Pass counters since the last reset (see lazy/passes.hpp).
+            static lazy::LazyStats stats();
+            static void reset_stats();
+
+        private:
+            bool prev_enabled_;
+    };
+
+    /// Compute every lazy tensor of `tensors` in a single optimized batch.
+    /// Tensors that are not lazy are left untouched.
+    void materialize(const std::vector<Tensor>& tensors);
+
+}
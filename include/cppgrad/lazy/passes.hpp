@@ -0,0 +1,66 @@
+#pragma once
+
+#include <vector>
+#include <arrayfire.h>
+
+#include "cppgrad/lazy/graph.hpp"
+
+namespace cppgrad::lazy {
+
+    /**
+     * @file passes.hpp
+     * @brief Whole-graph optimization and emission of the lazy IR.
+     *
+     * `evaluate(roots)` runs over the part of the graph that is reachable from
+     * `roots` and not emitted yet:
+     *   1. Constant folding: an op whose operands are all constants becomes a
+     *      constant; a binary op with one constant operand becomes its scalar
+     *      form (`x * full(2)` is `x * 2.0f`); identities such as `x * 1`,
+     *      `x + 0` or `-(-x)` are dropped, and chained scalar multiplies or
+     *      adds are merged.
+     *   2. Common-subexpression elimination: nodes with the same op, operands,
+     *      scalar and shape are merged (inputs by tensor and version).
+     *   3. Dead-code elimination: only nodes the roots depend on are emitted;
+     *      recorded results nobody reads never reach ArrayFire.
+     *   4. Eval planning: elementwise nodes are emitted as JIT expressions and
+     *      fuse into the kernel that consumes them. A node is evaluated on its
+     *      own only when several kernels (reductions, roots) read it, so it is
+     *      computed once instead of once per kernel. The roots are evaluated
+     *      together by a single `af::eval`.
+     * Rewrites are applied to the shared graph, so tensors recorded from the
+     * same nodes see them too.
+     *
+     * `gradients()` differentiates the graph symbolically: the gradient of a
+     * lazy result is itself a lazy graph over the forward nodes, optimized
+     * and emitted by `evaluate()` in one batch. Forward values that were left
+     * as JIT expressions are recomputed inside the backward kernels instead of
+     * being stored, so a chain of elementwise ops costs one fused kernel in
+     * each direction.
+    */
+
+    /// Counters of the passes since the last reset (all threads).
+    struct LazyStats {
+        size_t recorded = 0;        // Nodes created (forward and gradient)
+        size_t folded = 0;          // Nodes replaced by constant folding
+        size_t merged = 0;          // Nodes merged into an equal one
+        size_t emitted = 0;         // Nodes turned into ArrayFire calls
+        size_t evals = 0;           // Explicit `af::eval` calls
+        size_t materializations = 0;
+    };
+
+    LazyStats stats();
+    void reset_stats();
+    /// Add `n` to one counter.
+    void count(size_t LazyStats::* counter, size_t n = 1);
+
+    /// Values of `roots`, emitting whatever part of their graph is not ready.
+    std::vector<af::array> evaluate(const std::vector<NodePtr>& roots);
+
+    /// `Input` nodes below `root` whose tensor requires grad, in a fixed order.
+    std::vector<NodePtr> grad_inputs(const NodePtr& root);
+
+    /// Gradient of `root` with respect to each of `wrt`, given `seed` (the
+    /// gradient of `root` itself). Entries are null where no path exists.
+    std::vector<NodePtr> gradients(const NodePtr& root, const NodePtr& seed, const std::vector<NodePtr>& wrt);
+
+}
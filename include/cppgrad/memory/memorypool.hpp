@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+
+namespace cppgrad {
+
+    /**
+     * @file memorypool.hpp
+     * @brief Caching allocator for ArrayFire buffers, with usage statistics.
+     *
+     * `MemoryPool::install()` registers a custom ArrayFire memory manager, so every
+     * buffer behind a tensor (op results, zero grads, `zero_grad()` fills, JIT
+     * evaluation outputs) is served by cppgrad instead of ArrayFire's default.
+     *
+     * Requests are rounded up to a size class (512 B steps up to 1 MiB, 1 MiB steps
+     * above). Freed buffers go to a per-device free list for their class and are
+     * reused by the next request of that class without touching the driver.
+     *
+     * Limits (see `MemoryPoolOptions`):
+     * - `max_bytes` caps reserved memory (in use + cached). An allocation that would
+     *   cross it first empties the cache and then fails with an out-of-memory error.
+     * - `max_cached_bytes` caps the free lists; buffers freed past it are returned
+     *   to the driver straight away.
+     *
+     * Per-step usage: `MemoryStepGuard` (or `begin_step()` / `end_step()`) resets
+     * the step peak on entry and trims the cache back to `max_cached_bytes` on exit,
+     * so one oversized batch does not pin its buffers for the rest of training.
+     *
+     * Install the pool before creating any tensor. Buffers allocated by the
+     * previous manager are released directly to the driver when freed.
+     *
+     * Typical Usage:
+     * ```cpp
+     * cppgrad::MemoryPool::install({ .max_bytes = 2ull << 30 });
+     * for (auto& batch : loader) {
+     *     cppgrad::MemoryStepGuard step;
+     *     train_step(batch);
+     * }
+     * auto s = cppgrad::memory_stats();   // s.peak_bytes, s.hit_rate(), ...
+     * ```
+     *
+     * Analogy: Similar to PyTorch's CUDA caching allocator and
+     * `torch.cuda.memory_stats()`.
+    */
+
+    struct MemoryPoolOptions {
+        size_t max_bytes = 0;           // Hard cap on reserved bytes (0 = unlimited)
+        size_t max_cached_bytes = 0;    // Cap on idle cached bytes (0 = unlimited)
+    };
+
+    struct MemoryStats {
+        size_t current_bytes = 0;       // Bytes held by live buffers
+        size_t peak_bytes = 0;          // High-water mark of current_bytes since install / reset_peak()
+        size_t step_peak_bytes = 0;     // High-water mark since the last begin_step()
+        size_t cached_bytes = 0;        // Bytes idle in the free lists
+        size_t reserved_bytes = 0;      // current_bytes + cached_bytes
+        size_t alloc_count = 0;         // Allocation requests served
+        size_t native_alloc_count = 0;  // Requests that reached the driver
+        size_t native_free_count = 0;   // Buffers returned to the driver
+        size_t cache_hits = 0;
+        size_t cache_misses = 0;
+
+        double hit_rate() const {
+            size_t total = cache_hits + cache_misses;
+            return total == 0 ? 0.0 : static_cast<double>(cache_hits) / static_cast<double>(total);
+        }
+    };
+
+    class MemoryPool {
+        public:
+            static void install(const MemoryPoolOptions& options = {});
+            static void uninstall();
+            static bool is_installed();
+
+            static void set_options(const MemoryPoolOptions& options);
+            static MemoryPoolOptions options();
+
+            static MemoryStats stats();
+            static void reset_peak();
+
+            /// Return every cached (idle) buffer to the driver.
+            static void release_cached();
+
+            static void begin_step();
+            static void end_step();
+    };
+
+    /// Snapshot of allocator statistics (all zero when the pool is not installed).
+    MemoryStats memory_stats();
+
+    /// Brackets one training / inference step for `MemoryPool`.
+    class MemoryStepGuard {
+        public:
+            MemoryStepGuard();
+            ~MemoryStepGuard();
+
+            MemoryStepGuard(const MemoryStepGuard&) = delete;
+            MemoryStepGuard& operator=(const MemoryStepGuard&) = delete;
+    };
+
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "cppgrad/nn/module.hpp"
+
+namespace cppgrad::nn {
+
+    /// Parameter-free wrappers of the activation ops, for use in `Sequential`.
+    /// Prefer `Linear(in, out, Activation::Relu)` where it applies: it fuses the
+    /// activation into the GEMM node.
+
+    class ReLU : public Module {
+    public:
+        Tensor forward(const Tensor& x) override;
+    };
+
+    class Sigmoid : public Module {
+    public:
+        Tensor forward(const Tensor& x) override;
+    };
+
+    class Tanh : public Module {
+    public:
+        Tensor forward(const Tensor& x) override;
+    };
+
+    class GELU : public Module {
+    public:
+        Tensor forward(const Tensor& x) override;
+    };
+
+    class SiLU : public Module {
+    public:
+        Tensor forward(const Tensor& x) override;
+    };
+
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "cppgrad/nn/module.hpp"
+
+namespace cppgrad::nn {
+
+    /// `dropout(x, p)` in training mode, identity in eval mode.
+    class Dropout : public Module {
+    public:
+        explicit Dropout(float p = 0.5f);
+
+        Tensor forward(const Tensor& x) override;
+
+        float p() const { return p_; }
+
+    private:
+        float p_;
+    };
+
+}
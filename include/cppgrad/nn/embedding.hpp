@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+
+#include "cppgrad/nn/module.hpp"
+
+namespace cppgrad::nn {
+
+    /// Lookup table of `num_embeddings` rows of size `dim`, drawn from N(0, 1).
+    /// `forward` takes a float tensor of whole-number indices (see `embedding`).
+    class Embedding : public Module {
+    public:
+        Embedding(size_t num_embeddings, size_t dim);
+
+        Tensor forward(const Tensor& indices) override;
+
+        const Tensor& weight() const { return weight_; }
+
+    private:
+        Tensor weight_;
+    };
+
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+
+#include "cppgrad/nn/module.hpp"
+#include "cppgrad/ops/linear.hpp"
+
+namespace cppgrad::nn {
+
+    /// act(x @ weightᵀ + bias) through the fused `linear` op (one graph node).
+    /// `weight` is `(out, in)` drawn from N(0, 1 / in); `bias` is `(out)`, zero.
+    class Linear : public Module {
+    public:
+        Linear(size_t in_features, size_t out_features, bool bias = true,
+               Activation activation = Activation::None);
+        Linear(size_t in_features, size_t out_features, Activation activation);
+
+        Tensor forward(const Tensor& x) override;
+
+        const Tensor& weight() const { return weight_; }
+        /// Only meaningful when constructed with `bias = true`.
+        const Tensor& bias() const { return bias_; }
+
+    private:
+        Tensor weight_;
+        Tensor bias_;
+        bool has_bias_;
+        Activation activation_;
+    };
+
+}
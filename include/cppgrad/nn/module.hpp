@@ -0,0 +1,104 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "cppgrad/tensor/tensor.hpp"
+
+namespace cppgrad::nn {
+
+    /**
+     * @file module.hpp
+     * @brief Base class of the neural network layers (Linear, Sequential, ...).
+     *
+     * A `Module` owns tensors of two kinds and a list of child modules, each
+     * registered under a name from the subclass constructor:
+     * - parameters (`register_parameter`): trained tensors that require grad,
+     * - buffers (`register_buffer`): state that is not trained (e.g. running
+     *   statistics).
+     *
+     * `parameters()` / `named_parameters()` walk the tree depth-first, so
+     * `optim::Adam opt(model.parameters())` sees every weight once; names are
+     * dotted paths (`"0.weight"`, `"encoder.1.bias"`). The registry holds
+     * handles to the same `TensorImpl`s as the subclass members, so updates
+     * made by an optimizer are visible through both.
+     *
+     * `train()` / `eval()` set the mode of the whole tree. Calling a module
+     * (`operator()`) in eval mode runs `forward()` under a `NoGradGuard`, so no
+     * graph is recorded; layers such as `Dropout` also read `is_training()`.
+     *
+     * Typical Usage:
+     * ```cpp
+     * nn::Sequential mlp({
+     *     std::make_shared<nn::Linear>(784, 256, Activation::Relu),
+     *     std::make_shared<nn::Dropout>(0.1f),
+     *     std::make_shared<nn::Linear>(256, 10),
+     * });
+     * Tensor loss = cross_entropy(mlp(x), labels);
+     * mlp.eval();
+     * Tensor logits = mlp(x);     // no graph
+     * ```
+     *
+     * Analogy: `torch.nn.Module`.
+    */
+
+    class Module {
+    public:
+        Module() = default;
+        virtual ~Module() = default;
+
+        // Children are shared; parameters are handles. A copy would alias both.
+        Module(const Module&) = delete;
+        Module& operator=(const Module&) = delete;
+
+        virtual Tensor forward(const Tensor& x) = 0;
+
+        /// `forward(x)`, without graph recording in eval mode.
+        Tensor operator()(const Tensor& x);
+
+        /// Parameters of this module and every descendant, depth-first; a
+        /// tensor reachable twice (shared child) is listed once.
+        std::vector<Tensor> parameters() const;
+        std::vector<std::pair<std::string, Tensor>> named_parameters() const;
+        std::vector<Tensor> buffers() const;
+        std::vector<std::pair<std::string, Tensor>> named_buffers() const;
+
+        /// Direct children in registration order.
+        const std::vector<std::pair<std::string, std::shared_ptr<Module>>>& named_children() const { return children_; }
+
+        /// Set training mode on this module and every descendant.
+        void train(bool on = true);
+        void eval() { train(false); }
+        bool is_training() const { return training_; }
+
+        /// Release the gradients of every parameter.
+        void zero_grad() const;
+
+    protected:
+        /// Register a trainable tensor; it must require grad. Returns `tensor`.
+        Tensor register_parameter(const std::string& name, Tensor tensor);
+        /// Register a non-trainable tensor. Returns `tensor`.
+        Tensor register_buffer(const std::string& name, Tensor tensor);
+        /// Register a child module. Returns `module`.
+        template <typename M>
+        std::shared_ptr<M> register_module(const std::string& name, std::shared_ptr<M> module) {
+            add_child(name, module);
+            return module;
+        }
+
+    private:
+        void add_child(const std::string& name, std::shared_ptr<Module> module);
+        void check_name(const std::string& name) const;
+        void collect(const std::string& prefix, bool buffers, std::vector<std::pair<std::string, Tensor>>& out,
+                     std::unordered_set<const TensorImpl*>& seen) const;
+
+        std::vector<std::pair<std::string, Tensor>> parameters_;
+        std::vector<std::pair<std::string, Tensor>> buffers_;
+        std::vector<std::pair<std::string, std::shared_ptr<Module>>> children_;
+        bool training_ = true;
+    };
+
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "cppgrad/nn/module.hpp"
+
+namespace cppgrad::nn {
+
+    /// Children applied in order; child i is registered as `"i"`.
+    class Sequential : public Module {
+    public:
+        Sequential() = default;
+        explicit Sequential(std::vector<std::shared_ptr<Module>> layers);
+
+        /// Append a layer; returns `*this` for chaining.
+        Sequential& push_back(std::shared_ptr<Module> layer);
+
+        Tensor forward(const Tensor& x) override;
+
+        size_t size() const { return layers_.size(); }
+        Module& operator[](size_t i) const { return *layers_.at(i); }
+
+    private:
+        std::vector<std::shared_ptr<Module>> layers_;
+    };
+
+}
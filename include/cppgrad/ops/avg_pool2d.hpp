@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstddef>
+
+namespace cppgrad {
+    class Tensor;
+
+    /// Mean over `kernel × kernel` windows of an `(N, C, H, W)` tensor.
+    /// `stride == 0` means `stride = kernel`; zero padding counts towards the mean.
+    Tensor avg_pool2d(const Tensor& x, size_t kernel, size_t stride = 0, size_t padding = 0);
+}
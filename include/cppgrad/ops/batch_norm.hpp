@@ -0,0 +1,21 @@
+#pragma once
+
+namespace cppgrad {
+    class Tensor;
+
+    struct BatchNormOptions {
+        bool training = true;       // Batch statistics (and update running stats) vs running stats
+        float momentum = 0.1f;      // running = (1 - momentum) * running + momentum * batch
+        float eps = 1e-5f;
+    };
+
+    /// Per-channel normalization of `x` `(N, C, ...)` (rank 2 to 4), as
+    /// `torch.nn.functional.batch_norm`. `running_mean` / `running_var` are `(C)`
+    /// and are updated in place in training mode (with the unbiased batch
+    /// variance); `weight` / `bias` are `(C)`. One graph node.
+    Tensor batch_norm(const Tensor& x, Tensor& running_mean, Tensor& running_var,
+                      const Tensor& weight, const Tensor& bias,
+                      const BatchNormOptions& options = {});
+    Tensor batch_norm(const Tensor& x, Tensor& running_mean, Tensor& running_var,
+                      const BatchNormOptions& options = {});
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+
+namespace cppgrad {
+    class Tensor;
+
+    /// How `conv2d` computes the convolution.
+    enum class ConvAlgorithm {
+        Auto,       // Im2col unless dilated or the column buffer would be too large
+        Im2col,     // af::unwrap + one GEMM per group; no dilation
+        Direct      // af::convolve2NN and its gradient kernels
+    };
+
+    /// Square stride / padding / dilation, as in `torch.nn.functional.conv2d`.
+    struct Conv2dOptions {
+        size_t stride = 1;
+        size_t padding = 0;         // Zero padding on every side
+        size_t dilation = 1;
+        size_t groups = 1;
+        ConvAlgorithm algorithm = ConvAlgorithm::Auto;
+    };
+
+    /// `x` is `(N, C, H, W)`, `weight` is `(F, C / groups, KH, KW)`, `bias` is `(F)`;
+    /// the result is `(N, F, OH, OW)`.
+    Tensor conv2d(const Tensor& x, const Tensor& weight, const Tensor& bias,
+                  const Conv2dOptions& options = {});
+    Tensor conv2d(const Tensor& x, const Tensor& weight,
+                  const Conv2dOptions& options = {});
+}
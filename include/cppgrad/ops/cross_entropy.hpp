@@ -0,0 +1,13 @@
+#pragma once
+
+#include <vector>
+
+namespace cppgrad {
+    class Tensor;
+
+    /// Mean negative log-likelihood of integer class labels under
+    /// softmax(logits) along `class_dim`. `labels` has one entry per position of
+    /// the remaining axes, in row-major order (for `(N, C)` logits, `labels[n]`
+    /// is the class of sample n). No one-hot tensor is built.
+    Tensor cross_entropy(const Tensor& logits, const std::vector<int>& labels, int class_dim = 1);
+}
\ No newline at end of file
@@ -0,0 +1,10 @@
+#pragma once
+
+namespace cppgrad {
+    class Tensor;
+
+    /// Zero each element of `x` with probability `p` and scale the rest by
+    /// 1 / (1 - p), as `torch.nn.functional.dropout`. Returns `x` itself when
+    /// `training` is false or p == 0. The keep mask is saved for backward.
+    Tensor dropout(const Tensor& x, float p = 0.5f, bool training = true);
+}
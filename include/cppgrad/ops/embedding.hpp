@@ -0,0 +1,12 @@
+#pragma once
+
+namespace cppgrad {
+    class Tensor;
+
+    /// Rows of `weight` `(num_embeddings, dim)` picked by `indices`, as
+    /// `torch.nn.functional.embedding`. `indices` holds whole numbers stored as
+    /// floats (like `argmax`) and never receives a gradient; the result has
+    /// shape `indices.shape() + {dim}`. Backward sums the gradients of repeated
+    /// indices into their row without materializing a one-hot matrix.
+    Tensor embedding(const Tensor& indices, const Tensor& weight);
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+namespace cppgrad {
+    class Tensor;
+
+    /// Exact GELU: x · Φ(x), with Φ the standard normal CDF.
+    Tensor gelu(const Tensor& a);
+}
\ No newline at end of file
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace cppgrad {
+    class Tensor;
+
+    /// Normalize over the trailing `normalized_shape` axes of `x`, then scale by
+    /// `weight` and shift by `bias` (both of shape `normalized_shape`), as
+    /// `torch.nn.functional.layer_norm`. One graph node; statistics use the
+    /// biased variance.
+    Tensor layer_norm(const Tensor& x, const std::vector<size_t>& normalized_shape,
+                      const Tensor& weight, const Tensor& bias, float eps = 1e-5f);
+    Tensor layer_norm(const Tensor& x, const std::vector<size_t>& normalized_shape,
+                      float eps = 1e-5f);
+}
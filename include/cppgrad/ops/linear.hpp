@@ -0,0 +1,22 @@
+#pragma once
+
+namespace cppgrad {
+    class Tensor;
+
+    /// Activation fused into `linear`. Only activations whose derivative follows
+    /// from their output are offered, so backward needs no pre-activation buffer.
+    enum class Activation {
+        None,
+        Relu,
+        Sigmoid,
+        Tanh
+    };
+
+    /// act(x @ weightᵀ + bias) as a single graph node.
+    /// `x` is `(..., in)`, `weight` is `(out, in)`, `bias` is `(out)`; the result
+    /// is `(..., out)`. Leading axes of `x` are folded into one GEMM.
+    Tensor linear(const Tensor& x, const Tensor& weight, const Tensor& bias,
+                  Activation activation = Activation::None);
+    Tensor linear(const Tensor& x, const Tensor& weight,
+                  Activation activation = Activation::None);
+}
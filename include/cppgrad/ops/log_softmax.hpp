@@ -0,0 +1,8 @@
+#pragma once
+
+namespace cppgrad {
+    class Tensor;
+
+    /// a - logsumexp(a) along `dim`; stable for large logits.
+    Tensor log_softmax(const Tensor& a, int dim);
+}
\ No newline at end of file
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <vector>
+
+namespace cppgrad {
+    class Tensor;
+
+    /// log(sum(exp(a))) along `dim` (-1 = all elements), max-shifted.
+    Tensor logsumexp(const Tensor& a, int dim = -1, bool keepdim = false);
+
+    /// Over several axes at once (an empty list reduces every axis).
+    Tensor logsumexp(const Tensor& a, const std::vector<int>& dims, bool keepdim = false);
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstddef>
+
+namespace cppgrad {
+    class Tensor;
+
+    /// Max over `kernel × kernel` windows of an `(N, C, H, W)` tensor.
+    /// `stride == 0` means `stride = kernel`; padding never wins the max.
+    /// Throws if `padding > kernel / 2`, as PyTorch does.
+    Tensor max_pool2d(const Tensor& x, size_t kernel, size_t stride = 0, size_t padding = 0);
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+namespace cppgrad {
+    class Tensor;
+
+    Tensor sigmoid(const Tensor& a);
+}
\ No newline at end of file
@@ -0,0 +1,8 @@
+#pragma once
+
+namespace cppgrad {
+    class Tensor;
+
+    /// SiLU / swish: x · sigmoid(x).
+    Tensor silu(const Tensor& a);
+}
\ No newline at end of file
@@ -0,0 +1,8 @@
+#pragma once
+
+namespace cppgrad {
+    class Tensor;
+
+    /// exp(a) / sum(exp(a)) along `dim`, computed after subtracting the max.
+    Tensor softmax(const Tensor& a, int dim);
+}
\ No newline at end of file
@@ -0,0 +1,7 @@
+#pragma once
+
+namespace cppgrad {
+    class Tensor;
+
+    Tensor tanh(const Tensor& a);
+}
\ No newline at end of file
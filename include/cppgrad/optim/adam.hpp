@@ -0,0 +1,50 @@
+#pragma once
+
+#include "cppgrad/optim/optimizer.hpp"
+
+namespace cppgrad::optim {
+
+    struct AdamOptions {
+        float lr = 1e-3f;
+        float beta1 = 0.9f;
+        float beta2 = 0.999f;
+        float eps = 1e-8f;
+        float weight_decay = 0.0f;
+    };
+
+    /// Adam with bias correction, as `torch.optim.Adam`. `weight_decay` is an
+    /// L2 penalty added to the gradient.
+    class Adam : public Optimizer {
+    public:
+        Adam(std::vector<Tensor> params, const AdamOptions& options = {});
+
+        const AdamOptions& options() const { return options_; }
+        float lr() const override { return options_.lr; }
+        void set_lr(float lr) override { options_.lr = lr; }
+
+    protected:
+        af::array update(const af::array& params, const af::array& grads) override;
+        std::vector<af::array*> state() override;
+
+        /// Adam step on already-decayed `params` and the effective gradient.
+        af::array adam_update(const af::array& params, const af::array& grads);
+
+        AdamOptions options_;
+
+    private:
+        af::array exp_avg_;       // First moment
+        af::array exp_avg_sq_;    // Second moment
+        std::vector<uint64_t> steps_;   // Steps taken by each parameter, for bias correction
+    };
+
+    /// Adam with decoupled weight decay, as `torch.optim.AdamW`: parameters
+    /// shrink by `lr * weight_decay` instead of the penalty entering the moments.
+    class AdamW : public Adam {
+    public:
+        AdamW(std::vector<Tensor> params, const AdamOptions& options = { .weight_decay = 1e-2f });
+
+    protected:
+        af::array update(const af::array& params, const af::array& grads) override;
+    };
+
+}
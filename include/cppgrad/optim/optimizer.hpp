@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <arrayfire.h>
+
+#include "cppgrad/tensor/tensor.hpp"
+
+namespace cppgrad::optim {
+
+    /**
+     * @file optimizer.hpp
+     * @brief Base class of the multi-tensor optimizers (SGD, Adam, AdamW).
+     *
+     * An optimizer packs all of its parameters into one flat f32 buffer, and
+     * every parameter's data becomes a view into it. Optimizer state (momentum,
+     * Adam moments) lives in flat buffers of the same length. One `step()`:
+     *   1. gathers the parameter gradients into a flat buffer (`af_join_many`,
+     *      a handful of kernels regardless of the parameter count),
+     *   2. computes the new parameters and state as one JIT expression per
+     *      buffer and evaluates them together, so the whole update is a single
+     *      fused kernel,
+     *   3. re-points each parameter at its slice of the new flat buffer and
+     *      bumps the version of every updated one (graphs that saved the old
+     *      values throw if replayed).
+     *
+     * Unlike the parameters, gradients are not views of a persistent flat
+     * buffer: autograd accumulates each leaf gradient into its own array, and
+     * ArrayFire's copy-on-write arrays cannot be written through a view. Step 1
+     * therefore copies every gradient once per step (the same amount of
+     * memory traffic as reading them). `BM_OptimGather` in
+     * benchmarks/optim_bench.cpp measures that copy on its own.
+     *
+     * ArrayFire buffers are copy-on-write, so the update produces a fresh flat
+     * buffer instead of writing through the views; the previous one is freed
+     * once every parameter has been re-pointed. A parameter modified outside the
+     * optimizer (e.g. `fill_()`) is detected by its version and re-packed before
+     * the next step.
+     *
+     * `zero_grad()` drops every gradient buffer (no kernel at all). As in
+     * `torch.optim`, a parameter without a gradient is skipped: a per-step
+     * mask keeps its slice of the parameters and of every state buffer
+     * unchanged, so neither weight decay nor momentum moves it.
+     *
+     * Typical Usage:
+     * ```cpp
+     * cppgrad::optim::Adam opt(model_params, { .lr = 1e-3f });
+     * for (auto& batch : loader) {
+     *     opt.zero_grad();
+     *     loss(batch).backward();
+     *     opt.step();
+     * }
+     * ```
+     *
+     * Analogy: `torch.optim` with `foreach=True` / `fused=True`.
+    */
+
+    class Optimizer {
+    public:
+        /// Every parameter must require grad and appear once.
+        explicit Optimizer(std::vector<Tensor> params);
+        virtual ~Optimizer() = default;
+
+        Optimizer(const Optimizer&) = delete;
+        Optimizer& operator=(const Optimizer&) = delete;
+
+        /// Apply one update to every parameter.
+        void step();
+
+        /// Release every parameter's gradient.
+        void zero_grad();
+
+        const std::vector<Tensor>& params() const { return params_; }
+        /// Total number of parameter elements (length of the flat buffers).
+        size_t numel() const { return numel_; }
+        /// Number of completed `step()` calls.
+        uint64_t step_count() const { return step_count_; }
+
+        virtual float lr() const = 0;
+        virtual void set_lr(float lr) = 0;
+
+    protected:
+        /// New flat parameters from the current ones and the flat gradient.
+        /// Implementations update their state buffers as lazy expressions;
+        /// `step()` evaluates them together with the result via `state()`.
+        virtual af::array update(const af::array& params, const af::array& grads) = 0;
+
+        /// State buffers to evaluate alongside the parameters.
+        virtual std::vector<af::array*> state() = 0;
+
+        /// Zero-filled flat buffer, e.g. for lazily created state.
+        af::array zeros() const;
+
+        /// Whether parameter `i` has a gradient in the current step; updates
+        /// computed for the others are discarded by `step()`.
+        bool active(size_t i) const { return active_[i]; }
+        bool all_active() const { return all_active_; }
+
+        /// Flat buffer holding `values[i]` over the elements of parameter `i`.
+        af::array per_param(const std::vector<float>& values) const;
+        /// Flat b8 mask of the elements of parameters whose flag is set.
+        af::array mask(const std::vector<bool>& flags) const;
+
+    private:
+        /// Pack the parameters into `flat_` and point them at it.
+        void pack();
+        /// Point every parameter at its slice of `flat_`; with `bump_version`,
+        /// bump the versions of the parameters updated in this step.
+        void bind(bool bump_version);
+        /// Gradients concatenated in parameter order (a parameter without one
+        /// contributes its own values, masked out of the update).
+        af::array gather_grads() const;
+
+        std::vector<Tensor> params_;
+        std::vector<size_t> offsets_;       // Start of each parameter in the flat buffers
+        std::vector<uint64_t> versions_;    // Versions after the last pack / step
+        af::array flat_;
+        mutable af::array segments_;        // Owning parameter of each element (u32), built on first use
+        std::vector<bool> active_;          // Parameters with a gradient in the current step
+        bool all_active_ = true;
+        size_t numel_ = 0;
+        uint64_t step_count_ = 0;
+    };
+
+}
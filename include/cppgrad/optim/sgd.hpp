@@ -0,0 +1,35 @@
+#pragma once
+
+#include "cppgrad/optim/optimizer.hpp"
+
+namespace cppgrad::optim {
+
+    struct SGDOptions {
+        float lr = 1e-2f;
+        float momentum = 0.0f;
+        float dampening = 0.0f;
+        float weight_decay = 0.0f;      // L2 penalty added to the gradient
+        bool nesterov = false;
+    };
+
+    /// Stochastic gradient descent with optional (Nesterov) momentum, with the
+    /// same update rule as `torch.optim.SGD`.
+    class SGD : public Optimizer {
+    public:
+        SGD(std::vector<Tensor> params, const SGDOptions& options = {});
+
+        const SGDOptions& options() const { return options_; }
+        float lr() const override { return options_.lr; }
+        void set_lr(float lr) override { options_.lr = lr; }
+
+    protected:
+        af::array update(const af::array& params, const af::array& grads) override;
+        std::vector<af::array*> state() override;
+
+    private:
+        SGDOptions options_;
+        af::array momentum_;        // Momentum buffer; empty without momentum
+        std::vector<bool> seeded_;  // Parameters whose momentum has been seeded by a first step
+    };
+
+}
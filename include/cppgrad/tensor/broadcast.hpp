@@ -0,0 +1,51 @@
+#pragma once
+
+#include <arrayfire.h>
+
+#include "cppgrad/tensor/shape.hpp"
+
+namespace cppgrad {
+
+    /**
+     * @file broadcast.hpp
+     * @brief Broadcasting helpers shared by the binary ops and their backward functions.
+     *
+     * Shapes follow NumPy rules: they are right-aligned, and two sizes are compatible
+     * when they are equal or one of them is 1; the result takes the larger size.
+     *
+     * Shapes may have any rank, but ArrayFire only has four dims. Before expanding,
+     * neighbouring axes that are broadcast the same way (all expanded, or all kept)
+     * are coalesced into one, so e.g. `[8, 4, 16, 16, 1] + [16, 16, 3]` runs as a
+     * 3-dim tile. Only patterns needing more than four groups are rejected.
+     *
+     * Expansion uses `af::tile`, which ArrayFire records as a lazy JIT node, so the
+     * expanded operand is fused into the consuming kernel instead of being written
+     * out as a full-size copy. In backward, `reduce_to()` sums a gradient over every
+     * broadcast axis so it matches the shape of the input it belongs to.
+    */
+
+    class Broadcast {
+        public:
+            /// Shape of the broadcast result of `a` and `b`; throws if incompatible.
+            static Shape result_shape(const Shape& a,
+                                                    const Shape& b);
+
+            /// Expand `arr` (logical shape `from`) to `to`; the result has `to`'s folded dims.
+            static af::array expand(const af::array& arr,
+                                    const Shape& from,
+                                    const Shape& to);
+
+            /// Sum `grad` (logical shape `from`) over the broadcast axes, giving shape `to`.
+            static af::array reduce_to(const af::array& grad,
+                                       const Shape& from,
+                                       const Shape& to);
+
+        private:
+            /// Coalesced `(small, large)` group sizes for broadcasting `small` to `large`.
+            static void coalesce(const Shape& small,
+                                 const Shape& large,
+                                 af::dim4& small_dims,
+                                 af::dim4& large_dims);
+    };
+
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <arrayfire.h>
+
+#include "cppgrad/tensor/shape.hpp"
+
+namespace cppgrad {
+
+    class TensorImpl;
+
+    /**
+     * @file gemm.hpp
+     * @brief Layout helpers shared by matmul / linear and their backward functions.
+     *
+     * Matrix products follow PyTorch's convention: the last two axes are the matrix
+     * `(rows, cols)` and any leading axes are batch axes. ArrayFire batches over its
+     * trailing dims instead, so a batched operand `(b..., R, C)` is moved into
+     * ArrayFire's `(R, C, prod(b...))` layout with `to_batched()` and back with
+     * `from_batched()`. Storage is column-major, so the leading batch axes are
+     * always adjacent and merge with a single `af::moddims`.
+     *
+     * Transposes never get materialized for a GEMM: `operand()` hands a pending 2D
+     * transpose to ArrayFire as `AF_MAT_TRANS`, and backward passes use the
+     * transpose flags rather than `af::transpose`.
+    */
+
+    class Gemm {
+        public:
+            /// Shape of `a @ b`. Operands of rank <= 2 multiply as ArrayFire
+            /// matrices; otherwise batch axes must match, or one side is 2D.
+            /// Throws on a mismatch.
+            static Shape result_shape(const Shape& a, const Shape& b);
+
+            /// Data for a GEMM operand. A pending 2D transpose is returned as its
+            /// source with `prop = AF_MAT_TRANS`; anything else as-is with `AF_MAT_NONE`.
+            static af::array operand(const TensorImpl& impl, af_mat_prop& prop);
+
+            /// The operand of the product's transpose: TRANS <-> NONE.
+            static af_mat_prop flip(af_mat_prop prop);
+
+            /// `(b..., R, C)` viewed as ArrayFire's batched `(R, C, prod(b...))`.
+            static af::array to_batched(const af::array& data, const Shape& shape);
+
+            /// Inverse of `to_batched()`: the result has `shape`'s folded dims.
+            static af::array from_batched(const af::array& batched, const Shape& shape);
+
+            /// Product of the batch axes (everything but the last two).
+            static dim_t batch_count(const Shape& shape);
+    };
+
+}
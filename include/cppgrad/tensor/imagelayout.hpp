@@ -0,0 +1,81 @@
+#pragma once
+
+#include <arrayfire.h>
+
+#include "cppgrad/tensor/shape.hpp"
+
+namespace cppgrad {
+
+    /**
+     * @file imagelayout.hpp
+     * @brief Conversions between cppgrad's NCHW tensors and ArrayFire's image layout.
+     *
+     * Image ops follow PyTorch's `(N, C, H, W)` shape. Since cppgrad axis `i` is
+     * ArrayFire dim `i`, that puts the batch in the fastest dim, whereas ArrayFire's
+     * image functions (`unwrap`, `wrap`, `convolve2NN`) expect `(H, W, C, N)`.
+     * `to_image()` / `from_image()` reorder between the two; convolution weights
+     * `(F, C, KH, KW)` map to ArrayFire filters `(KH, KW, C, F)` the same way.
+     *
+     * The im2col helpers lay a convolution out as one GEMM: `im2col()` turns an
+     * image into a `(KH*KW*C, OH*OW*N)` column matrix, `filter_matrix()` turns a
+     * filter into `(F, KH*KW*C)` with the same row order, and the product is an
+     * `(F, OH*OW*N)` matrix that `from_gemm()` turns back into an image.
+     * `col2im()` is the adjoint of `im2col()` (overlapping windows are summed).
+    */
+
+    class ImageLayout {
+        public:
+            /// `(N, C, H, W)` data → ArrayFire `(H, W, C, N)`.
+            static af::array to_image(const af::array& nchw);
+
+            /// ArrayFire `(H, W, C, N)` → `(N, C, H, W)` data.
+            static af::array from_image(const af::array& image);
+
+            /// Weight `(F, C, KH, KW)` → filter `(KH, KW, C, F)`.
+            static af::array to_filter(const af::array& weight);
+
+            /// Filter `(KH, KW, C, F)` → weight `(F, C, KH, KW)`.
+            static af::array from_filter(const af::array& filter);
+
+            /// Rotate every kernel by 180°. `convolve2NN` computes a true convolution
+            /// while `conv2d` is a cross-correlation (as in PyTorch).
+            static af::array flip_filter(const af::array& filter);
+
+            /// Image `(H, W, C, N)` → columns `(KH*KW*C, OH*OW*N)`.
+            static af::array im2col(const af::array& image, dim_t kh, dim_t kw,
+                                    dim_t stride, dim_t padding);
+
+            /// Columns → image of `image_dims`, summing overlapping windows.
+            static af::array col2im(const af::array& cols, const af::dim4& image_dims,
+                                    dim_t kh, dim_t kw, dim_t stride, dim_t padding);
+
+            /// Filter `(KH, KW, C, F)` → `(F, KH*KW*C)`.
+            static af::array filter_matrix(const af::array& filter);
+
+            /// Inverse of `filter_matrix()` for a filter of `filter_dims`.
+            static af::array from_filter_matrix(const af::array& matrix, const af::dim4& filter_dims);
+
+            /// GEMM result `(F, OH*OW*N)` → image `(OH, OW, F, N)`.
+            static af::array from_gemm(const af::array& matrix, dim_t oh, dim_t ow);
+
+            /// Image `(OH, OW, F, N)` → `(F, OH*OW*N)`.
+            static af::array to_gemm(const af::array& image);
+
+            /// Channels `[index * size, (index + 1) * size)` along `dim` (2 for images,
+            /// 3 for filters); the whole array when it has exactly `size` channels.
+            static af::array group(const af::array& arr, unsigned dim, dim_t index, dim_t size);
+
+            /// Write `src` into group `index` of `dst` (see `group()`); an empty or
+            /// single-group `dst` is replaced outright.
+            static void assign_group(af::array& dst, unsigned dim, dim_t index, dim_t size,
+                                     const af::array& src);
+
+            /// Spatial output size of a sliding window; throws if it would be < 1.
+            static size_t output_size(size_t input, size_t kernel, size_t stride,
+                                      size_t padding, size_t dilation = 1);
+
+            /// Throws unless `shape` is rank 4 (N, C, H, W).
+            static void check_nchw(const Shape& shape, const char* op);
+    };
+
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <arrayfire.h>
+
+#include "cppgrad/tensor/shape.hpp"
+
+namespace cppgrad {
+
+    /**
+     * @file reduction.hpp
+     * @brief Layout of a reduction over one or more axes, shared by forward and backward.
+     *
+     * Every reduction views its input as `(before, n, after)` and reduces along
+     * ArrayFire dim 1, so each output element owns one column of `n` values:
+     * - A contiguous run of axes (any single axis, every axis, or e.g. `{1, 2}`)
+     *   merges with `af::moddims` alone, at any rank.
+     * - Other axis sets of a rank <= 4 tensor are first `af::reorder`ed so the
+     *   kept axes come first and the reduced ones last.
+     *
+     * The reduced `(before, 1, after)` array is already in the output's element
+     * order (with or without keepdim). Backward functions keep the `Reduction`
+     * and use `expand()` to broadcast a gradient over each column, or
+     * `scatter()` to route it to one saved index per column (max, min) instead
+     * of re-reducing the input.
+    */
+
+    class Reduction {
+        public:
+            Reduction() = default;
+
+            /// Reduce `dims` of `shape`; an empty list reduces every axis. Throws on
+            /// an out-of-range or repeated axis, or a non-contiguous set above rank 4.
+            Reduction(const Shape& shape, std::vector<int> dims, bool keepdim);
+
+            /// Single-axis form; `dim == -1` reduces every axis.
+            Reduction(const Shape& shape, int dim, bool keepdim);
+
+            const Shape& input_shape() const { return input_shape_; }
+            const Shape& output_shape() const { return output_shape_; }
+            const af::dim4& grouped() const { return grouped_; }
+            /// Axis order applied before grouping (identity for a contiguous run).
+            const std::array<unsigned, 4>& perm() const { return perm_; }
+
+            /// Values reduced into each output element.
+            dim_t count() const { return grouped_[1]; }
+
+            /// Input data → `(before, n, after)`.
+            af::array group(const af::array& data) const;
+
+            /// `(before, n, after)` → input dims (inverse of `group()`).
+            af::array ungroup(const af::array& grouped) const;
+
+            /// Reduced `(before, 1, after)` → output dims.
+            af::array result(const af::array& reduced) const;
+
+            /// Output-shaped `grad` repeated over each reduced column, in input dims.
+            af::array expand(const af::array& grad) const;
+
+            /// Output-shaped `grad` written at `indices` (u32 positions along the
+            /// reduced column, as returned by `af::max(val, idx, ...)`), zero elsewhere.
+            af::array scatter(const af::array& grad, const af::array& indices) const;
+
+        private:
+            Shape input_shape_;
+            Shape output_shape_;
+            af::dim4 grouped_;
+            std::array<unsigned, 4> perm_ = { 0, 1, 2, 3 };
+            bool permuted_ = false;
+    };
+
+}
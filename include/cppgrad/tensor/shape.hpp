@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+namespace cppgrad {
+
+    /**
+     * @file shape.hpp
+     * @brief Small-buffer shape type stored in every `TensorImpl`.
+     *
+     * Every op reads the shapes of its operands, so shapes are kept inline:
+     * up to `kInlineRank` axes live in a fixed array inside the object and only
+     * higher ranks spill to the heap. Copying a shape of rank <= 8 never
+     * allocates, and comparison is a rank check plus a `memcmp` of at most eight
+     * words.
+     *
+     * Size-1 axes are part of the shape: `{1, 5}` and `{5}` are different.
+     *
+     * The interface mirrors the parts of `std::vector<size_t>` the codebase uses
+     * (iteration, indexing, insert/erase, resize), and a shape converts to and
+     * compares equal with a `std::vector<size_t>` holding the same axes.
+    */
+
+    class Shape {
+    public:
+        static constexpr size_t kInlineRank = 8;
+
+        using value_type = size_t;
+        using iterator = size_t*;
+        using const_iterator = const size_t*;
+
+        // -------- Constructors --------
+        Shape() = default;
+        Shape(std::initializer_list<size_t> dims);
+        Shape(const std::vector<size_t>& dims);
+        explicit Shape(size_t rank, size_t value = 0);
+
+        Shape(const Shape& other);
+        Shape(Shape&& other) noexcept;
+        Shape& operator=(const Shape& other);
+        Shape& operator=(Shape&& other) noexcept;
+        ~Shape() = default;
+
+        // -------- Access --------
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+
+        size_t* data() { return heap_ ? heap_.get() : inline_; }
+        const size_t* data() const { return heap_ ? heap_.get() : inline_; }
+
+        size_t& operator[](size_t i) { return data()[i]; }
+        size_t operator[](size_t i) const { return data()[i]; }
+        /// Last axis; the shape must not be empty.
+        size_t back() const { return data()[size_ - 1]; }
+
+        iterator begin() { return data(); }
+        iterator end() { return data() + size_; }
+        const_iterator begin() const { return data(); }
+        const_iterator end() const { return data() + size_; }
+
+        /// Product of all axes (1 for a scalar).
+        size_t numel() const;
+
+        // -------- Modification --------
+        void push_back(size_t dim);
+        iterator insert(const_iterator pos, size_t dim);
+        iterator erase(const_iterator pos);
+        void resize(size_t rank, size_t value = 0);
+
+        // -------- Interop --------
+        std::vector<size_t> to_vector() const { return { begin(), end() }; }
+        operator std::vector<size_t>() const { return to_vector(); }
+
+        friend bool operator==(const Shape& a, const Shape& b) {
+            return a.size_ == b.size_ &&
+                   std::memcmp(a.data(), b.data(), a.size_ * sizeof(size_t)) == 0;
+        }
+        friend bool operator!=(const Shape& a, const Shape& b) { return !(a == b); }
+
+        friend bool operator==(const Shape& a, const std::vector<size_t>& b) {
+            return a.size_ == b.size() &&
+                   std::memcmp(a.data(), b.data(), a.size_ * sizeof(size_t)) == 0;
+        }
+        friend bool operator==(const std::vector<size_t>& a, const Shape& b) { return b == a; }
+        friend bool operator!=(const Shape& a, const std::vector<size_t>& b) { return !(a == b); }
+        friend bool operator!=(const std::vector<size_t>& a, const Shape& b) { return !(b == a); }
+
+    private:
+        /// Make room for at least `rank` axes, spilling to the heap past kInlineRank.
+        void reserve(size_t rank);
+
+        size_t inline_[kInlineRank] = {};      // Axes when rank <= kInlineRank
+        std::unique_ptr<size_t[]> heap_;       // Axes when rank > kInlineRank
+        size_t capacity_ = kInlineRank;        // Slots available in the active buffer
+        size_t size_ = 0;                      // Rank
+    };
+
+} // namespace cppgrad
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <arrayfire.h>
+
+#include "cppgrad/tensor/shape.hpp"
+
+namespace cppgrad {
+
+    /**
+     * @file shapeutils.hpp
+     * @brief Mapping between cppgrad's logical shapes and ArrayFire's four dims.
+     *
+     * A cppgrad shape can have any rank. Axis `i` of the shape is ArrayFire dim `i`
+     * for the first three axes; every axis from the fourth on is folded into
+     * ArrayFire dim 3. Storage stays column-major, so folding is a pure
+     * reinterpretation of the same buffer (`af::moddims`), never a copy.
+     *
+     * Ops that work along a single axis (reductions, slicing) view the data as
+     * `(before, n, after)` via `around()`, which covers every axis of every rank with
+     * a single ArrayFire call along dim 1. Permutations above rank 4 are
+     * materialized by `permute()`, one `af::reorder` per axis moved.
+    */
+
+    class ShapeUtils {
+        public:
+            /// ArrayFire dims for a logical shape (axes 3.. folded into dim 3).
+            static af::dim4 fold(const Shape& shape);
+
+            /// Logical shape of a raw ArrayFire array: its dims up to the last one > 1.
+            static Shape from_dims(const af::dim4& dims);
+
+            /// Number of elements in `shape` (1 for a scalar).
+            static size_t numel(const Shape& shape);
+
+            /// `(prod(shape[:dim]), shape[dim], prod(shape[dim+1:]), 1)`.
+            static af::dim4 around(const Shape& shape, int dim);
+
+            /// Copy of `data` (logical `shape`, any rank) with output axis `i`
+            /// taken from input axis `perm[i]`, in the folded dims of the result.
+            /// Moves one axis per `af::reorder`, viewing the data as
+            /// `(before, between, axis, after)`; at most `rank - 1` copies.
+            static af::array permute(const af::array& data, const Shape& shape, const std::vector<unsigned>& perm);
+
+            /// "[2, 3, 4]"
+            static std::string to_string(const Shape& shape);
+    };
+
+}
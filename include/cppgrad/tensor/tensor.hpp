@@ -2,9 +2,12 @@
 
 #include <vector>
 #include <memory>
+#include <span>
 #include <arrayfire.h>
 
 #include "tensorimpl.hpp"
+#include "cppgrad/autograd/checkpoint.hpp"
+#include "cppgrad/lazy/lazymode.hpp"
 
 namespace cppgrad {
 
@@ -17,11 +20,23 @@ namespace cppgrad {
      * and autograd capabilities, similar to PyTorch's `torch.Tensor`.
      *
      * Key Features:
-     * - Tensor creation: `zeros`, `ones`, `randn`, `full`, `from_array_column_major`
+     * - Tensor creation: `zeros`, `ones`, `randn`, `full`, `from_array_column_major`,
+     *   `from_blob` (copy a host buffer), `borrow` (wrap caller-owned memory)
      * - Data inspection: shape, numel, ndim, gradient info, print utilities
      * - Operator overloading for elementwise math (+, -, *, /) and broadcasting
      * - Autograd support: attaches backward functions and triggers `.backward()`
-     * - Reduction operations: `sum`, `mean`, `max`
+     * - Activations: `relu`, `sigmoid`, `tanh`, `gelu`, `silu` (one graph node each)
+     * - Batched `TensorUtils::matmul` and fused `linear` (GEMM + bias + activation)
+     * - Softmax family: `softmax`, `log_softmax`, `logsumexp`, `cross_entropy`
+     * - Normalization: `layer_norm`, `batch_norm` (running stats, eval mode)
+     * - `embedding` (row lookup, scatter-add backward) and `dropout`
+     * - Images (NCHW): `conv2d` (im2col + GEMM or direct), `max_pool2d`, `avg_pool2d`
+     * - Reduction operations: `sum`, `mean`, `max`, `min`, `prod`, `var`, `std`,
+     *   `argmax`, `argmin`, over one axis, several axes or all elements
+     * - Views: `slice`, `reshape`, `view`, `permute`, `transpose`, `squeeze`, `unsqueeze`
+     * - In-place updates: `add_`, `sub_`, `mul_`, `fill_`, `zero_`, `clamp_`
+     * - Any rank: shapes with more than four axes are folded onto ArrayFire's
+     *   four dims (see shapeutils.hpp); `permute`/`transpose` above rank 4 copy
      *
      * Design:
      * - Wraps a `std::shared_ptr<TensorImpl>` to allow internal tensor reuse.
@@ -30,6 +45,19 @@ namespace cppgrad {
      * - Actual autograd logic resides in `Function` subclasses attached via `TensorImpl`.
     */
 
+    enum class Activation;
+    struct Conv2dOptions;
+    struct BatchNormOptions;
+    class Reduction;
+    class CheckpointFunction;
+    class CapturedStep;
+
+    /// Memory order of a host buffer handed to `from_blob` / `borrow`.
+    enum class Layout {
+        RowMajor,       // Last axis fastest (C / NumPy order)
+        ColumnMajor     // First axis fastest (ArrayFire / Fortran order)
+    };
+
     class Tensor {
     public:
         // -------- Constructors --------
@@ -44,11 +72,36 @@ namespace cppgrad {
                                               const std::vector<float>& values,
                                               bool requires_grad = false);
 
+        /// Copy `values` in one upload. Row-major data is kept as a view with
+        /// reversed axes and only reordered when a kernel needs it.
+        static Tensor from_blob(std::span<const float> values,
+                                const std::vector<size_t>& shape,
+                                Layout layout = Layout::RowMajor,
+                                bool requires_grad = false);
+        static Tensor from_blob(const float* data,
+                                const std::vector<size_t>& shape,
+                                Layout layout = Layout::RowMajor,
+                                bool requires_grad = false);
+
+        /// Wrap a column-major `data` without copying (CPU backend; other
+        /// backends copy). The caller keeps `data` alive for as long as the
+        /// tensor and any view of it exist. Writes to `data` are visible
+        /// through the tensor and to ops run afterwards, but not in results
+        /// already computed, nor once an in-place op has replaced the tensor's
+        /// buffer. Throws for a row-major layout of rank > 1, whose pending
+        /// permute would be materialized into a copy.
+        static Tensor borrow(float* data,
+                             const std::vector<size_t>& shape,
+                             Layout layout = Layout::ColumnMajor,
+                             bool requires_grad = false);
+
         // -------- Shape and Info --------
-        std::vector<size_t> shape() const;
+        const Shape& shape() const;
         size_t numel() const;
         size_t ndim() const;
         bool requires_grad() const;
+        /// False for pending permutes and strided slices.
+        bool is_contiguous() const;
 
         void zero_grad() const;
         void print() const;
@@ -56,18 +109,79 @@ namespace cppgrad {
         void print_grad() const;
 
         // -------- Autograd --------
-        void backward(const af::array& grad_output = af::array());
+        void backward(const af::array& grad_output = af::array(), bool retain_graph = false);
         af::array grad() const;
 
+        /// Keep this (non-leaf) tensor's gradient after backward.
+        void retain_grad() const;
+        bool is_leaf() const;
+
         // -------- Data Access --------
         af::array data() const;
         std::shared_ptr<TensorImpl> impl() const;
 
         // -------- Reduction Ops --------
         /// Sum over one axis (or all), optionally keeping reduced dim.
+        /// `dim` may be any axis of the logical shape.
         Tensor sum(int dim = -1, bool keepdim = false) const;
         Tensor mean(int dim = -1, bool keepdim = false) const;
         Tensor max(int dim = -1, bool keepdim = false) const;
+        Tensor min(int dim = -1, bool keepdim = false) const;
+        Tensor prod(int dim = -1, bool keepdim = false) const;
+        /// Variance / standard deviation; `unbiased` divides by n - 1.
+        Tensor var(int dim = -1, bool unbiased = true, bool keepdim = false) const;
+        Tensor std(int dim = -1, bool unbiased = true, bool keepdim = false) const;
+
+        /// Several axes at once (an empty list reduces every axis). Any set works
+        /// up to rank 4; above that the axes must be adjacent (see reduction.hpp).
+        Tensor sum(const std::vector<int>& dims, bool keepdim = false) const;
+        Tensor mean(const std::vector<int>& dims, bool keepdim = false) const;
+        Tensor max(const std::vector<int>& dims, bool keepdim = false) const;
+        Tensor min(const std::vector<int>& dims, bool keepdim = false) const;
+        Tensor prod(const std::vector<int>& dims, bool keepdim = false) const;
+        Tensor var(const std::vector<int>& dims, bool unbiased = true, bool keepdim = false) const;
+        Tensor std(const std::vector<int>& dims, bool unbiased = true, bool keepdim = false) const;
+
+        /// Position of the max / min along `dim` as a float tensor, or its
+        /// row-major flat index when dim == -1. Never requires grad.
+        Tensor argmax(int dim = -1, bool keepdim = false) const;
+        Tensor argmin(int dim = -1, bool keepdim = false) const;
+
+        // -------- View Ops --------
+        /// Elements [start, end) with stride `step` along `dim`; negative indices
+        /// count from the end. Shares storage with this tensor.
+        Tensor slice(int dim, long start, long end, long step = 1) const;
+        /// Same elements in a new shape; copies only if this tensor is not contiguous.
+        Tensor reshape(const Shape& shape) const;
+        /// Like reshape(), but throws instead of copying a non-contiguous tensor.
+        Tensor view(const Shape& shape) const;
+        /// Reorder axes; `dims[i]` is the source axis of output axis i.
+        /// Up to rank 4 the reordered copy is deferred until a kernel reads
+        /// the data; above rank 4 it is made right away.
+        Tensor permute(const std::vector<unsigned>& dims) const;
+        Tensor transpose(int dim0 = 0, int dim1 = 1) const;
+        /// Drop size-1 axis `dim`, or every size-1 axis when dim == -1.
+        Tensor squeeze(int dim = -1) const;
+        /// Insert a size-1 axis at `dim`.
+        Tensor unsqueeze(int dim) const;
+
+        // -------- In-place Ops --------
+        /// Overwrite this tensor's data without recording a graph node; each call
+        /// bumps `version()`. Not allowed on tensors (or with operands) that
+        /// require grad while grad mode is on. `other` must broadcast to this
+        /// tensor's shape. Views are not written through to their base.
+        Tensor& add_(const Tensor& other);
+        Tensor& add_(float scalar);
+        Tensor& sub_(const Tensor& other);
+        Tensor& sub_(float scalar);
+        Tensor& mul_(const Tensor& other);
+        Tensor& mul_(float scalar);
+        Tensor& fill_(float value);
+        Tensor& zero_();
+        Tensor& clamp_(float min, float max);
+
+        /// In-place write counter (see `Function::input_data`).
+        uint64_t version() const;
 
     private:
         std::shared_ptr<TensorImpl> impl_;
@@ -75,9 +189,25 @@ namespace cppgrad {
         // -------- Internal Constructors --------
         Tensor(std::shared_ptr<TensorImpl> impl);
         Tensor(const af::array& arr, bool requires_grad = true);
+        /// `arr` must have the folded dims of `shape` (see ShapeUtils::fold).
+        Tensor(const af::array& arr, bool requires_grad, Shape shape);
 
         static af::dim4 to_dim4(const std::vector<size_t>& shape);
 
+        /// permute() above rank 4: a materialized copy.
+        Tensor permute_copy(const std::vector<unsigned>& dims) const;
+
+        /// Shared body of reshape/view/squeeze/unsqueeze.
+        Tensor reshape_to(Shape shape, bool require_contiguous) const;
+
+        /// Shared bodies of the reductions.
+        Tensor sum_over(const Reduction& r) const;
+        Tensor mean_over(const Reduction& r) const;
+        Tensor extremum_over(const Reduction& r, bool largest) const;
+        Tensor prod_over(const Reduction& r) const;
+        Tensor var_over(const Reduction& r, bool unbiased, bool take_sqrt) const;
+        Tensor arg_extremum(int dim, bool keepdim, bool largest) const;
+
         // -------- Operator Overloads --------
         friend Tensor operator+(const Tensor&, const Tensor&);
         friend Tensor operator-(const Tensor&, const Tensor&);
@@ -102,6 +232,48 @@ namespace cppgrad {
         friend Tensor pow(const Tensor& base, float scalar);
         friend Tensor pow(float scalar, const Tensor& exponent);
 
+        // -------- Activations --------
+        friend Tensor relu(const Tensor&);
+        friend Tensor sigmoid(const Tensor&);
+        friend Tensor tanh(const Tensor&);
+        friend Tensor gelu(const Tensor&);
+        friend Tensor silu(const Tensor&);
+
+        // -------- Linear Layers --------
+        friend Tensor linear(const Tensor&, const Tensor&, const Tensor&, Activation);
+        friend Tensor linear(const Tensor&, const Tensor&, Activation);
+
+        // -------- Normalization --------
+        friend Tensor layer_norm(const Tensor&, const std::vector<size_t>&, const Tensor&, const Tensor&, float);
+        friend Tensor layer_norm(const Tensor&, const std::vector<size_t>&, float);
+        friend Tensor batch_norm(const Tensor&, Tensor&, Tensor&, const Tensor&, const Tensor&,
+                                 const BatchNormOptions&);
+        friend Tensor batch_norm(const Tensor&, Tensor&, Tensor&, const BatchNormOptions&);
+
+        // -------- Embedding & Dropout --------
+        friend Tensor embedding(const Tensor&, const Tensor&);
+        friend Tensor dropout(const Tensor&, float, bool);
+
+        // -------- Softmax & Losses --------
+        friend Tensor softmax(const Tensor&, int);
+        friend Tensor log_softmax(const Tensor&, int);
+        friend Tensor logsumexp(const Tensor&, int, bool);
+        friend Tensor logsumexp(const Tensor&, const std::vector<int>&, bool);
+        friend Tensor cross_entropy(const Tensor&, const std::vector<int>&, int);
+
+        // -------- Convolution & Pooling --------
+        friend Tensor conv2d(const Tensor&, const Tensor&, const Tensor&, const Conv2dOptions&);
+        friend Tensor conv2d(const Tensor&, const Tensor&, const Conv2dOptions&);
+        friend Tensor max_pool2d(const Tensor&, size_t, size_t, size_t);
+        friend Tensor avg_pool2d(const Tensor&, size_t, size_t, size_t);
+
+        // -------- Checkpointing --------
+        friend Tensor checkpoint(const CheckpointSegment&, const std::vector<Tensor>&);
+        friend class CheckpointFunction;
+
+        // -------- Capture & Replay --------
+        friend class CapturedStep;
+
         // -------- Tensor Utilities --------
         friend class TensorUtils;
     };
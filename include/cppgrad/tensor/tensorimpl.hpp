@@ -1,9 +1,14 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <arrayfire.h>
 
 #include "cppgrad/autograd/autogradmeta.hpp"
+#include "cppgrad/tensor/shape.hpp"
 
 namespace cppgrad {
 
@@ -17,8 +22,10 @@ namespace cppgrad {
      *
      * Responsibilities:
      * - Stores the tensor data using ArrayFire (`af::array`)
+     * - Stores the logical shape, which may have more than four axes
+     *   (see shapeutils.hpp for how it is folded into ArrayFire dims)
      * - Maintains autograd metadata when `requires_grad` is true
-     *   - Gradient (`grad`)
+     *   - Gradient (`grad`), allocated lazily on first accumulation
      *   - Backward function (`grad_fn`)
      *   - Bookkeeping (`has_called_backward`)
      *
@@ -26,6 +33,13 @@ namespace cppgrad {
      * - Uses `std::unique_ptr<AutogradMeta>` to lazily allocate autograd info only when needed
      * - Supports both const and mutable access to data and gradients
      * - Gradients are computed during the backward pass and stored here
+     * - A permuted view keeps the source array plus a pending axis order; the
+     *   reordered copy is only produced when `data()` is first read
+     * - `version()` counts in-place writes; `Function` nodes compare it against the
+     *   value seen in forward before reading an input's data in backward
+     * - A lazy result (see lazymode.hpp) holds its IR node instead of data; the
+     *   node is evaluated when `data()` is first read, and its `LazyFunction` is
+     *   attached when `grad_fn()` is first asked for
      *
      * Analogy: Similar to `at::TensorImpl` in PyTorch's C++ internals.
     */
@@ -33,15 +47,50 @@ namespace cppgrad {
     class Function;
     //class AutogradMeta;
 
+    namespace lazy {
+        struct Node;
+    }
+
     class TensorImpl {
     public:
         // -------- Constructor --------
+        /// Shape is taken from the array dims (rank <= 4, trailing 1s dropped).
         TensorImpl(const af::array& d, bool requires_grad);
+        /// `d` must have the folded dims of `shape`.
+        TensorImpl(const af::array& d, Shape shape, bool requires_grad);
+        /// View of `source` with axes reordered by `perm` (as in `af::reorder`).
+        /// Materialization is deferred until `data()` is first read.
+        TensorImpl(const af::array& source, const std::array<unsigned, 4>& perm,
+                   Shape shape, bool requires_grad);
+        /// Lazy result of `node`, computed when `data()` is first read.
+        TensorImpl(std::shared_ptr<lazy::Node> node, bool requires_grad);
 
         // -------- Data Access --------
+        /// Materializes a pending permutation or lazy result before returning.
         const af::array& data() const;
         af::array& data();
 
+        /// Logical shape; any rank.
+        const Shape& shape() const;
+        /// ArrayFire dims, computed without materializing a pending permutation or lazy result.
+        af::dim4 dims() const;
+        /// False while a permutation is pending or the data is a strided sub-array.
+        bool is_contiguous() const;
+        /// If a permutation is pending, copy out its source and axis order and
+        /// return true; kernels that accept transposed operands use this to skip
+        /// materialization.
+        bool permuted_source(af::array& source, std::array<unsigned, 4>& perm) const;
+
+        /// IR node that produced this tensor inside a `LazyMode` scope, or null.
+        const std::shared_ptr<lazy::Node>& lazy_node() const;
+        /// True until a lazy result has been computed.
+        bool is_lazy() const;
+
+        /// Number of in-place writes to this tensor's data so far.
+        uint64_t version() const;
+        /// Called by in-place ops after they overwrite `data()`.
+        void bump_version();
+
         // -------- Autograd Info --------
         bool requires_grad() const;
         bool has_autograd() const;
@@ -49,6 +98,18 @@ namespace cppgrad {
         af::array& grad();
         const af::array& grad() const;
 
+        /// True once a gradient buffer has been allocated.
+        bool has_grad() const;
+        /// Add `g` into the gradient, allocating the buffer on first use.
+        /// Safe to call concurrently from several backward worker threads.
+        void accumulate_grad(const af::array& g);
+
+        /// Leaf tensors were not produced by a recorded op (no `grad_fn`).
+        bool is_leaf() const;
+        /// Whether backward should store a gradient on this tensor.
+        bool retains_grad() const;
+        void set_retains_grad(bool retains_grad);
+
         std::shared_ptr<Function>& grad_fn();
         const std::shared_ptr<Function>& grad_fn() const;
 
@@ -56,8 +117,24 @@ namespace cppgrad {
         void set_has_called_backward(bool has_called_backwards);
 
     private:
-        af::array data_;                                // Underlying ArrayFire data
+        void materialize() const;
+        /// Give a lazy result that requires grad its `LazyFunction`, once.
+        void attach_lazy_grad_fn() const;
+
+        mutable af::array data_;                        // Underlying ArrayFire data (source while permute is pending)
+        Shape shape_;                     // Logical shape (may exceed 4 axes)
         std::unique_ptr<AutogradMeta> autograd_;        // Autograd metadata (optional)
+        std::mutex grad_mutex_;                         // Guards gradient accumulation
+
+        std::array<unsigned, 4> perm_ = {0, 1, 2, 3};   // Axis order applied to data_ on materialization
+        mutable std::atomic<bool> pending_permute_{false};
+        mutable std::mutex view_mutex_;                 // Guards materialization
+
+        std::shared_ptr<lazy::Node> lazy_;              // Producing IR node of a lazy result
+        mutable std::atomic<bool> pending_lazy_{false};
+        mutable std::atomic<bool> pending_grad_fn_{false};
+
+        std::atomic<uint64_t> version_{0};              // In-place write counter
     };
 
 } // namespace cppgrad
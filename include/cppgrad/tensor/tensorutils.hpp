@@ -12,8 +12,9 @@ namespace cppgrad {
      *
      * Current responsibilities include:
      * - Cloning tensors (with and without autograd tracking)
-     * - Matrix multiplication
-     * - Transposing tensors
+     * - Matrix multiplication, batched over leading axes (see gemm.hpp)
+     * - Transposing tensors (a lazy view; `matmul` folds a pending transpose
+     *   into the GEMM call)
      *
      * Design Notes:
      * - These are stateless operations and are implemented as static methods.
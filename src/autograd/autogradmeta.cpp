@@ -2,12 +2,10 @@
 
 namespace cppgrad {
 
-    AutogradMeta::AutogradMeta(bool req, const af::array &data)
+    // The gradient buffer is left empty here; it is allocated lazily on the
+    // first call to TensorImpl::accumulate_grad().
+    AutogradMeta::AutogradMeta(bool req)
     : requires_grad(req) {
-        if (requires_grad) {
-            grad = af::constant(0, data.dims(), data.type());
-        }
         has_called_backward = false;
     }
 }
-
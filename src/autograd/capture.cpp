@@ -0,0 +1,190 @@
+#include "autograd/capture.hpp"
+#include "autograd/engine.hpp"
+#include "autograd/function.hpp"
+#include "autograd/gradmode.hpp"
+#include "tensor/tensor.hpp"
+#include "tensor/tensorimpl.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace cppgrad {
+
+    namespace {
+
+        // Tape being recorded on this thread, if any
+        thread_local Tape* recording = nullptr;
+
+        /// Points `recording` at a tape for the guard's lifetime.
+        class RecordingScope {
+            public:
+                explicit RecordingScope(Tape* tape)
+                : prev_(recording) {
+                    recording = tape;
+                }
+
+                ~RecordingScope() {
+                    recording = prev_;
+                }
+
+                RecordingScope(const RecordingScope&) = delete;
+                RecordingScope& operator=(const RecordingScope&) = delete;
+
+            private:
+                Tape* prev_;
+        };
+
+    } // namespace
+
+    //----------------Tape---------------------------
+
+    bool Tape::is_recording() {
+        return recording != nullptr;
+    }
+
+    void Tape::record(const std::shared_ptr<TensorImpl>& out,
+                      std::vector<std::shared_ptr<TensorImpl>> inputs,
+                      Kernel kernel) {
+        if (recording == nullptr) return;
+        recording->entries_.push_back({ out, std::move(inputs), std::move(kernel) });
+    }
+
+    void Tape::note_allocation() {
+        if (recording != nullptr) ++recording->allocations_;
+    }
+
+    bool Tape::produces(const TensorImpl* impl) const {
+        return std::any_of(entries_.begin(), entries_.end(),
+                           [impl](const Entry& e) { return e.output.get() == impl; });
+    }
+
+    void Tape::replay() {
+        for (Entry& entry : entries_) {
+            scratch_.clear();
+            for (const auto& input : entry.inputs) scratch_.push_back(input->data());
+            Arrays result = entry.kernel(scratch_);
+
+            entry.output->data() = result.front();
+            if (const auto& fn = entry.output->grad_fn()) {
+                fn->refresh_versions();
+                if (result.size() > 1) {
+                    fn->save_for_backward(Arrays(std::make_move_iterator(result.begin() + 1),
+                                                 std::make_move_iterator(result.end())));
+                }
+            }
+        }
+        scratch_.clear();
+    }
+
+    //----------------CapturedStep---------------------------
+
+    CapturedStep::CapturedStep(Step step)
+    : step_(std::move(step)) {
+        if (!step_) throw std::runtime_error("capture: empty step");
+    }
+
+    CapturedStep::~CapturedStep() = default;
+    CapturedStep::CapturedStep(CapturedStep&&) noexcept = default;
+    CapturedStep& CapturedStep::operator=(CapturedStep&&) noexcept = default;
+
+    Tensor CapturedStep::operator()(const std::vector<Tensor>& inputs) {
+        if (!GradMode::is_enabled()) return step_(inputs);
+        if (!tape_) return record(inputs);
+        if (replayable_ && matches(inputs)) return replay(inputs);
+        ++fallbacks_;
+        return run_eager(inputs);
+    }
+
+    void CapturedStep::reset() {
+        tape_.reset();
+        slots_.clear();
+        shapes_.clear();
+        requires_grad_.clear();
+        output_.reset();
+        replayable_ = false;
+    }
+
+    bool CapturedStep::matches(const std::vector<Tensor>& inputs) const {
+        if (inputs.size() != slots_.size()) return false;
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            if (inputs[i].shape() != shapes_[i] || inputs[i].requires_grad() != requires_grad_[i]) return false;
+        }
+        return true;
+    }
+
+    Tensor CapturedStep::record(const std::vector<Tensor>& inputs) {
+        reset();
+
+        // The tape reads its inputs from leaves it owns, so later calls can rebind them
+        std::vector<Tensor> leaves;
+        leaves.reserve(inputs.size());
+        for (const Tensor& t : inputs) {
+            slots_.push_back(std::make_shared<TensorImpl>(t.data(), t.shape(), t.requires_grad()));
+            shapes_.push_back(t.shape());
+            requires_grad_.push_back(t.requires_grad());
+            leaves.push_back(Tensor(slots_.back()));
+        }
+
+        auto tape = std::make_unique<Tape>();
+        std::shared_ptr<TensorImpl> out;
+        {
+            RecordingScope scope(tape.get());
+            out = step_(leaves).impl();
+        }
+        if (!out->requires_grad()) {
+            throw std::runtime_error("capture: the step output does not require grad");
+        }
+
+        // An incomplete tape cannot be replayed; its graph is released as in eager mode
+        replayable_ = tape->is_complete() && tape->produces(out.get());
+        if (!replayable_) tape->entries_.clear();
+        Engine::backward(out, af::array(), /*retain_graph=*/replayable_);
+        export_grads(inputs);
+
+        tape_ = std::move(tape);
+        if (replayable_) output_ = out;
+        return Tensor(out);
+    }
+
+    Tensor CapturedStep::replay(const std::vector<Tensor>& inputs) {
+        for (size_t i = 0; i < inputs.size(); ++i) slots_[i]->data() = inputs[i].data();
+        tape_->replay();
+        Engine::backward(output_, af::array(), /*retain_graph=*/true);
+        export_grads(inputs);
+        ++replays_;
+        return Tensor(output_);
+    }
+
+    Tensor CapturedStep::run_eager(const std::vector<Tensor>& inputs) {
+        Tensor out = step_(inputs);
+        out.backward();
+        return out;
+    }
+
+    void CapturedStep::export_grads(const std::vector<Tensor>& inputs) {
+        // Inputs computed by an upstream graph pass their gradient on through it
+        size_t upstream = 0;
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            if (slots_[i]->has_grad() && inputs[i].impl()->grad_fn()) ++upstream;
+        }
+
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            TensorImpl& slot = *slots_[i];
+            if (!slot.requires_grad() || !slot.has_grad()) continue;
+            const std::shared_ptr<TensorImpl>& input = inputs[i].impl();
+            if (input->grad_fn()) {
+                // Upstream graphs may share nodes, so only the last pass releases them
+                Engine::backward(input, slot.grad(), /*retain_graph=*/--upstream > 0);
+            } else {
+                input->accumulate_grad(slot.grad());
+            }
+            slot.grad() = af::array();
+        }
+    }
+
+    CapturedStep capture(CapturedStep::Step step) {
+        return CapturedStep(std::move(step));
+    }
+
+}
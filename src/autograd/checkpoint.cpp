@@ -0,0 +1,40 @@
+#include "autograd/checkpoint.hpp"
+#include "autograd/function.hpp"
+#include "autograd/gradmode.hpp"
+#include "tensor/tensor.hpp"
+
+#include <stdexcept>
+
+namespace cppgrad {
+
+    Tensor checkpoint(const CheckpointSegment& segment, const std::vector<Tensor>& inputs) {
+        if (!segment) throw std::runtime_error("checkpoint: empty segment");
+        if (!GradMode::is_enabled()) return segment(inputs);
+
+        // Pin the RNG stream so the recomputation draws the same numbers
+        const unsigned long long seed = CheckpointFunction::fresh_seed();
+        af::setSeed(seed);
+
+        Tensor result = [&] {
+            NoGradGuard no_grad;
+            return segment(inputs);
+        }();
+
+        // New impl, so the node never attaches to a tensor the segment returned as is
+        auto impl = std::make_shared<TensorImpl>(result.data(), result.shape(), true);
+        auto fn = std::make_shared<CheckpointFunction>(segment, seed);
+        std::vector<std::shared_ptr<TensorImpl>> impls;
+        impls.reserve(inputs.size());
+        for (const Tensor& t : inputs) impls.push_back(t.impl_);
+        fn->set_inputs(std::move(impls));
+        impl->grad_fn() = fn;
+
+        return Tensor(impl);
+    }
+
+    Tensor checkpoint(const std::function<Tensor(const Tensor&)>& segment, const Tensor& input) {
+        if (!segment) throw std::runtime_error("checkpoint: empty segment");
+        return checkpoint([segment](const std::vector<Tensor>& in) { return segment(in[0]); }, { input });
+    }
+
+}
@@ -0,0 +1,319 @@
+#include "autograd/engine.hpp"
+#include "autograd/function.hpp"
+#include "tensor/tensorimpl.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+namespace cppgrad {
+
+    // ----------------------------------------
+    // Worker pool
+    // ----------------------------------------
+
+    // Set on pool threads so that a backward started from inside a node
+    // (e.g. re-entrant graphs) runs inline instead of waiting on its own pool.
+    static thread_local bool in_worker_thread = false;
+
+    /// Fixed-size pool of threads pulling jobs from a shared FIFO.
+    class WorkerPool {
+        public:
+            explicit WorkerPool(size_t num_threads) {
+                for (size_t i = 0; i < num_threads; ++i) {
+                    threads_.emplace_back([this] { run(); });
+                }
+            }
+
+            ~WorkerPool() {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    stop_ = true;
+                }
+                cv_.notify_all();
+                for (auto& t : threads_) t.join();
+            }
+
+            void submit(std::function<void()> job) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    jobs_.push(std::move(job));
+                }
+                cv_.notify_one();
+            }
+
+        private:
+            void run() {
+                in_worker_thread = true;
+                while (true) {
+                    std::function<void()> job;
+                    {
+                        std::unique_lock<std::mutex> lock(mutex_);
+                        cv_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+                        if (stop_ && jobs_.empty()) return;
+                        job = std::move(jobs_.front());
+                        jobs_.pop();
+                    }
+                    job();
+                }
+            }
+
+            std::vector<std::thread> threads_;
+            std::queue<std::function<void()>> jobs_;
+            std::mutex mutex_;
+            std::condition_variable cv_;
+            bool stop_ = false;
+    };
+
+    // ----------------------------------------
+    // Configuration
+    // ----------------------------------------
+
+    static std::mutex config_mutex;
+    static size_t configured_threads = 1;
+    static bool deterministic_mode = false;
+    static std::shared_ptr<WorkerPool> worker_pool;
+
+    void Engine::set_num_threads(size_t num_threads) {
+        std::lock_guard<std::mutex> lock(config_mutex);
+        configured_threads = std::max<size_t>(1, num_threads);
+        worker_pool.reset();  // rebuilt lazily with the new size
+    }
+
+    size_t Engine::num_threads() {
+        std::lock_guard<std::mutex> lock(config_mutex);
+        return configured_threads;
+    }
+
+    void Engine::set_deterministic(bool deterministic) {
+        std::lock_guard<std::mutex> lock(config_mutex);
+        deterministic_mode = deterministic;
+    }
+
+    bool Engine::is_deterministic() {
+        std::lock_guard<std::mutex> lock(config_mutex);
+        return deterministic_mode;
+    }
+
+    // Returns the pool to use for this pass, or nullptr to run serially.
+    static std::shared_ptr<WorkerPool> acquire_pool() {
+        if (in_worker_thread) return nullptr;
+
+        std::lock_guard<std::mutex> lock(config_mutex);
+        if (deterministic_mode || configured_threads <= 1) return nullptr;
+        if (!worker_pool) worker_pool = std::make_shared<WorkerPool>(configured_threads);
+        return worker_pool;
+    }
+
+    // ----------------------------------------
+    // Graph traversal
+    // ----------------------------------------
+
+    static void check_not_released(const Function& fn) {
+        if (fn.is_released()) {
+            throw std::runtime_error(
+                "Trying to backward through the graph a second time: its saved tensors were "
+                "freed by the previous backward. Pass retain_graph=true to the first call."
+            );
+        }
+    }
+
+    /// State shared by every node of one backward pass.
+    struct GraphTask {
+        std::unordered_map<Function*, size_t> deps;         // pending incoming edges
+        std::unordered_map<Function*, af::array> buffers;   // summed incoming grads
+        std::vector<std::shared_ptr<Function>> nodes;       // keep-alive for the pass
+        bool retain_graph = false;
+
+        // Only used by the parallel executor
+        std::mutex mutex;
+        std::condition_variable done;
+        size_t outstanding = 0;
+        std::exception_ptr error;
+    };
+
+    // Count, for every Function reachable from `root`, the number of gradient
+    // edges that point at it. An edge exists for every input slot that requires
+    // grad and was produced by another Function. Every visited node is also kept
+    // alive in `task.nodes`, since releasing inputs may drop the last owning reference.
+    static void compute_dependencies(const std::shared_ptr<Function>& root, GraphTask& task) {
+        std::queue<Function*> queue;
+
+        check_not_released(*root);
+        task.deps[root.get()] = 0;
+        task.nodes.push_back(root);
+        queue.push(root.get());
+
+        while (!queue.empty()) {
+            Function* fn = queue.front();
+            queue.pop();
+
+            for (const auto& input : fn->inputs) {
+                if (!input || !input->requires_grad() || !input->grad_fn()) continue;
+
+                Function* next = input->grad_fn().get();
+                auto [it, inserted] = task.deps.try_emplace(next, 0);
+                ++it->second;
+                if (inserted) {
+                    check_not_released(*next);
+                    task.nodes.push_back(input->grad_fn());
+                    queue.push(next);
+                }
+            }
+        }
+    }
+
+    // Apply `fn` to the gradient accumulated for it. A node whose consumers all
+    // produced empty gradients has no buffer and yields no gradients, but is still
+    // drained so that the dependency counts of its producers reach zero.
+    static std::vector<af::array> take_and_apply(GraphTask& task, Function* fn,
+                                                 std::unique_lock<std::mutex>* lock) {
+        af::array grad_in;
+        auto buf = task.buffers.find(fn);
+        if (buf == task.buffers.end()) return {};
+        grad_in = std::move(buf->second);
+        task.buffers.erase(buf);
+
+        if (lock) lock->unlock();
+        std::vector<af::array> grads = fn->apply(grad_in);
+        if (lock) {
+            // Force evaluation here so the work happens on this worker thread
+            // instead of in whichever thread first touches the lazy JIT tree.
+            for (auto& g : grads) {
+                if (!g.isempty()) g.eval();
+            }
+            lock->lock();
+        }
+        return grads;
+    }
+
+    // Route the gradients produced by `fn` to leaves and producer nodes.
+    // Returns the producers whose dependency count dropped to zero.
+    static std::vector<Function*> dispatch(GraphTask& task, Function* fn,
+                                           const std::vector<af::array>& grads) {
+        std::vector<Function*> ready;
+
+        for (size_t i = 0; i < fn->inputs.size(); ++i) {
+            const auto& input = fn->inputs[i];
+            if (!input || !input->requires_grad()) continue;
+
+            const bool has_grad = i < grads.size() && !grads[i].isempty();
+
+            // Only leaves (and tensors that asked via retain_grad) keep a gradient
+            if (has_grad && input->retains_grad()) {
+                input->accumulate_grad(grads[i]);
+            }
+
+            if (!input->grad_fn()) continue;
+
+            Function* next = input->grad_fn().get();
+            if (has_grad) {
+                auto it = task.buffers.find(next);
+                if (it == task.buffers.end()) task.buffers.emplace(next, grads[i]);
+                else it->second += grads[i];
+            }
+
+            if (--task.deps[next] == 0) ready.push_back(next);
+        }
+        return ready;
+    }
+
+    // Single-threaded executor: FIFO over the ready queue, fully deterministic.
+    static void execute_serial(GraphTask& task, Function* root_fn) {
+        std::queue<Function*> ready;
+        ready.push(root_fn);
+
+        while (!ready.empty()) {
+            Function* fn = ready.front();
+            ready.pop();
+
+            std::vector<af::array> grads = take_and_apply(task, fn, nullptr);
+            for (Function* next : dispatch(task, fn, grads)) ready.push(next);
+
+            // Saved tensors are no longer needed once the node has run
+            if (!task.retain_graph) fn->release();
+        }
+    }
+
+    // Run one node on a pool thread and schedule the producers it unblocks.
+    // `pool` is borrowed: the thread that started the pass owns it until every
+    // node has finished.
+    static void run_node(const std::shared_ptr<GraphTask>& task, WorkerPool* pool,
+                         Function* fn) {
+        std::vector<Function*> ready;
+        {
+            std::unique_lock<std::mutex> lock(task->mutex);
+            if (!task->error) {
+                try {
+                    std::vector<af::array> grads = take_and_apply(*task, fn, &lock);
+                    ready = dispatch(*task, fn, grads);
+                } catch (...) {
+                    if (!lock.owns_lock()) lock.lock();
+                    if (!task->error) task->error = std::current_exception();
+                }
+            }
+            task->outstanding += ready.size();
+        }
+
+        if (!task->retain_graph) fn->release();
+
+        for (Function* next : ready) {
+            pool->submit([task, pool, next] { run_node(task, pool, next); });
+        }
+
+        std::lock_guard<std::mutex> lock(task->mutex);
+        if (--task->outstanding == 0) task->done.notify_all();
+    }
+
+    // Multi-threaded executor: ready nodes are handed to the worker pool, so
+    // independent branches of the graph are applied concurrently.
+    static void execute_parallel(const std::shared_ptr<GraphTask>& task, Function* root_fn,
+                                 const std::shared_ptr<WorkerPool>& pool) {
+        {
+            std::lock_guard<std::mutex> lock(task->mutex);
+            task->outstanding = 1;
+        }
+        WorkerPool* workers = pool.get();
+        workers->submit([task, workers, root_fn] { run_node(task, workers, root_fn); });
+
+        std::unique_lock<std::mutex> lock(task->mutex);
+        task->done.wait(lock, [&] { return task->outstanding == 0; });
+        if (task->error) std::rethrow_exception(task->error);
+    }
+
+    void Engine::backward(const std::shared_ptr<TensorImpl>& root,
+                          const af::array& grad_output,
+                          bool retain_graph) {
+        // Seed gradient = 1 for all elements unless the caller supplied one
+        af::array seed = grad_output.isempty()
+            ? af::constant(1.0f, root->data().dims(), root->data().type())
+            : grad_output;
+
+        if (!root->grad_fn()) {
+            if (root->retains_grad()) root->accumulate_grad(seed);
+            return;
+        }
+
+        auto task = std::make_shared<GraphTask>();
+        task->retain_graph = retain_graph;
+        compute_dependencies(root->grad_fn(), *task);
+
+        if (root->retains_grad()) root->accumulate_grad(seed);
+
+        Function* root_fn = root->grad_fn().get();
+        task->buffers[root_fn] = seed;
+
+        if (auto pool = acquire_pool()) {
+            execute_parallel(task, root_fn, pool);
+        } else {
+            execute_serial(*task, root_fn);
+        }
+    }
+
+}
@@ -1,26 +1,78 @@
 #include "autograd/function.hpp"
+#include "autograd/engine.hpp"
+#include "autograd/gradmode.hpp"
+#include "lazy/passes.hpp"
+#include "tensor/broadcast.hpp"
+#include "tensor/gemm.hpp"
+#include "tensor/imagelayout.hpp"
+#include "tensor/shapeutils.hpp"
+#include "tensor/tensor.hpp"
 #include "tensor/tensorimpl.hpp"
 
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
 namespace cppgrad {
 
+    //----------------Base---------------------------
+    void Function::set_inputs(std::vector<std::shared_ptr<TensorImpl>> tensors) {
+        inputs = std::move(tensors);
+        refresh_versions();
+    }
+
+    void Function::refresh_versions() {
+        input_versions_.resize(inputs.size());
+        for (size_t i = 0; i < inputs.size(); ++i) input_versions_[i] = inputs[i]->version();
+    }
+
+    const af::array& Function::input_data(size_t i) const {
+        return checked_input(i).data();
+    }
+
+    const TensorImpl& Function::checked_input(size_t i) const {
+        const uint64_t current = inputs[i]->version();
+        if (i < input_versions_.size() && current != input_versions_[i]) {
+            throw std::runtime_error(
+                "Input " + std::to_string(i) + " of " + name() +
+                " was modified by an in-place operation after the forward pass "
+                "(version " + std::to_string(input_versions_[i]) + ", now " +
+                std::to_string(current) + ")");
+        }
+        return *inputs[i];
+    }
+
+    void Function::save_for_backward(std::vector<af::array> arrays) {
+        for (auto& arr : arrays) arr.eval();
+        saved_ = std::move(arrays);
+    }
+
+    void Function::release() {
+        inputs.clear();
+        inputs.shrink_to_fit();
+        input_versions_.clear();
+        saved_.clear();
+        saved_.shrink_to_fit();
+        released_ = true;
+    }
+
     //----------------Add---------------------------
-    void AddFunction::apply(const af::array &grad_output) {
+    std::vector<af::array> AddFunction::apply(const af::array &grad_output) {
         this->mark_visited();
-        if (inputs[0]->requires_grad()) {
-            inputs[0]->grad() += grad_output;
+        std::vector<af::array> grads(2);
 
-            if (inputs[0]->grad_fn()) {
-                inputs[0]->grad_fn()->apply(grad_output);
-            }
-        }
+        // Sum over broadcast dims to recover each input's shape
+        const auto& a_shape = inputs[0]->shape();
+        const auto& b_shape = inputs[1]->shape();
+        const auto out_shape = Broadcast::result_shape(a_shape, b_shape);
 
-        if (inputs[1]->requires_grad()) {
-            inputs[1]->grad() += grad_output;
+        if (inputs[0]->requires_grad())
+            grads[0] = Broadcast::reduce_to(grad_output, out_shape, a_shape);
 
-            if (inputs[1]->grad_fn()) {
-                inputs[1]->grad_fn()->apply(grad_output);
-            }
-        }
+        if (inputs[1]->requires_grad())
+            grads[1] = Broadcast::reduce_to(grad_output, out_shape, b_shape);
+
+        return grads;
     }
 
     std::string AddFunction::name() const {
@@ -28,24 +80,21 @@ namespace cppgrad {
     }
 
     //----------------Sub---------------------------
-    void SubFunction::apply(const af::array& grad_output) {
+    std::vector<af::array> SubFunction::apply(const af::array& grad_output) {
         this->mark_visited();
+        std::vector<af::array> grads(2);
 
-        if (inputs[0]->requires_grad()) {
-            inputs[0]->grad() += grad_output;
+        const auto& a_shape = inputs[0]->shape();
+        const auto& b_shape = inputs[1]->shape();
+        const auto out_shape = Broadcast::result_shape(a_shape, b_shape);
 
-            if (inputs[0]->grad_fn()) {
-                inputs[0]->grad_fn()->apply(grad_output);
-            }
-        }
+        if (inputs[0]->requires_grad())
+            grads[0] = Broadcast::reduce_to(grad_output, out_shape, a_shape);
 
-        if (inputs[1]->requires_grad()) {
-            inputs[1]->grad() += -grad_output;
+        if (inputs[1]->requires_grad())
+            grads[1] = Broadcast::reduce_to(-grad_output, out_shape, b_shape);
 
-            if (inputs[1]->grad_fn()) {
-                inputs[1]->grad_fn()->apply(-grad_output);
-            }
-        }
+        return grads;
     }
 
     std::string SubFunction::name() const {
@@ -53,27 +102,27 @@ namespace cppgrad {
     }
 
     //----------------Mul---------------------------
-    void MulFunction::apply(const af::array& grad_output) {
+    std::vector<af::array> MulFunction::apply(const af::array& grad_output) {
         this->mark_visited();
+        std::vector<af::array> grads(2);
         // for z = a * b, ∂z/∂a = b, ∂z/∂b = a
-        auto a = inputs[0]->data();
-        auto b = inputs[1]->data();
+        const af::array& a = input_data(0);
+        const af::array& b = input_data(1);
+        const auto& a_shape = inputs[0]->shape();
+        const auto& b_shape = inputs[1]->shape();
+        const auto out_shape = Broadcast::result_shape(a_shape, b_shape);
 
         // ∂L/∂a = grad_out * b
-        if (inputs[0]->requires_grad()) {
-            af::array grad_a = grad_output * b;
-            inputs[0]->grad() += grad_a;
-            if (inputs[0]->grad_fn())
-                inputs[0]->grad_fn()->apply(grad_a);
-        }
+        if (inputs[0]->requires_grad())
+            grads[0] = Broadcast::reduce_to(grad_output * Broadcast::expand(b, b_shape, out_shape),
+                                            out_shape, a_shape);
 
-        if (inputs[1]->requires_grad()) {
-            // ∂L/∂b = grad_out * a
-            af::array grad_b = grad_output * a;
-            inputs[1]->grad() += grad_b;
-            if (inputs[1]->grad_fn())
-                inputs[1]->grad_fn()->apply(grad_b);
-        }
+        // ∂L/∂b = grad_out * a
+        if (inputs[1]->requires_grad())
+            grads[1] = Broadcast::reduce_to(grad_output * Broadcast::expand(a, a_shape, out_shape),
+                                            out_shape, b_shape);
+
+        return grads;
     }
 
     std::string MulFunction::name() const {
@@ -82,39 +131,146 @@ namespace cppgrad {
 
     //----------------Div---------------------------
 
-    void DivFunction::apply(const af::array& grad_output) {
+    std::vector<af::array> DivFunction::apply(const af::array& grad_output) {
         this->mark_visited();
+        std::vector<af::array> grads(2);
 
-        const af::array& a = inputs[0]->data();  // numerator
-        const af::array& b = inputs[1]->data();  // denominator
+        const auto& a_shape = inputs[0]->shape();
+        const auto& b_shape = inputs[1]->shape();
+        const auto out_shape = Broadcast::result_shape(a_shape, b_shape);
 
-        if (inputs[0]->requires_grad()) {
-            af::array grad_a = grad_output / b;  // ∂(a / b) / ∂a = 1 / b
-            inputs[0]->grad() += grad_a;
+        const af::array& out = saved_tensors()[1];     // a / b
+        const af::array inv_b = Broadcast::expand(saved_tensors()[0], b_shape, out_shape);   // 1 / b
 
-            if (inputs[0]->grad_fn()) {
-                inputs[0]->grad_fn()->apply(grad_a);
-            }
-        }
+        // ∂(a / b) / ∂a = 1 / b
+        if (inputs[0]->requires_grad())
+            grads[0] = Broadcast::reduce_to(grad_output * inv_b, out_shape, a_shape);
 
-        if (inputs[1]->requires_grad()) {
-            af::array grad_b = -grad_output * a / (b * b);  // ∂(a / b) / ∂b = -a / b²
-            inputs[1]->grad() += grad_b;
+        // ∂(a / b) / ∂b = -a / b² = -(a / b) / b
+        if (inputs[1]->requires_grad())
+            grads[1] = Broadcast::reduce_to(-grad_output * out * inv_b, out_shape, b_shape);
 
-            if (inputs[1]->grad_fn()) {
-                inputs[1]->grad_fn()->apply(grad_b);
-            }
-        }
+        return grads;
     }
 
     std::string DivFunction::name() const {
         return "Div";
     }
 
+    //----------------AddScalar---------------------------
+    std::vector<af::array> AddScalarFunction::apply(const af::array& grad_output) {
+        this->mark_visited();
+        std::vector<af::array> grads(1);
+
+        if (inputs[0]->requires_grad())
+            grads[0] = grad_output;
+
+        return grads;
+    }
+
+    std::string AddScalarFunction::name() const {
+        return "AddScalar";
+    }
+
+    //----------------MulScalar---------------------------
+    MulScalarFunction::MulScalarFunction(float scalar)
+    : scalar_(scalar) {}
+
+    std::vector<af::array> MulScalarFunction::apply(const af::array& grad_output) {
+        this->mark_visited();
+        std::vector<af::array> grads(1);
+
+        if (inputs[0]->requires_grad())
+            grads[0] = grad_output * scalar_;
+
+        return grads;
+    }
+
+    std::string MulScalarFunction::name() const {
+        return "MulScalar";
+    }
+
+    //----------------RSubScalar---------------------------
+    std::vector<af::array> RSubScalarFunction::apply(const af::array& grad_output) {
+        this->mark_visited();
+        std::vector<af::array> grads(1);
+
+        if (inputs[0]->requires_grad())
+            grads[0] = -grad_output;
+
+        return grads;
+    }
+
+    std::string RSubScalarFunction::name() const {
+        return "RSubScalar";
+    }
+
+    //----------------RDivScalar---------------------------
+    RDivScalarFunction::RDivScalarFunction(float scalar)
+    : scalar_(scalar) {}
+
+    std::vector<af::array> RDivScalarFunction::apply(const af::array& grad_output) {
+        this->mark_visited();
+        std::vector<af::array> grads(1);
+
+        if (!inputs[0]->requires_grad()) return grads;
+
+        // ∂(s / x) / ∂x = -s / x² = -(s / x)² / s
+        if (scalar_ == 0.0f) {
+            grads[0] = grad_output * 0.0f;
+        } else {
+            const af::array& out = saved_tensors()[0];
+            grads[0] = -grad_output * out * out * (1.0f / scalar_);
+        }
+        return grads;
+    }
+
+    std::string RDivScalarFunction::name() const {
+        return "RDivScalar";
+    }
+
+    //----------------PowScalar---------------------------
+    PowScalarFunction::PowScalarFunction(float exponent)
+    : exponent_(exponent) {}
+
+    std::vector<af::array> PowScalarFunction::apply(const af::array& grad_output) {
+        this->mark_visited();
+        std::vector<af::array> grads(1);
+
+        if (inputs[0]->requires_grad()) {
+            const af::array& base = input_data(0);
+            grads[0] = exponent_ * af::pow(base, exponent_ - 1.0f) * grad_output;
+        }
+        return grads;
+    }
+
+    std::string PowScalarFunction::name() const {
+        return "PowScalar";
+    }
+
+    //----------------RPowScalar---------------------------
+    RPowScalarFunction::RPowScalarFunction(float base)
+    : base_(base) {}
+
+    std::vector<af::array> RPowScalarFunction::apply(const af::array& grad_output) {
+        this->mark_visited();
+        std::vector<af::array> grads(1);
+
+        // ∂(s ^ x) / ∂x = s ^ x * ln(s), with ln(s) folded on the host
+        if (inputs[0]->requires_grad())
+            grads[0] = saved_tensors()[0] * std::log(base_) * grad_output;
+
+        return grads;
+    }
+
+    std::string RPowScalarFunction::name() const {
+        return "RPowScalar";
+    }
+
     //----------------Clone---------------------------
-    void CloneFunction::apply(const af::array &grad_output) {
+    std::vector<af::array> CloneFunction::apply(const af::array &grad_output) {
         this->mark_visited();
-        inputs[0]->grad() = grad_output.copy();
+        return { grad_output.copy() };
     }
 
     std::string CloneFunction::name() const {
@@ -122,65 +278,474 @@ namespace cppgrad {
     }
 
     //----------------Matmul---------------------------
-    void MatMulFunction::apply(const af::array& grad_output) {
+    std::vector<af::array> MatMulFunction::apply(const af::array& grad_output) {
         this->mark_visited();
-        // inputs[0] = a, inputs[1] = b
-        const af::array& a = inputs[0]->data();   // shape: (M × K)
-        const af::array& b = inputs[1]->data();   // shape: (K × N)
-
-        // ∂L/∂a = grad_output @ bᵀ  ==> shape: (M × N) @ (N × K) = (M × K)
-        if (inputs[0]->requires_grad()) {
-            af::array grad_a = af::matmul(grad_output, af::transpose(b));
-            inputs[0]->grad() += grad_a;
-            if (inputs[0]->grad_fn())
-                inputs[0]->grad_fn()->apply(grad_a);
+        std::vector<af::array> grads(2);
+        // inputs[0] = a (M × K), inputs[1] = b (K × N), optionally with batch axes.
+        // ∂L/∂a = grad_output @ bᵀ and ∂L/∂b = aᵀ @ grad_output; the transposes are
+        // GEMM flags, never materialized.
+        const Shape& a_shape = inputs[0]->shape();
+        const Shape& b_shape = inputs[1]->shape();
+        const bool need_a = inputs[0]->requires_grad();
+        const bool need_b = inputs[1]->requires_grad();
+
+        if (a_shape.size() <= 2 && b_shape.size() <= 2) {
+            af_mat_prop a_prop, b_prop;
+            af::array a = Gemm::operand(checked_input(0), a_prop);
+            af::array b = Gemm::operand(checked_input(1), b_prop);
+            if (need_a) grads[0] = af::matmul(grad_output, b, AF_MAT_NONE, Gemm::flip(b_prop));
+            if (need_b) grads[1] = af::matmul(a, grad_output, Gemm::flip(a_prop), AF_MAT_NONE);
+        } else if (b_shape.size() == 2) {
+            // Batch axes of a were folded into the rows of a single GEMM
+            af_mat_prop b_prop;
+            af::array b = Gemm::operand(checked_input(1), b_prop);
+            const dim_t rows = Gemm::batch_count(a_shape) * static_cast<dim_t>(a_shape[a_shape.size() - 2]);
+            af::array g = af::moddims(grad_output, rows, static_cast<dim_t>(b_shape.back()));
+            if (need_a) {
+                grads[0] = af::moddims(af::matmul(g, b, AF_MAT_NONE, Gemm::flip(b_prop)),
+                                       ShapeUtils::fold(a_shape));
+            }
+            if (need_b) {
+                af::array a = af::moddims(input_data(0), rows, static_cast<dim_t>(a_shape.back()));
+                grads[1] = af::matmul(a, g, AF_MAT_TRANS, AF_MAT_NONE);
+            }
+        } else {
+            Shape out_shape = b_shape;
+            out_shape[out_shape.size() - 2] = a_shape[a_shape.size() - 2];
+            const bool shared_a = a_shape.size() == 2;
+            const dim_t batch = Gemm::batch_count(b_shape);
+
+            af::array g = Gemm::to_batched(grad_output, out_shape);
+            if (need_a) {
+                af::array b = Gemm::to_batched(input_data(1), b_shape);
+                af::array ga = af::matmul(g, b, AF_MAT_NONE, AF_MAT_TRANS);
+                // A 2D a was used by every batch entry: sum its contributions
+                grads[0] = shared_a ? af::sum(ga, 2) : Gemm::from_batched(ga, a_shape);
+            }
+            if (need_b) {
+                af::array a = shared_a
+                    ? af::tile(input_data(0), 1, 1, static_cast<unsigned>(batch))
+                    : Gemm::to_batched(input_data(0), a_shape);
+                grads[1] = Gemm::from_batched(af::matmul(a, g, AF_MAT_TRANS, AF_MAT_NONE), b_shape);
+            }
         }
 
-        // ∂L/∂b = aᵀ @ grad_output  ==> shape: (K × M) @ (M × N) = (K × N)
-        if (inputs[1]->requires_grad()) {
-            af::array grad_b = af::matmul(af::transpose(a), grad_output);
-            inputs[1]->grad() += grad_b;
-            if (inputs[1]->grad_fn())
-                inputs[1]->grad_fn()->apply(grad_b);
-        }
+        return grads;
     }
 
     std::string MatMulFunction::name() const {
         return "MatMul";
     }
 
-    //----------------Neg---------------------------
-    void NegFunction::apply(const af::array& grad_output) {
+    //----------------Linear---------------------------
+    LinearFunction::LinearFunction(Activation activation)
+    : activation_(activation) {}
+
+    std::vector<af::array> LinearFunction::apply(const af::array& grad_output) {
         this->mark_visited();
+        std::vector<af::array> grads(inputs.size());
+
+        const Shape& x_shape = inputs[0]->shape();
+        const Shape& w_shape = inputs[1]->shape();
+        const dim_t in = static_cast<dim_t>(w_shape[1]);
+        const dim_t out = static_cast<dim_t>(w_shape[0]);
+        const dim_t rows = static_cast<dim_t>(ShapeUtils::numel(x_shape)) / in;
+
+        // Gradient w.r.t. the pre-activation, as (rows × out)
+        af::array g = af::moddims(grad_output, rows, out);
+        if (activation_ != Activation::None) {
+            af::array y = af::moddims(saved_tensors()[0], rows, out);
+            switch (activation_) {
+                case Activation::Relu:    g = g * (y > 0.0f); break;
+                case Activation::Sigmoid: g = g * y * (1.0f - y); break;
+                case Activation::Tanh:    g = g * (1.0f - y * y); break;
+                case Activation::None:    break;
+            }
+        }
 
+        // ∂L/∂x = g @ W, ∂L/∂W = gᵀ @ x, ∂L/∂b = Σ_rows g
         if (inputs[0]->requires_grad()) {
-            inputs[0]->grad() += -grad_output;
+            af_mat_prop w_prop;
+            af::array w = Gemm::operand(checked_input(1), w_prop);
+            grads[0] = af::moddims(af::matmul(g, w, AF_MAT_NONE, w_prop), ShapeUtils::fold(x_shape));
+        }
+        if (inputs[1]->requires_grad()) {
+            af::array x = af::moddims(input_data(0), rows, in);
+            grads[1] = af::matmul(g, x, AF_MAT_TRANS, AF_MAT_NONE);
+        }
+        if (inputs.size() > 2 && inputs[2]->requires_grad()) {
+            grads[2] = af::moddims(af::sum(g, 0), out);
+        }
+
+        return grads;
+    }
+
+    std::string LinearFunction::name() const {
+        return "Linear";
+    }
 
-            if (inputs[0]->grad_fn()) {
-                inputs[0]->grad_fn()->apply(-grad_output);
+    //----------------Conv2d---------------------------
+    Conv2dFunction::Conv2dFunction(const Conv2dOptions& options)
+    : options_(options) {}
+
+    std::vector<af::array> Conv2dFunction::apply(const af::array& grad_output) {
+        this->mark_visited();
+        std::vector<af::array> grads(inputs.size());
+
+        const Shape& x_shape = inputs[0]->shape();
+        const Shape& w_shape = inputs[1]->shape();
+        const dim_t N = x_shape[0], C = x_shape[1], H = x_shape[2], W = x_shape[3];
+        const dim_t F = w_shape[0], Cg = w_shape[1], KH = w_shape[2], KW = w_shape[3];
+        const dim_t groups = options_.groups, Fg = F / groups;
+        const dim_t s = options_.stride, p = options_.padding, d = options_.dilation;
+        const bool im2col = options_.algorithm == ConvAlgorithm::Im2col;
+        const bool need_x = inputs[0]->requires_grad();
+        const bool need_w = inputs[1]->requires_grad();
+
+        af::array gy = ImageLayout::to_image(grad_output);  // (OH, OW, F, N)
+        af::array filter = ImageLayout::to_filter(input_data(1));
+        af::array image = im2col ? af::array() : ImageLayout::to_image(input_data(0));
+        af::array dimage = need_x && groups > 1 ? af::constant(0, af::dim4(H, W, C, N)) : af::array();
+        af::array dfilter = need_w && groups > 1 ? af::constant(0, af::dim4(KH, KW, Cg, F)) : af::array();
+
+        for (dim_t g = 0; g < groups; ++g) {
+            af::array gy_g = ImageLayout::group(gy, 2, g, Fg);
+            af::array f_g = ImageLayout::group(filter, 3, g, Fg);
+            if (im2col) {
+                // y = Wmat @ cols ⇒ ∂cols = Wmatᵀ @ gy, ∂Wmat = gy @ colsᵀ
+                af::array gmat = ImageLayout::to_gemm(gy_g);
+                if (need_x) {
+                    af::array dcols = af::matmul(ImageLayout::filter_matrix(f_g), gmat, AF_MAT_TRANS, AF_MAT_NONE);
+                    ImageLayout::assign_group(dimage, 2, g, Cg,
+                        ImageLayout::col2im(dcols, af::dim4(H, W, Cg, N), KH, KW, s, p));
+                }
+                if (need_w) {
+                    af::array dmat = af::matmul(gmat, saved_tensors()[g], AF_MAT_NONE, AF_MAT_TRANS);
+                    ImageLayout::assign_group(dfilter, 3, g, Fg,
+                        ImageLayout::from_filter_matrix(dmat, af::dim4(KH, KW, Cg, Fg)));
+                }
+            } else {
+                // Forward ran on the flipped filter, so its filter gradient is flipped back
+                af::array x_g = ImageLayout::group(image, 2, g, Cg);
+                af::array y_g = ImageLayout::group(saved_tensors()[0], 2, g, Fg);
+                af::array flipped = ImageLayout::flip_filter(f_g);
+                if (need_x) {
+                    ImageLayout::assign_group(dimage, 2, g, Cg, af::convolve2GradientNN(
+                        gy_g, x_g, flipped, y_g, af::dim4(s, s), af::dim4(p, p), af::dim4(d, d), AF_CONV_GRADIENT_DATA));
+                }
+                if (need_w) {
+                    ImageLayout::assign_group(dfilter, 3, g, Fg, ImageLayout::flip_filter(af::convolve2GradientNN(
+                        gy_g, x_g, flipped, y_g, af::dim4(s, s), af::dim4(p, p), af::dim4(d, d), AF_CONV_GRADIENT_FILTER)));
+                }
             }
         }
+
+        if (need_x) grads[0] = ImageLayout::from_image(dimage);
+        if (need_w) grads[1] = ImageLayout::from_filter(dfilter);
+        if (inputs.size() > 2 && inputs[2]->requires_grad()) {
+            grads[2] = af::moddims(af::sum(af::sum(af::sum(gy, 0), 1), 3), F);
+        }
+
+        return grads;
     }
 
-    std::string NegFunction::name() const {
-        return "Neg";
+    std::string Conv2dFunction::name() const {
+        return "Conv2d";
     }
 
-    //----------------Exp---------------------------
-    void ExpFunction::apply(const af::array& grad_output) {
+    //----------------MaxPool2d---------------------------
+    MaxPool2dFunction::MaxPool2dFunction(const Shape& input_shape, size_t kernel, size_t stride, size_t padding)
+    : input_shape_(input_shape), kernel_(kernel), stride_(stride), padding_(padding) {}
+
+    std::vector<af::array> MaxPool2dFunction::apply(const af::array& grad_output) {
         this->mark_visited();
+        std::vector<af::array> grads(1);
 
-        const af::array& a = inputs[0]->data();
-        af::array exp_a = af::exp(a);
+        if (inputs[0]->requires_grad()) {
+            const dim_t H = input_shape_[2], W = input_shape_[3];
+            const dim_t k = kernel_, p = padding_;
+            const af::array& indices = saved_tensors()[0];  // (1, L, C, N)
+            const af::dim4 d = indices.dims();
+
+            // One-hot mask of the argmax row in every unwrapped window
+            af::array mask = af::iota(af::dim4(k * k), af::dim4(1, d[1], d[2], d[3]), u32) ==
+                             af::tile(indices, static_cast<unsigned>(k * k));
+            af::array g = af::moddims(ImageLayout::to_image(grad_output), d);
+            af::array dwindows = mask * af::tile(g, static_cast<unsigned>(k * k));
+            af::array dimage = af::wrap(dwindows, H + 2 * p, W + 2 * p, k, k, stride_, stride_, 0, 0, true);
+            if (p > 0) dimage = dimage(af::seq(p, p + H - 1), af::seq(p, p + W - 1), af::span, af::span);
+            grads[0] = ImageLayout::from_image(dimage);
+        }
+
+        return grads;
+    }
+
+    std::string MaxPool2dFunction::name() const {
+        return "MaxPool2d";
+    }
+
+    //----------------AvgPool2d---------------------------
+    AvgPool2dFunction::AvgPool2dFunction(const Shape& input_shape, size_t kernel, size_t stride, size_t padding)
+    : input_shape_(input_shape), kernel_(kernel), stride_(stride), padding_(padding) {}
+
+    std::vector<af::array> AvgPool2dFunction::apply(const af::array& grad_output) {
+        this->mark_visited();
+        std::vector<af::array> grads(1);
 
         if (inputs[0]->requires_grad()) {
-            af::array grad_input = exp_a * grad_output;
-            inputs[0]->grad() += grad_input;
+            const dim_t k = kernel_;
+            af::array g = ImageLayout::to_image(grad_output);  // (OH, OW, C, N)
+            const af::dim4 d = g.dims();
+            af::array windows = af::tile(af::moddims(g, 1, d[0] * d[1], d[2], d[3]) / static_cast<float>(k * k),
+                                         static_cast<unsigned>(k * k));
+            grads[0] = ImageLayout::from_image(af::wrap(windows, input_shape_[2], input_shape_[3],
+                                                        k, k, stride_, stride_, padding_, padding_, true));
+        }
 
-            if (inputs[0]->grad_fn()) {
-                inputs[0]->grad_fn()->apply(grad_input);
-            }
+        return grads;
+    }
+
+    std::string AvgPool2dFunction::name() const {
+        return "AvgPool2d";
+    }
+
+    //----------------LayerNorm / BatchNorm---------------------------
+
+    // Backward of x̂ = (x - mean) * rstd along dim 1 of a grouped (before, n, after)
+    // array, given dx̂: rstd * (dx̂ - mean(dx̂) - x̂ * mean(dx̂ * x̂)).
+    static af::array normalized_grad(const af::array& dxhat, const af::array& xhat, const af::array& rstd) {
+        const unsigned n = static_cast<unsigned>(xhat.dims(1));
+        af::array mean_dxhat = af::tile(af::mean(dxhat, 1), 1, n);
+        af::array mean_dxhat_xhat = af::tile(af::mean(dxhat * xhat, 1), 1, n);
+        return af::tile(rstd, 1, n) * (dxhat - mean_dxhat - xhat * mean_dxhat_xhat);
+    }
+
+    LayerNormFunction::LayerNormFunction(const Reduction& reduction)
+    : reduction_(reduction) {}
+
+    std::vector<af::array> LayerNormFunction::apply(const af::array& grad_output) {
+        this->mark_visited();
+        std::vector<af::array> grads(inputs.size());
+
+        const unsigned n = static_cast<unsigned>(reduction_.count());
+        const unsigned rows = static_cast<unsigned>(reduction_.grouped()[0]);
+        const af::array& mean = saved_tensors()[0];
+        const af::array& rstd = saved_tensors()[1];
+        const bool affine = inputs.size() > 1;
+
+        af::array xhat = (reduction_.group(input_data(0)) - af::tile(mean, 1, n)) * af::tile(rstd, 1, n);
+        af::array g = reduction_.group(grad_output);
+
+        if (inputs[0]->requires_grad()) {
+            af::array dxhat = affine ? g * af::tile(af::moddims(input_data(1), 1, n), rows) : g;
+            grads[0] = reduction_.ungroup(normalized_grad(dxhat, xhat, rstd));
+        }
+        // weight / bias vary along the normalized axes: sum over rows
+        if (affine && inputs[1]->requires_grad())
+            grads[1] = af::moddims(af::sum(g * xhat, 0), ShapeUtils::fold(inputs[1]->shape()));
+        if (affine && inputs[2]->requires_grad())
+            grads[2] = af::moddims(af::sum(g, 0), ShapeUtils::fold(inputs[2]->shape()));
+
+        return grads;
+    }
+
+    std::string LayerNormFunction::name() const {
+        return "LayerNorm";
+    }
+
+    BatchNormFunction::BatchNormFunction(const Reduction& reduction, bool training)
+    : reduction_(reduction), training_(training) {}
+
+    std::vector<af::array> BatchNormFunction::apply(const af::array& grad_output) {
+        this->mark_visited();
+        std::vector<af::array> grads(inputs.size());
+
+        const unsigned n = static_cast<unsigned>(reduction_.count());
+        const af::array& mean = saved_tensors()[0];
+        const af::array& rstd = saved_tensors()[1];
+        const af::dim4 stat_dims = mean.dims();
+        const dim_t channels = stat_dims.elements();
+        const bool affine = inputs.size() > 1;
+
+        af::array xhat = (reduction_.group(input_data(0)) - af::tile(mean, 1, n)) * af::tile(rstd, 1, n);
+        af::array g = reduction_.group(grad_output);
+
+        if (inputs[0]->requires_grad()) {
+            af::array dxhat = affine ? g * af::tile(af::moddims(input_data(1), stat_dims), 1, n) : g;
+            af::array dx = training_ ? normalized_grad(dxhat, xhat, rstd) : dxhat * af::tile(rstd, 1, n);
+            grads[0] = reduction_.ungroup(dx);
+        }
+        // weight / bias are per channel: sum over everything else
+        if (affine && inputs[1]->requires_grad())
+            grads[1] = af::moddims(af::sum(g * xhat, 1), channels);
+        if (affine && inputs[2]->requires_grad())
+            grads[2] = af::moddims(af::sum(g, 1), channels);
+
+        return grads;
+    }
+
+    std::string BatchNormFunction::name() const {
+        return "BatchNorm";
+    }
+
+    //----------------Embedding---------------------------
+
+    std::vector<af::array> EmbeddingFunction::apply(const af::array& grad_output) {
+        this->mark_visited();
+        const Shape& table = inputs[0]->shape();
+        const af::array& idx = saved_tensors()[0];
+
+        // Group equal indices, then one segmented sum instead of a scatter with collisions
+        af::array rows = af::moddims(grad_output, idx.elements(), static_cast<dim_t>(table[1]));
+        af::array sorted, order;
+        af::sort(sorted, order, idx);
+        af::array keys, sums;
+        af::sumByKey(keys, sums, sorted, rows(order, af::span), 0);
+
+        af::array grad = af::constant(0, static_cast<dim_t>(table[0]), static_cast<dim_t>(table[1]));
+        grad(keys, af::span) = sums;
+        return { grad };
+    }
+
+    std::string EmbeddingFunction::name() const {
+        return "Embedding";
+    }
+
+    //----------------Dropout---------------------------
+
+    DropoutFunction::DropoutFunction(float scale)
+    : scale_(scale) {}
+
+    std::vector<af::array> DropoutFunction::apply(const af::array& grad_output) {
+        this->mark_visited();
+        return { grad_output * saved_tensors()[0] * scale_ };
+    }
+
+    std::string DropoutFunction::name() const {
+        return "Dropout";
+    }
+
+    //----------------Checkpoint---------------------------
+
+    CheckpointFunction::CheckpointFunction(CheckpointSegment segment, unsigned long long seed)
+    : segment_(std::move(segment)), seed_(seed) {}
+
+    unsigned long long CheckpointFunction::fresh_seed() {
+        return af::randu(1, u64).scalar<unsigned long long>();
+    }
+
+    std::vector<af::array> CheckpointFunction::apply(const af::array& grad_output) {
+        this->mark_visited();
+        if (!segment_) throw std::runtime_error("Checkpoint: segment already released");
+
+        // Leaves sharing the forward-time data, so the inner pass stops at them
+        std::vector<Tensor> detached;
+        detached.reserve(inputs.size());
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            detached.push_back(Tensor(std::make_shared<TensorImpl>(
+                input_data(i), inputs[i]->shape(), inputs[i]->requires_grad())));
+        }
+
+        // Replay with the forward seed, then continue from a fresh point of the stream
+        const unsigned long long resume = fresh_seed();
+        af::setSeed(seed_);
+        std::shared_ptr<TensorImpl> out;
+        try {
+            EnableGradGuard enable_grad;
+            out = segment_(detached).impl();
+        } catch (...) {
+            af::setSeed(resume);
+            throw;
+        }
+        af::setSeed(resume);
+
+        if (out->requires_grad()) Engine::backward(out, grad_output);
+
+        std::vector<af::array> grads(inputs.size());
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            const TensorImpl& copy = *detached[i].impl();
+            if (copy.requires_grad() && copy.has_grad()) grads[i] = copy.grad();
+        }
+        return grads;
+    }
+
+    std::string CheckpointFunction::name() const {
+        return "Checkpoint";
+    }
+
+    void CheckpointFunction::release() {
+        segment_ = nullptr;     // May capture modules or tensors
+        Function::release();
+    }
+
+    //----------------Lazy---------------------------
+
+    LazyFunction::LazyFunction(lazy::NodePtr node)
+    : node_(std::move(node)), leaves_(lazy::grad_inputs(node_)) {
+        std::vector<std::shared_ptr<TensorImpl>> sources;
+        sources.reserve(leaves_.size());
+        for (const lazy::NodePtr& leaf : leaves_) sources.push_back(leaf->source);
+        set_inputs(std::move(sources));
+    }
+
+    std::vector<af::array> LazyFunction::apply(const af::array& grad_output) {
+        this->mark_visited();
+        if (!node_) throw std::runtime_error("Lazy: graph already released");
+
+        lazy::NodePtr seed = lazy::make_node(lazy::Op::Input, {}, node_->shape);
+        seed->value = grad_output;
+        seed->ready = true;
+
+        // Every input's gradient in one evaluation, so shared terms are computed once
+        std::vector<lazy::NodePtr> nodes = lazy::gradients(node_, seed, leaves_);
+        std::vector<lazy::NodePtr> roots;
+        for (const lazy::NodePtr& n : nodes) {
+            if (n) roots.push_back(n);
         }
+        std::vector<af::array> values = lazy::evaluate(roots);
+
+        std::vector<af::array> grads(inputs.size());
+        for (size_t i = 0, next = 0; i < nodes.size(); ++i) {
+            if (nodes[i]) grads[i] = values[next++];
+        }
+        return grads;
+    }
+
+    std::string LazyFunction::name() const {
+        return "Lazy";
+    }
+
+    void LazyFunction::release() {
+        node_ = nullptr;
+        leaves_.clear();
+        Function::release();
+    }
+
+    //----------------Neg---------------------------
+    std::vector<af::array> NegFunction::apply(const af::array& grad_output) {
+        this->mark_visited();
+        std::vector<af::array> grads(1);
+
+        if (inputs[0]->requires_grad())
+            grads[0] = -grad_output;
+
+        return grads;
+    }
+
+    std::string NegFunction::name() const {
+        return "Neg";
+    }
+
+    //----------------Exp---------------------------
+    std::vector<af::array> ExpFunction::apply(const af::array& grad_output) {
+        this->mark_visited();
+        std::vector<af::array> grads(1);
+
+        // d/da exp(a) = exp(a), which is exactly the saved output
+        if (inputs[0]->requires_grad())
+            grads[0] = saved_tensors()[0] * grad_output;
+
+        return grads;
     }
 
     std::string ExpFunction::name() const {
@@ -188,19 +753,16 @@ namespace cppgrad {
     }
 
     //----------------Log---------------------------
-    void LogFunction::apply(const af::array& grad_output) {
+    std::vector<af::array> LogFunction::apply(const af::array& grad_output) {
         this->mark_visited();
+        std::vector<af::array> grads(1);
 
-        const af::array& a = inputs[0]->data();
+        const af::array& a = input_data(0);
 
-        if (inputs[0]->requires_grad()) {
-            af::array grad_input = grad_output / a;
-            inputs[0]->grad() += grad_input;
+        if (inputs[0]->requires_grad())
+            grads[0] = grad_output / a;
 
-            if (inputs[0]->grad_fn()) {
-                inputs[0]->grad_fn()->apply(grad_input);
-            }
-        }
+        return grads;
     }
 
     std::string LogFunction::name() const {
@@ -208,194 +770,433 @@ namespace cppgrad {
     }
 
     //----------------Pow---------------------------
-    void PowFunction::apply(const af::array& grad_output) {
+    std::vector<af::array> PowFunction::apply(const af::array& grad_output) {
         this->mark_visited();
+        std::vector<af::array> grads(2);
 
-        const af::array& base = inputs[0]->data();
-        const af::array& exponent = inputs[1]->data();
-        af::array output = af::pow(base, exponent);
+        const auto& base_shape = inputs[0]->shape();
+        const auto& exp_shape = inputs[1]->shape();
+        const auto out_shape = Broadcast::result_shape(base_shape, exp_shape);
 
-        if (inputs[0]->requires_grad()) {
-            af::array grad_base = exponent * af::pow(base, exponent - 1) * grad_output;
-            inputs[0]->grad() += grad_base;
+        const af::array& output = saved_tensors()[0];
+        const af::array base = Broadcast::expand(input_data(0), base_shape, out_shape);
+        const af::array exponent = Broadcast::expand(input_data(1), exp_shape, out_shape);
 
-            if (inputs[0]->grad_fn()) {
-                inputs[0]->grad_fn()->apply(grad_base);
-            }
-        }
+        // base^(exponent-1) is kept rather than output / base, which breaks at base == 0
+        if (inputs[0]->requires_grad())
+            grads[0] = Broadcast::reduce_to(exponent * af::pow(base, exponent - 1) * grad_output,
+                                            out_shape, base_shape);
 
-        if (inputs[1]->requires_grad()) {
-            af::array grad_exp = output * af::log(base) * grad_output;
-            inputs[1]->grad() += grad_exp;
+        if (inputs[1]->requires_grad())
+            grads[1] = Broadcast::reduce_to(output * af::log(base) * grad_output,
+                                            out_shape, exp_shape);
 
-            if (inputs[1]->grad_fn()) {
-                inputs[1]->grad_fn()->apply(grad_exp);
-            }
-        }
+        return grads;
     }
 
     std::string PowFunction::name() const {
         return "Pow";
     }
 
-    //----------------Sum---------------------------
+    //----------------Relu---------------------------
+    std::vector<af::array> ReluFunction::apply(const af::array& grad_output) {
+        this->mark_visited();
+        std::vector<af::array> grads(1);
 
-    SumFunction::SumFunction(const af::dim4& input_shape, int dim, bool keepdim)
-    : input_shape_(input_shape), dim_(dim), keepdim_(keepdim) {}
+        if (inputs[0]->requires_grad())
+            grads[0] = grad_output * (saved_tensors()[0] > 0.0f);
 
-    void SumFunction::apply(const af::array& grad_output) {
+        return grads;
+    }
+
+    std::string ReluFunction::name() const {
+        return "Relu";
+    }
+
+    //----------------Sigmoid---------------------------
+    std::vector<af::array> SigmoidFunction::apply(const af::array& grad_output) {
         this->mark_visited();
+        std::vector<af::array> grads(1);
 
-        const auto& input = inputs[0];
-        const af::array& input_data = input->data();
+        // d/da sigmoid(a) = s * (1 - s)
+        if (inputs[0]->requires_grad()) {
+            const af::array& s = saved_tensors()[0];
+            grads[0] = grad_output * s * (1.0f - s);
+        }
 
-        if (!input->requires_grad()) return;
+        return grads;
+    }
 
-        af::array grad_input;
+    std::string SigmoidFunction::name() const {
+        return "Sigmoid";
+    }
 
-        if (dim_ == -1) {
-            // Gradient of sum over all elements: fill with ones and multiply by grad_output scalar
-            grad_input = af::constant(1.0f, input_shape_) * grad_output;
-        } else {
-            // Sum over specific dim
-            // If keepdim == false, we must expand grad_output shape before broadcasting
-            af::array grad = grad_output;
-            if (!keepdim_) {
-                // Insert singleton dimension back for broadcasting
-                std::vector<dim_t> dims = {
-                    input_shape_[0], input_shape_[1], input_shape_[2], input_shape_[3]
-                };
-                dims[dim_] = 1;  // insert singleton
-                grad = af::moddims(grad_output, af::dim4(dims[0], dims[1], dims[2], dims[3]));
-            }
+    //----------------Tanh---------------------------
+    std::vector<af::array> TanhFunction::apply(const af::array& grad_output) {
+        this->mark_visited();
+        std::vector<af::array> grads(1);
 
-            // Broadcast grad to match input shape
-            grad_input = af::tile(grad, get_tile_repeats(input_shape_, grad.dims()));
+        // d/da tanh(a) = 1 - t²
+        if (inputs[0]->requires_grad()) {
+            const af::array& t = saved_tensors()[0];
+            grads[0] = grad_output * (1.0f - t * t);
         }
 
-        input->grad() += grad_input;
+        return grads;
+    }
+
+    std::string TanhFunction::name() const {
+        return "Tanh";
+    }
+
+    //----------------Gelu---------------------------
+    std::vector<af::array> GeluFunction::apply(const af::array& grad_output) {
+        this->mark_visited();
+        std::vector<af::array> grads(1);
 
-        if (input->grad_fn()) {
-            input->grad_fn()->apply(grad_input);
+        // d/da a·Φ(a) = Φ(a) + a·φ(a), with φ the standard normal density
+        if (inputs[0]->requires_grad()) {
+            const af::array& a = input_data(0);
+            const af::array& cdf = saved_tensors()[0];
+            const float inv_sqrt_2pi = 0.3989422804014327f;
+            grads[0] = grad_output * (cdf + a * inv_sqrt_2pi * af::exp(-0.5f * a * a));
         }
+
+        return grads;
     }
 
-    std::string SumFunction::name() const {
-        return "Sum";
+    std::string GeluFunction::name() const {
+        return "Gelu";
     }
 
-    //----------------Mean---------------------------
-    MeanFunction::MeanFunction(const af::dim4& input_shape, int dim, bool keepdim)
-        : input_shape_(input_shape), dim_(dim), keepdim_(keepdim) {}
+    //----------------Silu---------------------------
+    std::vector<af::array> SiluFunction::apply(const af::array& grad_output) {
+        this->mark_visited();
+        std::vector<af::array> grads(1);
+
+        // d/da a·s(a) = s + a·s·(1 - s) = s + y·(1 - s)
+        if (inputs[0]->requires_grad()) {
+            const af::array& s = saved_tensors()[0];
+            const af::array& y = saved_tensors()[1];
+            grads[0] = grad_output * (s + y * (1.0f - s));
+        }
+
+        return grads;
+    }
 
+    std::string SiluFunction::name() const {
+        return "Silu";
+    }
+
+    //----------------Softmax---------------------------
+    SoftmaxFunction::SoftmaxFunction(const Shape& input_shape, int dim)
+    : input_shape_(input_shape), dim_(dim) {}
 
-    void MeanFunction::apply(const af::array& grad_output) {
+    std::vector<af::array> SoftmaxFunction::apply(const af::array& grad_output) {
         this->mark_visited();
+        std::vector<af::array> grads(1);
 
-        const auto& input = inputs[0];
-        const af::array& input_data = input->data();
+        if (inputs[0]->requires_grad()) {
+            const af::dim4 grouped = ShapeUtils::around(input_shape_, dim_);
+            const unsigned n = static_cast<unsigned>(grouped[1]);
+            af::array y = af::moddims(saved_tensors()[0], grouped);
+            af::array g = af::moddims(grad_output, grouped);
+            af::array dot = af::tile(af::sum(g * y, 1), 1, n);
+            grads[0] = af::moddims(y * (g - dot), ShapeUtils::fold(input_shape_));
+        }
 
-        if (!input->requires_grad()) return;
+        return grads;
+    }
 
-        af::array grad_input;
+    std::string SoftmaxFunction::name() const {
+        return "Softmax";
+    }
 
-        if (dim_ == -1) {
-            // Mean over all elements: gradient is 1/N broadcasted to input shape
-            dim_t N = input_shape_.elements();
-            grad_input = af::constant(1.0f / static_cast<float>(N), input_shape_) * grad_output;
-        } else {
-            // Mean over specific dim
-            dim_t N = input_shape_[dim_];
-            af::array grad = grad_output;
-
-            if (!keepdim_) {
-                // Insert singleton dimension back for broadcasting
-                std::vector<dim_t> dims = {
-                    input_shape_[0], input_shape_[1], input_shape_[2], input_shape_[3]
-                };
-                dims[dim_] = 1;
-                grad = af::moddims(grad_output, af::dim4(dims[0], dims[1], dims[2], dims[3]));
-            }
+    //----------------LogSoftmax---------------------------
+    LogSoftmaxFunction::LogSoftmaxFunction(const Shape& input_shape, int dim)
+    : input_shape_(input_shape), dim_(dim) {}
 
-            // Scale the gradient by 1/N
-            grad = grad / static_cast<float>(N);
+    std::vector<af::array> LogSoftmaxFunction::apply(const af::array& grad_output) {
+        this->mark_visited();
+        std::vector<af::array> grads(1);
 
-            // Broadcast grad to match input shape
-            grad_input = af::tile(grad, get_tile_dims(input_shape_, dim_));
+        if (inputs[0]->requires_grad()) {
+            const af::dim4 grouped = ShapeUtils::around(input_shape_, dim_);
+            const unsigned n = static_cast<unsigned>(grouped[1]);
+            af::array y = af::moddims(saved_tensors()[0], grouped);
+            af::array g = af::moddims(grad_output, grouped);
+            af::array total = af::tile(af::sum(g, 1), 1, n);
+            grads[0] = af::moddims(g - af::exp(y) * total, ShapeUtils::fold(input_shape_));
         }
 
-        input->grad() += grad_input;
+        return grads;
+    }
 
-        if (input->grad_fn()) {
-            input->grad_fn()->apply(grad_input);
+    std::string LogSoftmaxFunction::name() const {
+        return "LogSoftmax";
+    }
+
+    //----------------LogSumExp---------------------------
+    LogSumExpFunction::LogSumExpFunction(const Reduction& reduction)
+    : reduction_(reduction) {}
+
+    std::vector<af::array> LogSumExpFunction::apply(const af::array& grad_output) {
+        this->mark_visited();
+        std::vector<af::array> grads(1);
+
+        if (inputs[0]->requires_grad()) {
+            af::array lse = reduction_.expand(saved_tensors()[0]);
+            grads[0] = reduction_.expand(grad_output) * af::exp(input_data(0) - lse);
         }
+
+        return grads;
     }
 
-    std::string MeanFunction::name() const {
-        return "Mean";
+    std::string LogSumExpFunction::name() const {
+        return "LogSumExp";
     }
 
-    //----------------Max---------------------------
+    //----------------CrossEntropy---------------------------
+    CrossEntropyFunction::CrossEntropyFunction(size_t count)
+    : count_(count) {}
+
+    std::vector<af::array> CrossEntropyFunction::apply(const af::array& grad_output) {
+        this->mark_visited();
+        std::vector<af::array> grads(1);
 
-    MaxFunction::MaxFunction(const af::array& input_data, int dim, bool keepdim)
-    : input_data_(input_data), dim_(dim), keepdim_(keepdim), input_shape_(input_data.dims()) {}
+        if (inputs[0]->requires_grad()) {
+            const af::array& idx = saved_tensors()[1];
+            af::array d = saved_tensors()[0].copy();
+
+            // softmax - onehot: subtract 1 only at the target positions
+            af::array picked = d(idx);
+            d(idx) = picked - 1.0f;
+
+            af::array scale = af::tile(grad_output / static_cast<float>(count_), d.dims());
+            grads[0] = af::moddims(d * scale, ShapeUtils::fold(inputs[0]->shape()));
+        }
+
+        return grads;
+    }
 
+    std::string CrossEntropyFunction::name() const {
+        return "CrossEntropy";
+    }
+
+    //----------------Slice---------------------------
+
+    SliceFunction::SliceFunction(const Shape& input_shape, int dim, dim_t first, dim_t last, dim_t step)
+    : input_shape_(input_shape), dim_(dim), first_(first), last_(last), step_(step) {}
 
-    void MaxFunction::apply(const af::array& grad_output) {
+    std::vector<af::array> SliceFunction::apply(const af::array& grad_output) {
         this->mark_visited();
+        std::vector<af::array> grads(1);
 
-        const auto& input = inputs[0];
-        if (!input->requires_grad()) return;
+        if (!inputs[0]->requires_grad()) return grads;
 
-        af::array grad_mask;
-        if (dim_ == -1) {
-            // Global max: compare with scalar
-            float max_val = af::max<float>(af::flat(input_data_));
-            grad_mask = (input_data_ == max_val);
-        } else {
-            // Max along dimension: build broadcasted mask
-            af::array max_vals = af::max(input_data_, dim_);
-
-            if (!keepdim_) {
-                // Insert singleton for broadcasting
-                std::vector<dim_t> dims = {
-                    input_shape_[0], input_shape_[1], input_shape_[2], input_shape_[3]
-                };
-                dims[dim_] = 1;
-                max_vals = af::moddims(max_vals, af::dim4(dims[0], dims[1], dims[2], dims[3]));
-            }
+        // Scatter the slice gradient into its window of the base shape,
+        // viewed as (before, n, after) so any axis of any rank is dim 1
+        const af::dim4 grouped = ShapeUtils::around(input_shape_, dim_);
+        const dim_t count = (last_ - first_) / step_ + 1;
 
-            grad_mask = (input_data_ == af::tile(max_vals, get_tile_dims(input_shape_, dim_)));
-        }
+        af::array grad_input = af::constant(0.0f, grouped, grad_output.type());
+        grad_input(af::span,
+                   af::seq(static_cast<double>(first_), static_cast<double>(last_), static_cast<double>(step_)),
+                   af::span) = af::moddims(grad_output, af::dim4(grouped[0], count, grouped[2]));
 
-        af::array grad = grad_output;
+        grads[0] = af::moddims(grad_input, ShapeUtils::fold(input_shape_));
+        return grads;
+    }
 
-        if (!keepdim_ && dim_ != -1) {
-            // Insert singleton for broadcasting
-            std::vector<dim_t> dims = {
-                input_shape_[0], input_shape_[1], input_shape_[2], input_shape_[3]
-            };
-            dims[dim_] = 1;
-            grad = af::moddims(grad_output, af::dim4(dims[0], dims[1], dims[2], dims[3]));
-        }
+    std::string SliceFunction::name() const {
+        return "Slice";
+    }
 
-        // Broadcast grad to input shape
-        if (dim_ != -1) {
-            grad = af::tile(grad, get_tile_dims(input_shape_, dim_));
-        }
+    //----------------Reshape---------------------------
+
+    ReshapeFunction::ReshapeFunction(const af::dim4& input_shape)
+    : input_shape_(input_shape) {}
+
+    std::vector<af::array> ReshapeFunction::apply(const af::array& grad_output) {
+        this->mark_visited();
+        std::vector<af::array> grads(1);
+
+        if (inputs[0]->requires_grad())
+            grads[0] = af::moddims(grad_output, input_shape_);
+
+        return grads;
+    }
+
+    std::string ReshapeFunction::name() const {
+        return "Reshape";
+    }
 
-        // Apply mask: gradient only to positions that had the max value
-        af::array grad_input = grad * grad_mask.as(f32);
+    //----------------Permute---------------------------
 
-        input->grad() += grad_input;
+    PermuteFunction::PermuteFunction(const std::array<unsigned, 4>& perm)
+    : perm_(perm.begin(), perm.end()) {}
 
-        if (input->grad_fn()) {
-            input->grad_fn()->apply(grad_input);
+    PermuteFunction::PermuteFunction(std::vector<unsigned> perm, Shape out_shape)
+    : perm_(std::move(perm)), out_shape_(std::move(out_shape)) {}
+
+    std::vector<af::array> PermuteFunction::apply(const af::array& grad_output) {
+        this->mark_visited();
+        std::vector<af::array> grads(1);
+
+        if (!inputs[0]->requires_grad()) return grads;
+
+        // Output axis i came from input axis perm_[i], so send it back there
+        std::vector<unsigned> inverse(perm_.size());
+        for (unsigned i = 0; i < perm_.size(); ++i) inverse[perm_[i]] = i;
+
+        if (out_shape_.empty()) {
+            grads[0] = af::reorder(grad_output, inverse[0], inverse[1], inverse[2], inverse[3]);
+        } else {
+            grads[0] = ShapeUtils::permute(grad_output, out_shape_, inverse);
         }
+        return grads;
+    }
+
+    std::string PermuteFunction::name() const {
+        return "Permute";
+    }
+
+    //----------------Sum---------------------------
+    SumFunction::SumFunction(const Reduction& reduction)
+    : reduction_(reduction) {}
+
+    std::vector<af::array> SumFunction::apply(const af::array& grad_output) {
+        this->mark_visited();
+        std::vector<af::array> grads(1);
+
+        if (inputs[0]->requires_grad())
+            grads[0] = reduction_.expand(grad_output);
+
+        return grads;
+    }
+
+    std::string SumFunction::name() const {
+        return "Sum";
+    }
+
+    //----------------Mean---------------------------
+    MeanFunction::MeanFunction(const Reduction& reduction)
+    : reduction_(reduction) {}
+
+    std::vector<af::array> MeanFunction::apply(const af::array& grad_output) {
+        this->mark_visited();
+        std::vector<af::array> grads(1);
+
+        if (!inputs[0]->requires_grad()) return grads;
+
+        // Each input element contributed 1/N of the mean
+        grads[0] = reduction_.expand(grad_output / static_cast<float>(reduction_.count()));
+        return grads;
+    }
+
+    std::string MeanFunction::name() const {
+        return "Mean";
+    }
+
+    //----------------Max---------------------------
+    MaxFunction::MaxFunction(const Reduction& reduction)
+    : reduction_(reduction) {}
+
+    std::vector<af::array> MaxFunction::apply(const af::array& grad_output) {
+        this->mark_visited();
+        std::vector<af::array> grads(1);
+
+        // Only the position that held the max, recorded in forward, gets gradient
+        if (inputs[0]->requires_grad())
+            grads[0] = reduction_.scatter(grad_output, saved_tensors()[0]);
+
+        return grads;
     }
 
     std::string MaxFunction::name() const {
         return "Max";
     }
 
-}
\ No newline at end of file
+    //----------------Min---------------------------
+    MinFunction::MinFunction(const Reduction& reduction)
+    : reduction_(reduction) {}
+
+    std::vector<af::array> MinFunction::apply(const af::array& grad_output) {
+        this->mark_visited();
+        std::vector<af::array> grads(1);
+
+        if (inputs[0]->requires_grad())
+            grads[0] = reduction_.scatter(grad_output, saved_tensors()[0]);
+
+        return grads;
+    }
+
+    std::string MinFunction::name() const {
+        return "Min";
+    }
+
+    //----------------Prod---------------------------
+    ProdFunction::ProdFunction(const Reduction& reduction)
+    : reduction_(reduction) {}
+
+    std::vector<af::array> ProdFunction::apply(const af::array& grad_output) {
+        this->mark_visited();
+        std::vector<af::array> grads(1);
+
+        if (!inputs[0]->requires_grad()) return grads;
+
+        // Product of everything before and everything after each element
+        af::array x = reduction_.group(input_data(0));
+        af::array before = af::scan(x, 1, AF_BINARY_MUL, false);
+        af::array after = af::flip(af::scan(af::flip(x, 1), 1, AF_BINARY_MUL, false), 1);
+        grads[0] = reduction_.ungroup(before * after) * reduction_.expand(grad_output);
+        return grads;
+    }
+
+    std::string ProdFunction::name() const {
+        return "Prod";
+    }
+
+    //----------------Var---------------------------
+    VarFunction::VarFunction(const Reduction& reduction, bool unbiased)
+    : reduction_(reduction), unbiased_(unbiased) {}
+
+    std::vector<af::array> VarFunction::apply(const af::array& grad_output) {
+        this->mark_visited();
+        std::vector<af::array> grads(1);
+
+        if (!inputs[0]->requires_grad()) return grads;
+
+        const float denom = static_cast<float>(reduction_.count() - (unbiased_ ? 1 : 0));
+        af::array centered = input_data(0) - reduction_.expand(saved_tensors()[0]);
+        grads[0] = reduction_.expand(grad_output) * centered * (2.0f / denom);
+        return grads;
+    }
+
+    std::string VarFunction::name() const {
+        return "Var";
+    }
+
+    //----------------Std---------------------------
+    StdFunction::StdFunction(const Reduction& reduction, bool unbiased)
+    : reduction_(reduction), unbiased_(unbiased) {}
+
+    std::vector<af::array> StdFunction::apply(const af::array& grad_output) {
+        this->mark_visited();
+        std::vector<af::array> grads(1);
+
+        if (!inputs[0]->requires_grad()) return grads;
+
+        // d std = d var / (2 std)
+        const float denom = static_cast<float>(reduction_.count() - (unbiased_ ? 1 : 0));
+        af::array centered = input_data(0) - reduction_.expand(saved_tensors()[0]);
+        af::array g = af::moddims(grad_output, saved_tensors()[1].dims()) / saved_tensors()[1];
+        grads[0] = reduction_.expand(g) * centered / denom;
+        return grads;
+    }
+
+    std::string StdFunction::name() const {
+        return "Std";
+    }
+
+}
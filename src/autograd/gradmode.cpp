@@ -0,0 +1,58 @@
+#include "autograd/gradmode.hpp"
+
+namespace cppgrad {
+
+    // Per-thread state so serving threads do not affect training threads.
+    static thread_local bool grad_enabled = true;
+    static thread_local bool inference_mode = false;
+
+    bool GradMode::is_enabled() {
+        return grad_enabled;
+    }
+
+    void GradMode::set_enabled(bool enabled) {
+        grad_enabled = enabled;
+    }
+
+    bool GradMode::is_inference_mode() {
+        return inference_mode;
+    }
+
+    void GradMode::set_inference_mode(bool enabled) {
+        inference_mode = enabled;
+    }
+
+    //----------------NoGradGuard---------------------------
+    NoGradGuard::NoGradGuard()
+    : prev_enabled_(GradMode::is_enabled()) {
+        GradMode::set_enabled(false);
+    }
+
+    NoGradGuard::~NoGradGuard() {
+        GradMode::set_enabled(prev_enabled_);
+    }
+
+    //----------------EnableGradGuard---------------------------
+    EnableGradGuard::EnableGradGuard()
+    : prev_enabled_(GradMode::is_enabled()) {
+        GradMode::set_enabled(true);
+    }
+
+    EnableGradGuard::~EnableGradGuard() {
+        GradMode::set_enabled(prev_enabled_);
+    }
+
+    //----------------InferenceMode---------------------------
+    InferenceMode::InferenceMode()
+    : prev_enabled_(GradMode::is_enabled()),
+      prev_inference_(GradMode::is_inference_mode()) {
+        GradMode::set_enabled(false);
+        GradMode::set_inference_mode(true);
+    }
+
+    InferenceMode::~InferenceMode() {
+        GradMode::set_inference_mode(prev_inference_);
+        GradMode::set_enabled(prev_enabled_);
+    }
+
+}
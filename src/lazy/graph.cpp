@@ -0,0 +1,100 @@
+#include "lazy/graph.hpp"
+#include "autograd/gradmode.hpp"
+#include "lazy/passes.hpp"
+#include "tensor/broadcast.hpp"
+#include "tensor/tensorimpl.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace cppgrad::lazy {
+
+    namespace {
+
+        /// Set `requires_grad` from the operands, as eager ops do.
+        NodePtr with_grad(NodePtr node) {
+            node->requires_grad = GradMode::is_enabled() &&
+                std::any_of(node->inputs.begin(), node->inputs.end(),
+                            [](const NodePtr& in) { return in->requires_grad; });
+            return node;
+        }
+
+        /// `node` broadcast to `shape`.
+        NodePtr expanded(const NodePtr& node, const Shape& shape) {
+            if (node->shape == shape) return node;
+            return with_grad(make_node(Op::Expand, { node }, shape));
+        }
+
+        std::shared_ptr<TensorImpl> make_result(const NodePtr& node) {
+            return std::make_shared<TensorImpl>(node, node->requires_grad);
+        }
+
+    } // namespace
+
+    bool is_elementwise(Op op) {
+        switch (op) {
+            case Op::Input:
+            case Op::Constant:
+            case Op::ReduceTo:
+            case Op::Sum:
+            case Op::Mean:
+            case Op::ExpandReduction:
+                return false;
+            default:
+                return true;   // Expand is an af::tile, also a JIT node
+        }
+    }
+
+    NodePtr make_node(Op op, std::vector<NodePtr> inputs, Shape shape, float scalar) {
+        auto node = std::make_shared<Node>();
+        node->op = op;
+        node->inputs = std::move(inputs);
+        node->shape = std::move(shape);
+        node->scalar = scalar;
+        count(&LazyStats::recorded);
+        return node;
+    }
+
+    NodePtr node_of(const std::shared_ptr<TensorImpl>& impl) {
+        NodePtr node = impl->lazy_node();
+        if (node && impl->version() == 0) return node;
+
+        node = make_node(Op::Input, {}, impl->shape());
+        node->source = impl;
+        node->version = impl->version();
+        node->value = impl->data();
+        node->ready = true;
+        node->requires_grad = impl->requires_grad();
+        return node;
+    }
+
+    std::shared_ptr<TensorImpl> record_binary(Op op, const std::shared_ptr<TensorImpl>& a,
+                                              const std::shared_ptr<TensorImpl>& b) {
+        if (op != Op::Add && op != Op::Sub && op != Op::Mul && op != Op::Div) {
+            throw std::runtime_error("lazy: not a binary op");
+        }
+        // Broadcast operands (throws if the shapes are incompatible)
+        Shape shape = Broadcast::result_shape(a->shape(), b->shape());
+        return make_result(with_grad(make_node(op, { expanded(node_of(a), shape), expanded(node_of(b), shape) }, shape)));
+    }
+
+    std::shared_ptr<TensorImpl> record_unary(Op op, const std::shared_ptr<TensorImpl>& x, float scalar) {
+        if (!is_elementwise(op) || op == Op::Expand || op == Op::Step ||
+            op == Op::Add || op == Op::Sub || op == Op::Mul || op == Op::Div) {
+            throw std::runtime_error("lazy: not a unary op");
+        }
+        return make_result(with_grad(make_node(op, { node_of(x) }, x->shape(), scalar)));
+    }
+
+    std::shared_ptr<TensorImpl> record_reduction(Op op, const std::shared_ptr<TensorImpl>& x, const Reduction& r) {
+        if (op != Op::Sum && op != Op::Mean) throw std::runtime_error("lazy: not a reduction");
+        NodePtr node = make_node(op, { node_of(x) }, r.output_shape());
+        node->reduction = r;
+        return make_result(with_grad(std::move(node)));
+    }
+
+    std::shared_ptr<TensorImpl> record_constant(const Shape& shape, float value) {
+        return make_result(make_node(Op::Constant, {}, shape, value));
+    }
+
+}
@@ -0,0 +1,44 @@
+#include "lazy/lazymode.hpp"
+#include "tensor/tensor.hpp"
+#include "tensor/tensorimpl.hpp"
+
+namespace cppgrad {
+
+    // Per-thread like GradMode, so a lazy scope on one thread does not change
+    // how another thread runs ops.
+    static thread_local bool lazy_enabled = false;
+
+    LazyMode::LazyMode()
+    : prev_enabled_(lazy_enabled) {
+        lazy_enabled = true;
+    }
+
+    LazyMode::~LazyMode() {
+        lazy_enabled = prev_enabled_;
+    }
+
+    bool LazyMode::is_enabled() {
+        return lazy_enabled;
+    }
+
+    lazy::LazyStats LazyMode::stats() {
+        return lazy::stats();
+    }
+
+    void LazyMode::reset_stats() {
+        lazy::reset_stats();
+    }
+
+    void materialize(const std::vector<Tensor>& tensors) {
+        std::vector<lazy::NodePtr> roots;
+        for (const Tensor& t : tensors) {
+            if (t.impl()->is_lazy()) roots.push_back(t.impl()->lazy_node());
+        }
+        if (roots.empty()) return;
+
+        lazy::evaluate(roots);
+        // Each tensor now only copies its node's value
+        for (const Tensor& t : tensors) t.impl()->data();
+    }
+
+}
@@ -0,0 +1,456 @@
+#include "lazy/passes.hpp"
+#include "tensor/broadcast.hpp"
+#include "tensor/shapeutils.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+namespace cppgrad::lazy {
+
+    namespace {
+
+        std::mutex stats_mutex;
+        LazyStats counters;
+
+        // Nodes are shared between tensors and between threads (parallel
+        // backward workers), and the passes rewrite them in place.
+        std::mutex graph_mutex;
+
+        bool is_ready(const Node& n) { return n.ready; }
+
+        /// Nodes reachable from `roots`, operands before their consumers. Does
+        /// not descend below nodes for which `stop` is true.
+        template <typename Stop>
+        std::vector<NodePtr> post_order(const std::vector<NodePtr>& roots, Stop stop) {
+            std::vector<NodePtr> order;
+            std::unordered_set<const Node*> seen;
+            std::vector<std::pair<NodePtr, size_t>> stack;
+            for (const NodePtr& root : roots) {
+                if (!root || !seen.insert(root.get()).second) continue;
+                stack.emplace_back(root, 0);
+                while (!stack.empty()) {
+                    NodePtr node = stack.back().first;
+                    size_t& next = stack.back().second;
+                    if (!stop(*node) && next < node->inputs.size()) {
+                        const NodePtr& in = node->inputs[next++];
+                        if (seen.insert(in.get()).second) stack.emplace_back(in, 0);
+                        continue;
+                    }
+                    order.push_back(std::move(node));
+                    stack.pop_back();
+                }
+            }
+            return order;
+        }
+
+        // ----------------------------------------
+        // Constant folding
+        // ----------------------------------------
+
+        /// Host value of an op whose operands are all constants; false if it has none.
+        bool fold_scalar(const Node& n, float& out) {
+            auto in = [&](size_t i) { return n.inputs[i]->scalar; };
+            const float s = n.scalar;
+            switch (n.op) {
+                case Op::Add:        out = in(0) + in(1); return true;
+                case Op::Sub:        out = in(0) - in(1); return true;
+                case Op::Mul:        out = in(0) * in(1); return true;
+                case Op::Div:        out = in(0) / in(1); return true;
+                case Op::AddScalar:  out = in(0) + s; return true;
+                case Op::MulScalar:  out = in(0) * s; return true;
+                case Op::DivScalar:  out = in(0) / s; return true;
+                case Op::RSubScalar: out = s - in(0); return true;
+                case Op::RDivScalar: out = s / in(0); return true;
+                case Op::PowScalar:  out = std::pow(in(0), s); return true;
+                case Op::RPowScalar: out = std::pow(s, in(0)); return true;
+                case Op::Neg:        out = -in(0); return true;
+                case Op::Exp:        out = std::exp(in(0)); return true;
+                case Op::Log:        out = std::log(in(0)); return true;
+                case Op::Relu:       out = in(0) > 0.0f ? in(0) : 0.0f; return true;
+                case Op::Sigmoid:    out = 1.0f / (1.0f + std::exp(-in(0))); return true;
+                case Op::Tanh:       out = std::tanh(in(0)); return true;
+                case Op::Step:       out = in(0) > 0.0f ? 1.0f : 0.0f; return true;
+                case Op::Expand:
+                case Op::Mean:
+                case Op::ExpandReduction:
+                    out = in(0);
+                    return true;
+                case Op::Sum:
+                    out = in(0) * static_cast<float>(n.reduction.count());
+                    return true;
+                case Op::ReduceTo:
+                    out = in(0) * static_cast<float>(ShapeUtils::numel(n.inputs[0]->shape) /
+                                                     ShapeUtils::numel(n.shape));
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        NodePtr scalar_node(Op op, const NodePtr& x, float scalar, bool requires_grad) {
+            NodePtr node = make_node(op, { x }, x->shape, scalar);
+            node->requires_grad = requires_grad;
+            return node;
+        }
+
+        /// Simpler equivalent of `n` (operands already rewritten), or `n` itself.
+        NodePtr fold(const NodePtr& n) {
+            if (n->ready || n->inputs.empty()) return n;
+
+            bool all_constant = true;
+            for (const NodePtr& in : n->inputs) all_constant = all_constant && in->op == Op::Constant;
+            float value = 0.0f;
+            if (all_constant && !n->requires_grad && fold_scalar(*n, value)) {
+                return make_node(Op::Constant, {}, n->shape, value);
+            }
+
+            NodePtr folded;
+            const NodePtr& x = n->inputs[0];
+            const float s = n->scalar;
+            switch (n->op) {
+                case Op::Add: case Op::Sub: case Op::Mul: case Op::Div: {
+                    // One constant operand: the scalar form of the op
+                    const NodePtr& b = n->inputs[1];
+                    const bool ca = x->op == Op::Constant, cb = b->op == Op::Constant;
+                    if (ca == cb) break;
+                    const NodePtr& t = ca ? b : x;
+                    const float c = ca ? x->scalar : b->scalar;
+                    if (n->op == Op::Add) folded = scalar_node(Op::AddScalar, t, c, n->requires_grad);
+                    if (n->op == Op::Mul) folded = scalar_node(Op::MulScalar, t, c, n->requires_grad);
+                    if (n->op == Op::Sub) folded = scalar_node(ca ? Op::RSubScalar : Op::AddScalar, t, ca ? c : -c, n->requires_grad);
+                    if (n->op == Op::Div) folded = scalar_node(ca ? Op::RDivScalar : Op::DivScalar, t, c, n->requires_grad);
+                    break;
+                }
+                case Op::AddScalar:
+                    if (s == 0.0f) folded = x;
+                    else if (x->op == Op::AddScalar && !x->ready) folded = scalar_node(Op::AddScalar, x->inputs[0], x->scalar + s, n->requires_grad);
+                    break;
+                case Op::MulScalar:
+                    if (s == 1.0f) folded = x;
+                    else if (x->op == Op::MulScalar && !x->ready) folded = scalar_node(Op::MulScalar, x->inputs[0], x->scalar * s, n->requires_grad);
+                    break;
+                case Op::DivScalar:
+                case Op::PowScalar:
+                    if (s == 1.0f) folded = x;
+                    break;
+                case Op::Neg:
+                    if (x->op == Op::Neg && !x->ready) folded = x->inputs[0];
+                    break;
+                default:
+                    break;
+            }
+            // Never let a rewrite change where gradients flow
+            if (!folded || folded->requires_grad != n->requires_grad) return n;
+            return folded;
+        }
+
+        // ----------------------------------------
+        // Common-subexpression elimination
+        // ----------------------------------------
+
+        std::string address(const void* p) {
+            return std::to_string(reinterpret_cast<std::uintptr_t>(p));
+        }
+
+        /// Equal keys compute equal values (and route gradients the same way).
+        std::string key(const Node& n) {
+            std::string k = std::to_string(static_cast<int>(n.op)) + (n.requires_grad ? "g" : "n");
+            if (n.op == Op::Input) {
+                return n.source ? k + address(n.source.get()) + "v" + std::to_string(n.version) : k + "@" + address(&n);
+            }
+            if (n.ready && n.op != Op::Constant) return k + "@" + address(&n);
+
+            for (const NodePtr& in : n.inputs) k += "," + address(in.get());
+            uint32_t bits = 0;
+            std::memcpy(&bits, &n.scalar, sizeof(bits));
+            k += "s" + std::to_string(bits) + "[";
+            for (size_t d : n.shape) k += std::to_string(d) + ",";
+            if (n.op == Op::Sum || n.op == Op::Mean || n.op == Op::ExpandReduction) {
+                const af::dim4& g = n.reduction.grouped();
+                for (unsigned i = 0; i < 4; ++i) k += "g" + std::to_string(g[i]) + "p" + std::to_string(n.reduction.perm()[i]);
+            }
+            return k;
+        }
+
+        // ----------------------------------------
+        // Emission
+        // ----------------------------------------
+
+        af::array emit(const Node& n) {
+            auto in = [&](size_t i) -> const af::array& { return n.inputs[i]->value; };
+            const float s = n.scalar;
+            switch (n.op) {
+                case Op::Constant:   return af::constant(s, ShapeUtils::fold(n.shape));
+                case Op::Add:        return in(0) + in(1);
+                case Op::Sub:        return in(0) - in(1);
+                case Op::Mul:        return in(0) * in(1);
+                case Op::Div:        return in(0) / in(1);
+                case Op::AddScalar:  return in(0) + s;
+                case Op::MulScalar:  return in(0) * s;
+                case Op::DivScalar:  return in(0) / s;
+                case Op::RSubScalar: return s - in(0);
+                case Op::RDivScalar: return s / in(0);
+                case Op::PowScalar:  return af::pow(in(0), s);
+                case Op::RPowScalar: return af::pow(s, in(0));
+                case Op::Neg:        return -in(0);
+                case Op::Exp:        return af::exp(in(0));
+                case Op::Log:        return af::log(in(0));
+                case Op::Relu:       return af::max(in(0), 0.0);
+                case Op::Sigmoid:    return af::sigmoid(in(0));
+                case Op::Tanh:       return af::tanh(in(0));
+                case Op::Step:       return (in(0) > 0).as(f32);
+                case Op::Expand:     return Broadcast::expand(in(0), n.inputs[0]->shape, n.shape);
+                case Op::ReduceTo:   return Broadcast::reduce_to(in(0), n.inputs[0]->shape, n.shape);
+                case Op::Sum:
+                    return n.reduction.result(af::sum(n.reduction.group(in(0)), 1));
+                case Op::Mean:
+                    return n.reduction.result(af::sum(n.reduction.group(in(0)), 1) /
+                                              static_cast<float>(n.reduction.count()));
+                case Op::ExpandReduction:
+                    return n.reduction.expand(in(0));
+                case Op::Input:
+                    break;
+            }
+            throw std::runtime_error("lazy: input node without data");
+        }
+
+        /// Emit every node `roots` needs, with explicit eval points where more
+        /// than one kernel reads an elementwise node; roots are evaluated together.
+        void emit_all(const std::vector<NodePtr>& roots) {
+            std::vector<NodePtr> order = post_order(roots, is_ready);
+            std::unordered_set<const Node*> root_set;
+            for (const NodePtr& r : roots) root_set.insert(r.get());
+
+            // Kernel each pending node is fused into, consumers first; null
+            // once a second kernel reads it
+            std::unordered_map<const Node*, const Node*> owner;
+            std::unordered_set<const Node*> eval_points;
+            for (auto it = order.rbegin(); it != order.rend(); ++it) {
+                const Node* n = it->get();
+                if (n->ready || n->op == Op::Constant) continue;
+
+                auto found = owner.find(n);
+                const bool used = found != owner.end();
+                const bool root = root_set.count(n) > 0;
+                bool kernel = root || !is_elementwise(n->op);
+                // Roots read by other nodes, and elementwise nodes read by two kernels
+                if (used && (root || (kernel == false && found->second == nullptr))) {
+                    eval_points.insert(n);
+                    kernel = true;
+                }
+                const Node* mine = kernel ? n : found->second;
+                for (const NodePtr& in : n->inputs) {
+                    if (in->ready) continue;
+                    auto [slot, inserted] = owner.try_emplace(in.get(), mine);
+                    if (!inserted && slot->second != mine) slot->second = nullptr;
+                }
+            }
+
+            std::vector<af::array*> batch;
+            for (const NodePtr& n : order) {
+                if (n->ready) continue;
+                n->value = emit(*n);
+                n->ready = true;
+                count(&LazyStats::emitted);
+                if (eval_points.count(n.get())) {
+                    n->value.eval();
+                    count(&LazyStats::evals);
+                } else if (root_set.count(n.get())) {
+                    batch.push_back(&n->value);
+                }
+            }
+            if (!batch.empty()) {
+                af::eval(static_cast<int>(batch.size()), batch.data());
+                count(&LazyStats::evals);
+            }
+        }
+
+    } // namespace
+
+    LazyStats stats() {
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        return counters;
+    }
+
+    void reset_stats() {
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        counters = LazyStats{};
+    }
+
+    void count(size_t LazyStats::* counter, size_t n) {
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        counters.*counter += n;
+    }
+
+    std::vector<af::array> evaluate(const std::vector<NodePtr>& roots) {
+        std::lock_guard<std::mutex> lock(graph_mutex);
+        std::vector<NodePtr> original = post_order(roots, is_ready);
+
+        bool pending = false;
+        for (const NodePtr& n : original) pending = pending || !n->ready;
+        if (pending) {
+            count(&LazyStats::materializations);
+
+            // Fold and merge bottom-up; operands are rewritten in place
+            std::unordered_map<const Node*, NodePtr> canonical;
+            std::unordered_map<std::string, NodePtr> table;
+            for (const NodePtr& n : original) {
+                if (!n->ready) {
+                    for (NodePtr& in : n->inputs) in = canonical.at(in.get());
+                }
+                NodePtr r = n;
+                for (NodePtr next = fold(r); next != r; next = fold(r)) {
+                    r = next;
+                    count(&LazyStats::folded);
+                }
+                auto [it, inserted] = table.try_emplace(key(*r), r);
+                if (!inserted && it->second != r) count(&LazyStats::merged);
+                canonical[n.get()] = it->second;
+            }
+
+            // Dead nodes are never visited: only what the roots read is emitted
+            std::vector<NodePtr> targets;
+            for (const NodePtr& r : roots) targets.push_back(canonical.at(r.get()));
+            emit_all(targets);
+
+            // Nodes folded away stay pending until something reads them
+            for (const NodePtr& n : original) {
+                const NodePtr& c = canonical.at(n.get());
+                if (!n->ready && c->ready) {
+                    n->value = c->value;
+                    n->ready = true;
+                }
+            }
+            // Values are final; only nodes gradients flow through keep their operands
+            for (const auto& [node, c] : canonical) {
+                if (c->ready && !c->requires_grad) c->inputs.clear();
+            }
+            for (const NodePtr& n : original) {
+                if (n->ready && !n->requires_grad) n->inputs.clear();
+            }
+        }
+
+        std::vector<af::array> values;
+        values.reserve(roots.size());
+        for (const NodePtr& r : roots) values.push_back(r->value);
+        return values;
+    }
+
+    std::vector<NodePtr> grad_inputs(const NodePtr& root) {
+        std::lock_guard<std::mutex> lock(graph_mutex);
+        std::vector<NodePtr> inputs;
+        std::unordered_set<std::string> seen;
+        for (const NodePtr& n : post_order({ root }, [](const Node& n) { return !n.requires_grad; })) {
+            if (n->op == Op::Input && n->requires_grad && n->source && seen.insert(key(*n)).second) {
+                inputs.push_back(n);
+            }
+        }
+        return inputs;
+    }
+
+    std::vector<NodePtr> gradients(const NodePtr& root, const NodePtr& seed, const std::vector<NodePtr>& wrt) {
+        std::lock_guard<std::mutex> lock(graph_mutex);
+        std::vector<NodePtr> order = post_order({ root }, [](const Node& n) {
+            return !n.requires_grad || n.op == Op::Input;
+        });
+
+        std::unordered_map<const Node*, NodePtr> grads;
+        grads[root.get()] = seed;
+        auto accumulate = [&](const NodePtr& node, NodePtr g) {
+            if (!node->requires_grad) return;
+            auto [it, inserted] = grads.try_emplace(node.get(), g);
+            if (!inserted) it->second = make_node(Op::Add, { it->second, std::move(g) }, node->shape);
+        };
+
+        // Reverse topological order: a node's gradient is complete before it is propagated
+        for (auto it = order.rbegin(); it != order.rend(); ++it) {
+            const NodePtr& y = *it;
+            auto found = grads.find(y.get());
+            if (found == grads.end() || y->inputs.empty()) continue;
+            const NodePtr g = found->second;
+            auto node = [&](Op op, std::vector<NodePtr> in, float s = 0.0f) {
+                return make_node(op, std::move(in), y->shape, s);
+            };
+            const NodePtr& x = y->inputs[0];
+            const float s = y->scalar;
+
+            switch (y->op) {
+                case Op::Add:
+                    accumulate(x, g);
+                    accumulate(y->inputs[1], g);
+                    break;
+                case Op::Sub:
+                    accumulate(x, g);
+                    accumulate(y->inputs[1], node(Op::Neg, { g }));
+                    break;
+                case Op::Mul:
+                    accumulate(x, node(Op::Mul, { g, y->inputs[1] }));
+                    accumulate(y->inputs[1], node(Op::Mul, { g, x }));
+                    break;
+                case Op::Div:
+                    // d(a/b)/db = -(a/b) / b
+                    accumulate(x, node(Op::Div, { g, y->inputs[1] }));
+                    accumulate(y->inputs[1], node(Op::Neg, { node(Op::Div, { node(Op::Mul, { g, y }), y->inputs[1] }) }));
+                    break;
+                case Op::AddScalar:  accumulate(x, g); break;
+                case Op::MulScalar:  accumulate(x, node(Op::MulScalar, { g }, s)); break;
+                case Op::DivScalar:  accumulate(x, node(Op::DivScalar, { g }, s)); break;
+                case Op::RSubScalar: accumulate(x, node(Op::Neg, { g })); break;
+                case Op::RDivScalar:
+                    accumulate(x, node(Op::Neg, { node(Op::Div, { node(Op::Mul, { g, y }), x }) }));
+                    break;
+                case Op::PowScalar:
+                    accumulate(x, node(Op::Mul, { g, node(Op::MulScalar, { node(Op::PowScalar, { x }, s - 1.0f) }, s) }));
+                    break;
+                case Op::RPowScalar:
+                    accumulate(x, node(Op::MulScalar, { node(Op::Mul, { g, y }) }, std::log(s)));
+                    break;
+                case Op::Neg:        accumulate(x, node(Op::Neg, { g })); break;
+                case Op::Exp:        accumulate(x, node(Op::Mul, { g, y })); break;
+                case Op::Log:        accumulate(x, node(Op::Div, { g, x })); break;
+                case Op::Relu:       accumulate(x, node(Op::Mul, { g, node(Op::Step, { y }) })); break;
+                case Op::Sigmoid:
+                    accumulate(x, node(Op::Mul, { g, node(Op::Mul, { y, node(Op::RSubScalar, { y }, 1.0f) }) }));
+                    break;
+                case Op::Tanh:
+                    accumulate(x, node(Op::Mul, { g, node(Op::RSubScalar, { node(Op::Mul, { y, y }) }, 1.0f) }));
+                    break;
+                case Op::Expand:
+                    accumulate(x, make_node(Op::ReduceTo, { g }, x->shape));
+                    break;
+                case Op::Sum:
+                case Op::Mean: {
+                    NodePtr e = make_node(Op::ExpandReduction, { g }, x->shape);
+                    e->reduction = y->reduction;
+                    if (y->op == Op::Mean) {
+                        e = make_node(Op::DivScalar, { e }, x->shape, static_cast<float>(y->reduction.count()));
+                    }
+                    accumulate(x, e);
+                    break;
+                }
+                default:
+                    break;   // Constants, and ops that only appear in gradients
+            }
+        }
+
+        // The same tensor may be read through several input nodes
+        std::vector<NodePtr> result(wrt.size());
+        for (size_t i = 0; i < wrt.size(); ++i) {
+            const std::string k = key(*wrt[i]);
+            for (const NodePtr& n : order) {
+                auto found = grads.find(n.get());
+                if (n->op != Op::Input || found == grads.end() || key(*n) != k) continue;
+                result[i] = result[i] ? make_node(Op::Add, { result[i], found->second }, n->shape) : found->second;
+            }
+        }
+        return result;
+    }
+
+}
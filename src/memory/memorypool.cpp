@@ -0,0 +1,382 @@
+#include "memory/memorypool.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <arrayfire.h>
+
+namespace cppgrad {
+
+    namespace {
+
+        constexpr size_t kSmallStep = 512;          // Size-class granularity up to kLargeStep
+        constexpr size_t kLargeStep = 1 << 20;      // Size-class granularity above it
+
+        /// Book-keeping for a buffer ArrayFire currently holds.
+        struct Block {
+            size_t size = 0;                // Rounded size; 0 for caller-owned memory
+            int device = 0;
+            bool manager_locked = false;    // Held by an af::array
+            bool user_locked = false;       // Pinned via af::array::lock()
+            bool owned = true;              // Allocated by the pool (false: user_lock on foreign memory)
+        };
+
+        struct PoolState {
+            std::mutex mutex;
+            MemoryPoolOptions options;
+            MemoryStats stats;
+            std::unordered_map<void*, Block> live;
+            std::map<std::pair<int, size_t>, std::vector<void*>> free_lists;    // (device, size) -> idle buffers
+        };
+
+        // Never destroyed: ArrayFire frees buffers during static destruction.
+        PoolState& pool() {
+            static PoolState* state = new PoolState();
+            return *state;
+        }
+
+        std::mutex install_mutex;
+        af_memory_manager installed_handle = nullptr;
+
+        size_t size_class(size_t bytes) {
+            if (bytes == 0) bytes = 1;
+            const size_t step = bytes <= kLargeStep ? kSmallStep : kLargeStep;
+            return (bytes + step - 1) / step * step;
+        }
+
+        int active_device(af_memory_manager handle) {
+            int device = 0;
+            af_memory_manager_get_active_device_id(handle, &device);
+            return device;
+        }
+
+        void check(af_err err, const char* what) {
+            if (err != AF_SUCCESS) {
+                throw std::runtime_error(std::string("MemoryPool: ") + what + " failed (af_err " + std::to_string(err) + ")");
+            }
+        }
+
+        /// Return idle buffers of `device` to the driver, largest classes first,
+        /// until at most `keep_bytes` remain cached. Caller holds the state mutex.
+        void trim_cache_locked(af_memory_manager handle, PoolState& s, int device, size_t keep_bytes) {
+            for (auto it = s.free_lists.rbegin(); it != s.free_lists.rend() && s.stats.cached_bytes > keep_bytes; ++it) {
+                if (it->first.first != device) continue;
+                const size_t size = it->first.second;
+                auto& buffers = it->second;
+                while (!buffers.empty() && s.stats.cached_bytes > keep_bytes) {
+                    af_memory_manager_native_free(handle, buffers.back());
+                    buffers.pop_back();
+                    s.stats.cached_bytes -= size;
+                    ++s.stats.native_free_count;
+                }
+            }
+        }
+
+        void record_live_locked(PoolState& s, void* ptr, const Block& block) {
+            s.live[ptr] = block;
+            s.stats.current_bytes += block.size;
+            s.stats.peak_bytes = std::max(s.stats.peak_bytes, s.stats.current_bytes);
+            s.stats.step_peak_bytes = std::max(s.stats.step_peak_bytes, s.stats.current_bytes);
+        }
+
+        // ----------------------------------------
+        // ArrayFire memory manager callbacks
+        // ----------------------------------------
+
+        af_err pool_initialize(af_memory_manager) {
+            return AF_SUCCESS;
+        }
+
+        af_err pool_shutdown(af_memory_manager handle) {
+            PoolState& s = pool();
+            std::lock_guard<std::mutex> lock(s.mutex);
+            trim_cache_locked(handle, s, active_device(handle), 0);
+            return AF_SUCCESS;
+        }
+
+        af_err pool_alloc(af_memory_manager handle, void** ptr, int user_lock,
+                          const unsigned ndims, dim_t* dims, const unsigned element_size) {
+            size_t bytes = element_size;
+            for (unsigned i = 0; i < ndims; ++i) bytes *= static_cast<size_t>(dims[i]);
+            const size_t size = size_class(bytes);
+            const int device = active_device(handle);
+
+            PoolState& s = pool();
+            std::lock_guard<std::mutex> lock(s.mutex);
+            *ptr = nullptr;
+            ++s.stats.alloc_count;
+
+            try {
+                auto cached = s.free_lists.find({ device, size });
+                if (cached != s.free_lists.end() && !cached->second.empty()) {
+                    *ptr = cached->second.back();
+                    cached->second.pop_back();
+                    s.stats.cached_bytes -= size;
+                    ++s.stats.cache_hits;
+                } else {
+                    ++s.stats.cache_misses;
+                    const size_t limit = s.options.max_bytes;
+                    if (limit != 0 && s.stats.current_bytes + s.stats.cached_bytes + size > limit) {
+                        trim_cache_locked(handle, s, device, 0);
+                    }
+                    if (limit != 0 && s.stats.current_bytes + s.stats.cached_bytes + size > limit) {
+                        return AF_ERR_NO_MEM;
+                    }
+
+                    void* fresh = nullptr;
+                    if (af_memory_manager_native_alloc(handle, &fresh, size) != AF_SUCCESS || fresh == nullptr) {
+                        // Driver is out of memory: drop the cache and retry once.
+                        trim_cache_locked(handle, s, device, 0);
+                        fresh = nullptr;
+                        if (af_memory_manager_native_alloc(handle, &fresh, size) != AF_SUCCESS || fresh == nullptr) {
+                            return AF_ERR_NO_MEM;
+                        }
+                    }
+                    ++s.stats.native_alloc_count;
+                    *ptr = fresh;
+                }
+
+                record_live_locked(s, *ptr, Block{ size, device, true, user_lock != 0, true });
+            } catch (const std::exception&) {
+                return AF_ERR_NO_MEM;
+            }
+            return AF_SUCCESS;
+        }
+
+        af_err pool_allocated(af_memory_manager, size_t* size, void* ptr) {
+            PoolState& s = pool();
+            std::lock_guard<std::mutex> lock(s.mutex);
+            auto it = s.live.find(ptr);
+            *size = it == s.live.end() ? 0 : it->second.size;
+            return AF_SUCCESS;
+        }
+
+        af_err pool_unlock(af_memory_manager handle, void* ptr, int user_unlock) {
+            if (ptr == nullptr) return AF_SUCCESS;
+
+            PoolState& s = pool();
+            std::lock_guard<std::mutex> lock(s.mutex);
+            auto it = s.live.find(ptr);
+            if (it == s.live.end()) {
+                // Allocated before install, or handed over with afDevice: ArrayFire owns it.
+                af_memory_manager_native_free(handle, ptr);
+                return AF_SUCCESS;
+            }
+
+            Block& block = it->second;
+            if (user_unlock) block.user_locked = false;
+            else block.manager_locked = false;
+            if (block.manager_locked || block.user_locked) return AF_SUCCESS;
+
+            const Block done = block;
+            s.live.erase(it);
+            if (!done.owned) return AF_SUCCESS;     // Caller-owned memory is never freed or cached
+
+            s.stats.current_bytes -= done.size;
+            const size_t cap = s.options.max_cached_bytes;
+            if (cap != 0 && s.stats.cached_bytes + done.size > cap) {
+                af_memory_manager_native_free(handle, ptr);
+                ++s.stats.native_free_count;
+                return AF_SUCCESS;
+            }
+            try {
+                s.free_lists[{ done.device, done.size }].push_back(ptr);
+                s.stats.cached_bytes += done.size;
+            } catch (const std::exception&) {
+                af_memory_manager_native_free(handle, ptr);
+                ++s.stats.native_free_count;
+            }
+            return AF_SUCCESS;
+        }
+
+        af_err pool_signal_memory_cleanup(af_memory_manager handle) {
+            PoolState& s = pool();
+            std::lock_guard<std::mutex> lock(s.mutex);
+            trim_cache_locked(handle, s, active_device(handle), 0);
+            return AF_SUCCESS;
+        }
+
+        af_err pool_print_info(af_memory_manager, char* msg, int) {
+            MemoryStats st = MemoryPool::stats();
+            if (msg != nullptr) std::cout << msg;
+            std::cout << "cppgrad memory pool: " << st.current_bytes << " B in use, "
+                      << st.cached_bytes << " B cached, " << st.peak_bytes << " B peak, "
+                      << st.alloc_count << " allocs, hit rate " << st.hit_rate() << "\n";
+            return AF_SUCCESS;
+        }
+
+        af_err pool_user_lock(af_memory_manager handle, void* ptr) {
+            PoolState& s = pool();
+            std::lock_guard<std::mutex> lock(s.mutex);
+            auto it = s.live.find(ptr);
+            if (it != s.live.end()) {
+                it->second.user_locked = true;
+            } else {
+                s.live[ptr] = Block{ 0, active_device(handle), false, true, false };
+            }
+            return AF_SUCCESS;
+        }
+
+        af_err pool_user_unlock(af_memory_manager handle, void* ptr) {
+            return pool_unlock(handle, ptr, 1);
+        }
+
+        af_err pool_is_user_locked(af_memory_manager, int* out, void* ptr) {
+            PoolState& s = pool();
+            std::lock_guard<std::mutex> lock(s.mutex);
+            auto it = s.live.find(ptr);
+            *out = it != s.live.end() && it->second.user_locked;
+            return AF_SUCCESS;
+        }
+
+        af_err pool_get_memory_pressure(af_memory_manager, float* pressure) {
+            PoolState& s = pool();
+            std::lock_guard<std::mutex> lock(s.mutex);
+            const size_t limit = s.options.max_bytes;
+            *pressure = limit == 0 ? 0.0f
+                : static_cast<float>(s.stats.current_bytes + s.stats.cached_bytes) / static_cast<float>(limit);
+            return AF_SUCCESS;
+        }
+
+        /// Same heuristic as ArrayFire's default manager (evaluate a JIT tree once
+        /// its buffers reach half the memory in use), plus the hard cap.
+        af_err pool_jit_tree_exceeds_memory_pressure(af_memory_manager, int* out, size_t bytes) {
+            PoolState& s = pool();
+            std::lock_guard<std::mutex> lock(s.mutex);
+            const size_t limit = s.options.max_bytes;
+            *out = 2 * bytes > s.stats.current_bytes ||
+                   (limit != 0 && s.stats.current_bytes + bytes > limit);
+            return AF_SUCCESS;
+        }
+
+        // Devices are tracked lazily through the (device, size) free-list key.
+        void pool_add_memory_management(af_memory_manager, int) { }
+        void pool_remove_memory_management(af_memory_manager, int) { }
+
+    } // namespace
+
+    // ----------------------------------------
+    // MemoryPool
+    // ----------------------------------------
+
+    /// Register the pool as ArrayFire's memory manager. Calling it again only
+    /// updates the options.
+    void MemoryPool::install(const MemoryPoolOptions& options) {
+        std::lock_guard<std::mutex> guard(install_mutex);
+        set_options(options);
+        if (installed_handle != nullptr) return;
+
+        af_memory_manager handle = nullptr;
+        check(af_create_memory_manager(&handle), "af_create_memory_manager");
+        check(af_memory_manager_set_initialize_fn(handle, pool_initialize), "set_initialize_fn");
+        check(af_memory_manager_set_shutdown_fn(handle, pool_shutdown), "set_shutdown_fn");
+        check(af_memory_manager_set_alloc_fn(handle, pool_alloc), "set_alloc_fn");
+        check(af_memory_manager_set_allocated_fn(handle, pool_allocated), "set_allocated_fn");
+        check(af_memory_manager_set_unlock_fn(handle, pool_unlock), "set_unlock_fn");
+        check(af_memory_manager_set_signal_memory_cleanup_fn(handle, pool_signal_memory_cleanup), "set_signal_memory_cleanup_fn");
+        check(af_memory_manager_set_print_info_fn(handle, pool_print_info), "set_print_info_fn");
+        check(af_memory_manager_set_user_lock_fn(handle, pool_user_lock), "set_user_lock_fn");
+        check(af_memory_manager_set_user_unlock_fn(handle, pool_user_unlock), "set_user_unlock_fn");
+        check(af_memory_manager_set_is_user_locked_fn(handle, pool_is_user_locked), "set_is_user_locked_fn");
+        check(af_memory_manager_set_get_memory_pressure_fn(handle, pool_get_memory_pressure), "set_get_memory_pressure_fn");
+        check(af_memory_manager_set_jit_tree_exceeds_memory_pressure_fn(handle, pool_jit_tree_exceeds_memory_pressure), "set_jit_tree_exceeds_memory_pressure_fn");
+        check(af_memory_manager_set_add_memory_management_fn(handle, pool_add_memory_management), "set_add_memory_management_fn");
+        check(af_memory_manager_set_remove_memory_management_fn(handle, pool_remove_memory_management), "set_remove_memory_management_fn");
+        check(af_set_memory_manager(handle), "af_set_memory_manager");
+        installed_handle = handle;
+    }
+
+    /// Restore ArrayFire's default manager. Only safe once every tensor allocated
+    /// through the pool has been destroyed.
+    void MemoryPool::uninstall() {
+        std::lock_guard<std::mutex> guard(install_mutex);
+        if (installed_handle == nullptr) return;
+
+        check(af_unset_memory_manager(), "af_unset_memory_manager");
+        check(af_release_memory_manager(installed_handle), "af_release_memory_manager");
+        installed_handle = nullptr;
+
+        PoolState& s = pool();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.live.clear();
+        s.free_lists.clear();
+        s.stats = MemoryStats{};
+    }
+
+    bool MemoryPool::is_installed() {
+        std::lock_guard<std::mutex> guard(install_mutex);
+        return installed_handle != nullptr;
+    }
+
+    void MemoryPool::set_options(const MemoryPoolOptions& options) {
+        PoolState& s = pool();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.options = options;
+    }
+
+    MemoryPoolOptions MemoryPool::options() {
+        PoolState& s = pool();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return s.options;
+    }
+
+    MemoryStats MemoryPool::stats() {
+        PoolState& s = pool();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        MemoryStats out = s.stats;
+        out.reserved_bytes = out.current_bytes + out.cached_bytes;
+        return out;
+    }
+
+    void MemoryPool::reset_peak() {
+        PoolState& s = pool();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.stats.peak_bytes = s.stats.current_bytes;
+        s.stats.step_peak_bytes = s.stats.current_bytes;
+    }
+
+    /// Release the active device's idle buffers.
+    void MemoryPool::release_cached() {
+        if (!is_installed()) return;
+        PoolState& s = pool();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        trim_cache_locked(installed_handle, s, active_device(installed_handle), 0);
+    }
+
+    void MemoryPool::begin_step() {
+        PoolState& s = pool();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.stats.step_peak_bytes = s.stats.current_bytes;
+    }
+
+    /// Trim the active device's cache back to `max_cached_bytes` (no-op when
+    /// the cache is unbounded).
+    void MemoryPool::end_step() {
+        if (!is_installed()) return;
+        PoolState& s = pool();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        if (s.options.max_cached_bytes == 0) return;
+        trim_cache_locked(installed_handle, s, active_device(installed_handle), s.options.max_cached_bytes);
+    }
+
+    MemoryStats memory_stats() {
+        return MemoryPool::stats();
+    }
+
+    //----------------MemoryStepGuard---------------------------
+    MemoryStepGuard::MemoryStepGuard() {
+        MemoryPool::begin_step();
+    }
+
+    MemoryStepGuard::~MemoryStepGuard() {
+        MemoryPool::end_step();
+    }
+
+}
@@ -0,0 +1,30 @@
+#include "nn/activation.hpp"
+#include "ops/gelu.hpp"
+#include "ops/relu.hpp"
+#include "ops/sigmoid.hpp"
+#include "ops/silu.hpp"
+#include "ops/tanh.hpp"
+
+namespace cppgrad::nn {
+
+    Tensor ReLU::forward(const Tensor& x) {
+        return relu(x);
+    }
+
+    Tensor Sigmoid::forward(const Tensor& x) {
+        return sigmoid(x);
+    }
+
+    Tensor Tanh::forward(const Tensor& x) {
+        return tanh(x);
+    }
+
+    Tensor GELU::forward(const Tensor& x) {
+        return gelu(x);
+    }
+
+    Tensor SiLU::forward(const Tensor& x) {
+        return silu(x);
+    }
+
+}
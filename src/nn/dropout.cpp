@@ -0,0 +1,20 @@
+#include "nn/dropout.hpp"
+#include "ops/dropout.hpp"
+
+#include <stdexcept>
+#include <string>
+
+namespace cppgrad::nn {
+
+    Dropout::Dropout(float p)
+    : p_(p) {
+        if (p < 0.0f || p > 1.0f) {
+            throw std::runtime_error("nn::Dropout: probability " + std::to_string(p) + " not in [0, 1]");
+        }
+    }
+
+    Tensor Dropout::forward(const Tensor& x) {
+        return dropout(x, p_, is_training());
+    }
+
+}
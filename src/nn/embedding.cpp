@@ -0,0 +1,15 @@
+#include "nn/embedding.hpp"
+#include "ops/embedding.hpp"
+
+namespace cppgrad::nn {
+
+    Embedding::Embedding(size_t num_embeddings, size_t dim)
+    : weight_(Tensor::randn({ num_embeddings, dim }, /*requires_grad=*/true)) {
+        register_parameter("weight", weight_);
+    }
+
+    Tensor Embedding::forward(const Tensor& indices) {
+        return embedding(indices, weight_);
+    }
+
+}
@@ -0,0 +1,28 @@
+#include "nn/linear.hpp"
+#include "autograd/gradmode.hpp"
+
+#include <cmath>
+
+namespace cppgrad::nn {
+
+    Linear::Linear(size_t in_features, size_t out_features, bool bias, Activation activation)
+    : weight_(Tensor::randn({ out_features, in_features }, /*requires_grad=*/true)),
+      bias_(Tensor::zeros({ out_features }, /*requires_grad=*/bias)),
+      has_bias_(bias),
+      activation_(activation) {
+        {
+            NoGradGuard no_grad;
+            weight_.mul_(1.0f / std::sqrt(static_cast<float>(in_features)));
+        }
+        register_parameter("weight", weight_);
+        if (has_bias_) register_parameter("bias", bias_);
+    }
+
+    Linear::Linear(size_t in_features, size_t out_features, Activation activation)
+    : Linear(in_features, out_features, true, activation) {}
+
+    Tensor Linear::forward(const Tensor& x) {
+        return has_bias_ ? linear(x, weight_, bias_, activation_) : linear(x, weight_, activation_);
+    }
+
+}
@@ -0,0 +1,98 @@
+#include "nn/module.hpp"
+#include "autograd/gradmode.hpp"
+#include "tensor/shapeutils.hpp"
+
+#include <stdexcept>
+#include <unordered_set>
+
+namespace cppgrad::nn {
+
+    Tensor Module::operator()(const Tensor& x) {
+        if (training_) return forward(x);
+        NoGradGuard no_grad;
+        return forward(x);
+    }
+
+    void Module::check_name(const std::string& name) const {
+        if (name.empty() || name.find('.') != std::string::npos) {
+            throw std::runtime_error("nn::Module: invalid name '" + name + "'");
+        }
+        auto taken = [&](const auto& entries) {
+            for (const auto& [n, _] : entries) {
+                if (n == name) return true;
+            }
+            return false;
+        };
+        if (taken(parameters_) || taken(buffers_) || taken(children_)) {
+            throw std::runtime_error("nn::Module: name '" + name + "' already registered");
+        }
+    }
+
+    Tensor Module::register_parameter(const std::string& name, Tensor tensor) {
+        check_name(name);
+        if (!tensor.requires_grad()) {
+            throw std::runtime_error("nn::Module: parameter '" + name + "' of shape " +
+                                     ShapeUtils::to_string(tensor.shape()) + " does not require grad");
+        }
+        parameters_.emplace_back(name, tensor);
+        return tensor;
+    }
+
+    Tensor Module::register_buffer(const std::string& name, Tensor tensor) {
+        check_name(name);
+        buffers_.emplace_back(name, tensor);
+        return tensor;
+    }
+
+    void Module::add_child(const std::string& name, std::shared_ptr<Module> module) {
+        check_name(name);
+        if (module == nullptr) throw std::runtime_error("nn::Module: child '" + name + "' is null");
+        module->train(training_);
+        children_.emplace_back(name, std::move(module));
+    }
+
+    void Module::collect(const std::string& prefix, bool buffers, std::vector<std::pair<std::string, Tensor>>& out,
+                         std::unordered_set<const TensorImpl*>& seen) const {
+        // A module shared between two parents contributes its tensors once
+        for (const auto& [name, tensor] : buffers ? buffers_ : parameters_) {
+            if (seen.insert(tensor.impl().get()).second) out.emplace_back(prefix + name, tensor);
+        }
+        for (const auto& [name, child] : children_) child->collect(prefix + name + ".", buffers, out, seen);
+    }
+
+    std::vector<std::pair<std::string, Tensor>> Module::named_parameters() const {
+        std::vector<std::pair<std::string, Tensor>> out;
+        std::unordered_set<const TensorImpl*> seen;
+        collect("", false, out, seen);
+        return out;
+    }
+
+    std::vector<Tensor> Module::parameters() const {
+        std::vector<Tensor> out;
+        for (auto& [_, tensor] : named_parameters()) out.push_back(tensor);
+        return out;
+    }
+
+    std::vector<std::pair<std::string, Tensor>> Module::named_buffers() const {
+        std::vector<std::pair<std::string, Tensor>> out;
+        std::unordered_set<const TensorImpl*> seen;
+        collect("", true, out, seen);
+        return out;
+    }
+
+    std::vector<Tensor> Module::buffers() const {
+        std::vector<Tensor> out;
+        for (auto& [_, tensor] : named_buffers()) out.push_back(tensor);
+        return out;
+    }
+
+    void Module::train(bool on) {
+        training_ = on;
+        for (auto& [_, child] : children_) child->train(on);
+    }
+
+    void Module::zero_grad() const {
+        for (const Tensor& p : parameters()) p.zero_grad();
+    }
+
+}
@@ -0,0 +1,22 @@
+#include "nn/sequential.hpp"
+
+#include <string>
+
+namespace cppgrad::nn {
+
+    Sequential::Sequential(std::vector<std::shared_ptr<Module>> layers) {
+        for (auto& layer : layers) push_back(std::move(layer));
+    }
+
+    Sequential& Sequential::push_back(std::shared_ptr<Module> layer) {
+        layers_.push_back(register_module(std::to_string(layers_.size()), std::move(layer)));
+        return *this;
+    }
+
+    Tensor Sequential::forward(const Tensor& x) {
+        Tensor out = x;
+        for (auto& layer : layers_) out = layer->forward(out);
+        return out;
+    }
+
+}
@@ -1,33 +1,63 @@
 #include "ops/add.hpp"
+#include "autograd/capture.hpp"
 #include "autograd/function.hpp"
+#include "autograd/gradmode.hpp"
+#include "lazy/graph.hpp"
+#include "lazy/lazymode.hpp"
+#include "tensor/broadcast.hpp"
 #include "tensor/tensor.hpp"
 
-#include <stdexcept>
 
 
 namespace cppgrad {
 
     Tensor operator+(const Tensor& a, const Tensor& b) {
-        //will change this once broadcasting is implemented, for now it will throw and error if shape doesnt match
-        if (a.shape() != b.shape())
-            throw std::runtime_error("shape mismatch");
+        if (LazyMode::is_enabled()) return Tensor(lazy::record_binary(lazy::Op::Add, a.impl_, b.impl_));
 
-        Tensor out(a.data() + b.data(),
-                   a.requires_grad() || b.requires_grad());
+        // Broadcast operands (throws if the shapes are incompatible)
+        Shape shape = Broadcast::result_shape(a.shape(), b.shape());
+
+        Tensor out(Broadcast::expand(a.data(), a.shape(), shape) + Broadcast::expand(b.data(), b.shape(), shape),
+                   GradMode::is_enabled() && (a.requires_grad() || b.requires_grad()), shape);
 
         if (out.requires_grad() && out.impl_->grad_fn() == nullptr) {
             auto fn = std::make_shared<AddFunction>();
-            fn->inputs = { a.impl_, b.impl_ };
+            fn->set_inputs({ a.impl_, b.impl_ });
             out.impl_->grad_fn() = fn;   // PIMPL: grad_fn lives in impl_
         }
 
+        if (Tape::is_recording()) {
+            Tape::record(out.impl_, { a.impl_, b.impl_ }, [sa = a.shape(), sb = b.shape(), shape](const Tape::Arrays& in) {
+                return Tape::Arrays{ Broadcast::expand(in[0], sa, shape) + Broadcast::expand(in[1], sb, shape) };
+            });
+        }
+
         return out;
     }
 
+    // Scalar overloads pass the float straight to ArrayFire instead of
+    // materializing a full tensor of it.
     Tensor operator+(const Tensor& lhs, float scalar) {
-        return lhs + Tensor::full(lhs.shape(), scalar, false);
+        if (LazyMode::is_enabled()) return Tensor(lazy::record_unary(lazy::Op::AddScalar, lhs.impl_, scalar));
+
+        Tensor out(lhs.data() + scalar,
+                   GradMode::is_enabled() && lhs.requires_grad(), lhs.shape());
+
+        if (out.requires_grad() && out.impl_->grad_fn() == nullptr) {
+            auto fn = std::make_shared<AddScalarFunction>();
+            fn->set_inputs({ lhs.impl_ });
+            out.impl_->grad_fn() = fn;
+        }
+
+        if (Tape::is_recording()) {
+            Tape::record(out.impl_, { lhs.impl_ }, [scalar](const Tape::Arrays& in) {
+                return Tape::Arrays{ in[0] + scalar };
+            });
+        }
+
+        return out;
     }
     Tensor operator+(float scalar, const Tensor& rhs) {
-        return rhs + Tensor::full(rhs.shape(), scalar, false);
+        return rhs + scalar;
     }
 }
@@ -0,0 +1,31 @@
+#include "ops/avg_pool2d.hpp"
+#include "autograd/function.hpp"
+#include "autograd/gradmode.hpp"
+#include "tensor/imagelayout.hpp"
+#include "tensor/tensor.hpp"
+
+namespace cppgrad {
+
+    Tensor avg_pool2d(const Tensor& x, size_t kernel, size_t stride, size_t padding) {
+        const Shape& xs = x.shape();
+        ImageLayout::check_nchw(xs, "avg_pool2d");
+        if (stride == 0) stride = kernel;
+        const size_t OH = ImageLayout::output_size(xs[2], kernel, stride, padding);
+        const size_t OW = ImageLayout::output_size(xs[3], kernel, stride, padding);
+
+        // unwrap zero-pads, so padded positions count towards every mean
+        af::array windows = af::unwrap(ImageLayout::to_image(x.data()), kernel, kernel,
+                                       stride, stride, padding, padding, true);
+        af::array y = ImageLayout::from_image(af::moddims(af::mean(windows, 0), OH, OW, xs[1], xs[0]));
+
+        Tensor out(y, GradMode::is_enabled() && x.requires_grad(), Shape{ xs[0], xs[1], OH, OW });
+
+        if (out.requires_grad() && out.impl_->grad_fn() == nullptr) {
+            auto fn = std::make_shared<AvgPool2dFunction>(xs, kernel, stride, padding);
+            fn->set_inputs({ x.impl_ });
+            out.impl_->grad_fn() = fn;
+        }
+        return out;
+    }
+
+}
@@ -0,0 +1,111 @@
+#include "ops/batch_norm.hpp"
+#include "autograd/function.hpp"
+#include "autograd/gradmode.hpp"
+#include "tensor/reduction.hpp"
+#include "tensor/shapeutils.hpp"
+#include "tensor/tensor.hpp"
+
+#include <stdexcept>
+
+namespace cppgrad {
+
+    namespace {
+
+        /// Every axis but the channel axis 1.
+        std::vector<int> batch_axes(const Shape& shape) {
+            std::vector<int> dims{ 0 };
+            for (int i = 2; i < static_cast<int>(shape.size()); ++i) dims.push_back(i);
+            return dims;
+        }
+
+        void check_channels(const Tensor& t, size_t channels, const char* what) {
+            if (t.shape() != Shape{ channels }) {
+                throw std::runtime_error(std::string("batch_norm: ") + what + " must have shape [" +
+                                         std::to_string(channels) + "], got " + ShapeUtils::to_string(t.shape()));
+            }
+        }
+
+        /// running = (1 - momentum) * running + momentum * batch, in one pass over
+        /// the existing buffer; bumps the version like any in-place op.
+        void update_running(const Tensor& stat, const af::array& batch, float momentum) {
+            TensorImpl& impl = *stat.impl();
+            af::array& data = impl.data();
+            data(af::span, af::span, af::span, af::span) =
+                (1.0f - momentum) * data + momentum * af::moddims(batch, data.dims());
+            impl.bump_version();
+        }
+
+        /// Forward of `batch_norm`; `weight` and `bias` are both null or both set.
+        /// Statistics live in the (before, 1, after) layout of the per-channel
+        /// `Reduction`, which is the channel order of a `(C)` tensor.
+        std::shared_ptr<TensorImpl> batch_norm_forward(const Tensor& x, const Tensor& running_mean,
+                                                       const Tensor& running_var, const Tensor* weight,
+                                                       const Tensor* bias, const BatchNormOptions& options) {
+            const Shape& shape = x.shape();
+            if (shape.size() < 2 || shape.size() > 4) {
+                throw std::runtime_error("batch_norm: expected (N, C), (N, C, L) or (N, C, H, W) input, got " +
+                                         ShapeUtils::to_string(shape));
+            }
+            const size_t C = shape[1];
+            check_channels(running_mean, C, "running_mean");
+            check_channels(running_var, C, "running_var");
+            if (running_mean.requires_grad() || running_var.requires_grad()) {
+                throw std::runtime_error("batch_norm: running statistics must not require grad");
+            }
+            if (weight != nullptr) {
+                check_channels(*weight, C, "weight");
+                check_channels(*bias, C, "bias");
+            }
+
+            const Reduction r(shape, batch_axes(shape), false);
+            const af::dim4 stat_dims(r.grouped()[0], 1, r.grouped()[2]);
+            const unsigned n = static_cast<unsigned>(r.count());
+
+            af::array xg = r.group(x.data());
+            af::array mean, var;
+            if (options.training) {
+                af::meanvar(mean, var, xg, af::array(), AF_VARIANCE_POPULATION, 1);
+
+                // Running statistics track the unbiased batch variance, as PyTorch does
+                const float bessel = n > 1 ? static_cast<float>(n) / static_cast<float>(n - 1) : 1.0f;
+                update_running(running_mean, mean, options.momentum);
+                update_running(running_var, var * bessel, options.momentum);
+            } else {
+                mean = af::moddims(running_mean.data(), stat_dims);
+                var = af::moddims(running_var.data(), stat_dims);
+            }
+            af::array rstd = af::rsqrt(var + options.eps);
+
+            af::array y = (xg - af::tile(mean, 1, n)) * af::tile(rstd, 1, n);
+            if (weight != nullptr) {
+                y = y * af::tile(af::moddims(weight->data(), stat_dims), 1, n) +
+                    af::tile(af::moddims(bias->data(), stat_dims), 1, n);
+            }
+
+            const bool requires_grad = GradMode::is_enabled() &&
+                (x.requires_grad() || (weight != nullptr && (weight->requires_grad() || bias->requires_grad())));
+            auto impl = std::make_shared<TensorImpl>(r.ungroup(y), shape, requires_grad);
+
+            if (requires_grad) {
+                auto fn = std::make_shared<BatchNormFunction>(r, options.training);
+                if (weight != nullptr) fn->set_inputs({ x.impl(), weight->impl(), bias->impl() });
+                else fn->set_inputs({ x.impl() });
+                fn->save_for_backward({ mean, rstd });
+                impl->grad_fn() = fn;
+            }
+            return impl;
+        }
+
+    } // namespace
+
+    Tensor batch_norm(const Tensor& x, Tensor& running_mean, Tensor& running_var,
+                      const Tensor& weight, const Tensor& bias, const BatchNormOptions& options) {
+        return Tensor(batch_norm_forward(x, running_mean, running_var, &weight, &bias, options));
+    }
+
+    Tensor batch_norm(const Tensor& x, Tensor& running_mean, Tensor& running_var,
+                      const BatchNormOptions& options) {
+        return Tensor(batch_norm_forward(x, running_mean, running_var, nullptr, nullptr, options));
+    }
+
+}
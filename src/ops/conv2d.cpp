@@ -0,0 +1,104 @@
+#include "ops/conv2d.hpp"
+#include "autograd/function.hpp"
+#include "autograd/gradmode.hpp"
+#include "tensor/imagelayout.hpp"
+#include "tensor/shapeutils.hpp"
+#include "tensor/tensor.hpp"
+
+#include <stdexcept>
+
+namespace cppgrad {
+
+    namespace {
+
+        // Above this the im2col buffer costs more than the GEMM saves
+        constexpr size_t kMaxIm2colBytes = size_t(512) << 20;
+
+        ConvAlgorithm choose_algorithm(const Conv2dOptions& options, size_t column_bytes) {
+            if (options.algorithm == ConvAlgorithm::Im2col && options.dilation != 1) {
+                throw std::runtime_error("conv2d: the im2col path does not support dilation");
+            }
+            if (options.algorithm != ConvAlgorithm::Auto) return options.algorithm;
+            if (options.dilation != 1 || column_bytes > kMaxIm2colBytes) return ConvAlgorithm::Direct;
+            return ConvAlgorithm::Im2col;
+        }
+
+        /// Forward of `conv2d`; `bias` may be null.
+        std::shared_ptr<TensorImpl> conv2d_forward(const Tensor& x, const Tensor& weight, const Tensor* bias,
+                                                   Conv2dOptions options) {
+            const Shape& xs = x.shape();
+            const Shape& ws = weight.shape();
+            ImageLayout::check_nchw(xs, "conv2d");
+            const size_t groups = options.groups;
+            if (ws.size() != 4 || groups == 0 || xs[1] % groups != 0 || ws[0] % groups != 0 ||
+                ws[1] != xs[1] / groups) {
+                throw std::runtime_error("conv2d: weight " + ShapeUtils::to_string(ws) +
+                                         " does not match input " + ShapeUtils::to_string(xs) +
+                                         " with groups=" + std::to_string(groups));
+            }
+            if (bias != nullptr && bias->shape() != Shape{ ws[0] }) {
+                throw std::runtime_error("conv2d: bias must have shape [" + std::to_string(ws[0]) + "], got " +
+                                         ShapeUtils::to_string(bias->shape()));
+            }
+
+            const dim_t N = xs[0], H = xs[2], W = xs[3];
+            const dim_t F = ws[0], Cg = ws[1], KH = ws[2], KW = ws[3];
+            const dim_t Fg = F / static_cast<dim_t>(groups);
+            const dim_t s = options.stride, p = options.padding, d = options.dilation;
+            const dim_t OH = ImageLayout::output_size(H, KH, s, p, d);
+            const dim_t OW = ImageLayout::output_size(W, KW, s, p, d);
+            options.algorithm = choose_algorithm(options, sizeof(float) * KH * KW * Cg * OH * OW * N);
+            const bool im2col = options.algorithm == ConvAlgorithm::Im2col;
+
+            af::array image = ImageLayout::to_image(x.data());
+            af::array filter = ImageLayout::to_filter(weight.data());
+            af::array out = groups == 1 ? af::array() : af::constant(0, af::dim4(OH, OW, F, N));
+            std::vector<af::array> columns;
+            for (dim_t g = 0; g < static_cast<dim_t>(groups); ++g) {
+                af::array xg = ImageLayout::group(image, 2, g, Cg);
+                af::array fg = ImageLayout::group(filter, 3, g, Fg);
+                af::array og;
+                if (im2col) {
+                    columns.push_back(ImageLayout::im2col(xg, KH, KW, s, p));
+                    og = ImageLayout::from_gemm(af::matmul(ImageLayout::filter_matrix(fg), columns.back()), OH, OW);
+                } else {
+                    og = af::convolve2NN(xg, ImageLayout::flip_filter(fg), af::dim4(s, s), af::dim4(p, p), af::dim4(d, d));
+                }
+                ImageLayout::assign_group(out, 2, g, Fg, og);
+            }
+
+            af::array y = out;
+            if (bias != nullptr) {
+                y = y + af::tile(af::moddims(bias->data(), 1, 1, F), OH, OW, 1, N);
+            }
+
+            const bool requires_grad = GradMode::is_enabled() &&
+                (x.requires_grad() || weight.requires_grad() || (bias != nullptr && bias->requires_grad()));
+            auto impl = std::make_shared<TensorImpl>(
+                ImageLayout::from_image(y),
+                Shape{ xs[0], ws[0], static_cast<size_t>(OH), static_cast<size_t>(OW) },
+                requires_grad
+            );
+
+            if (requires_grad) {
+                auto fn = std::make_shared<Conv2dFunction>(options);
+                if (bias != nullptr) fn->set_inputs({ x.impl(), weight.impl(), bias->impl() });
+                else fn->set_inputs({ x.impl(), weight.impl() });
+                // im2col: the column matrices; direct: the un-biased output its gradient kernels expect
+                fn->save_for_backward(im2col ? std::move(columns) : std::vector<af::array>{ out });
+                impl->grad_fn() = fn;
+            }
+            return impl;
+        }
+
+    } // namespace
+
+    Tensor conv2d(const Tensor& x, const Tensor& weight, const Tensor& bias, const Conv2dOptions& options) {
+        return Tensor(conv2d_forward(x, weight, &bias, options));
+    }
+
+    Tensor conv2d(const Tensor& x, const Tensor& weight, const Conv2dOptions& options) {
+        return Tensor(conv2d_forward(x, weight, nullptr, options));
+    }
+
+}
@@ -0,0 +1,77 @@
+#include "ops/cross_entropy.hpp"
+#include "autograd/function.hpp"
+#include "autograd/gradmode.hpp"
+#include "tensor/shapeutils.hpp"
+#include "tensor/tensor.hpp"
+
+#include <stdexcept>
+#include <string>
+
+namespace cppgrad {
+
+    Tensor cross_entropy(const Tensor& logits, const std::vector<int>& labels, int class_dim) {
+        const Shape& shape = logits.shape();
+        if (class_dim < 0 || static_cast<size_t>(class_dim) >= shape.size()) {
+            throw std::runtime_error("cross_entropy: class_dim out of range for shape " + ShapeUtils::to_string(shape));
+        }
+
+        // Logits as (before, C, after); each label picks one class for a (b, a) pair
+        const af::dim4 grouped = ShapeUtils::around(shape, class_dim);
+        const dim_t before = grouped[0], classes = grouped[1], after = grouped[2];
+        const size_t count = static_cast<size_t>(before * after);
+        if (labels.size() != count) {
+            throw std::runtime_error("cross_entropy: expected " + std::to_string(count) +
+                                     " labels, got " + std::to_string(labels.size()));
+        }
+
+        // Flat storage index of each target logit. Labels are row-major over the
+        // remaining axes, so walk that multi-index and map it to column-major.
+        Shape rest = shape;
+        rest.erase(rest.begin() + class_dim);
+        std::vector<unsigned> targets(count);
+        std::vector<size_t> index(rest.size(), 0);
+        for (size_t i = 0; i < count; ++i) {
+            const int label = labels[i];
+            if (label < 0 || label >= classes) {
+                throw std::runtime_error("cross_entropy: label " + std::to_string(label) +
+                                         " out of range for " + std::to_string(classes) + " classes");
+            }
+
+            size_t pos = 0, stride = 1;   // Column-major offset among the remaining axes
+            for (size_t d = 0; d < rest.size(); ++d) {
+                pos += index[d] * stride;
+                stride *= rest[d];
+            }
+            const size_t b = pos % static_cast<size_t>(before);
+            const size_t a = pos / static_cast<size_t>(before);
+            targets[i] = static_cast<unsigned>(b + before * (label + classes * a));
+
+            for (size_t d = rest.size(); d-- > 0;) {
+                if (++index[d] < rest[d]) break;
+                index[d] = 0;
+            }
+        }
+        af::array idx(static_cast<dim_t>(count), targets.data());
+
+        const unsigned n = static_cast<unsigned>(classes);
+        af::array x = af::moddims(logits.data(), grouped);
+        af::array m = af::max(x, 1);
+        af::array lse = m + af::log(af::sum(af::exp(x - af::tile(m, 1, n)), 1));
+
+        af::array picked = af::flat(x)(idx);
+        af::array loss = af::sum(af::flat(lse) - picked) / static_cast<float>(count);
+
+        Tensor out(loss, GradMode::is_enabled() && logits.requires_grad(), Shape{});
+
+        if (out.requires_grad() && out.impl_->grad_fn() == nullptr) {
+            af::array probs = af::flat(af::exp(x - af::tile(lse, 1, n)));
+            auto fn = std::make_shared<CrossEntropyFunction>(count);
+            fn->set_inputs({ logits.impl_ });
+            fn->save_for_backward({ probs, idx });  // gradient is (softmax - onehot) / count
+            out.impl_->grad_fn() = fn;
+        }
+
+        return out;
+    }
+
+}
\ No newline at end of file
@@ -1,34 +1,87 @@
 #include "ops/div.hpp"
+#include "autograd/capture.hpp"
 #include "autograd/function.hpp"
+#include "autograd/gradmode.hpp"
+#include "lazy/graph.hpp"
+#include "lazy/lazymode.hpp"
+#include "tensor/broadcast.hpp"
 #include "tensor/tensor.hpp"
 
-#include <stdexcept>
 
 namespace cppgrad {
 
     Tensor operator/(const Tensor& a, const Tensor& b) {
-        // Broadcasting not yet supported
-        if (a.shape() != b.shape())
-            throw std::runtime_error("Shape mismatch in div");
+        if (LazyMode::is_enabled()) return Tensor(lazy::record_binary(lazy::Op::Div, a.impl_, b.impl_));
 
-        Tensor out(a.data() / b.data(),
-                   a.requires_grad() || b.requires_grad());
+        // Broadcast operands (throws if the shapes are incompatible)
+        Shape shape = Broadcast::result_shape(a.shape(), b.shape());
+        Tensor out(Broadcast::expand(a.data(), a.shape(), shape) / Broadcast::expand(b.data(), b.shape(), shape),
+                   GradMode::is_enabled() && (a.requires_grad() || b.requires_grad()), shape);
 
+        // The forward divides in every mode; only backward multiplies by the
+        // saved reciprocal
         if (out.requires_grad() && out.impl_->grad_fn() == nullptr) {
             auto fn = std::make_shared<DivFunction>();
-            fn->inputs = { a.impl_, b.impl_ };
+            fn->set_inputs({ a.impl_, b.impl_ });
+            fn->save_for_backward({ 1.0f / b.data(), out.data() });
             out.impl_->grad_fn() = fn;
         }
 
+        if (Tape::is_recording()) {
+            const bool saves = out.requires_grad();
+            Tape::record(out.impl_, { a.impl_, b.impl_ }, [sa = a.shape(), sb = b.shape(), shape, saves](const Tape::Arrays& in) {
+                af::array y = Broadcast::expand(in[0], sa, shape) / Broadcast::expand(in[1], sb, shape);
+                if (!saves) return Tape::Arrays{ y };
+                return Tape::Arrays{ y, 1.0f / in[1], y };
+            });
+        }
+
         return out;
     }
 
     Tensor operator/(const Tensor& lhs, float scalar) {
-        return lhs / Tensor::full(lhs.shape(), scalar, false);
+        if (LazyMode::is_enabled()) return Tensor(lazy::record_unary(lazy::Op::DivScalar, lhs.impl_, scalar));
+
+        Tensor out(lhs.data() / scalar,
+                   GradMode::is_enabled() && lhs.requires_grad(), lhs.shape());
+
+        // Backward of x / s is a multiplication by 1 / s
+        if (out.requires_grad() && out.impl_->grad_fn() == nullptr) {
+            auto fn = std::make_shared<MulScalarFunction>(1.0f / scalar);
+            fn->set_inputs({ lhs.impl_ });
+            out.impl_->grad_fn() = fn;
+        }
+
+        if (Tape::is_recording()) {
+            Tape::record(out.impl_, { lhs.impl_ }, [scalar](const Tape::Arrays& in) {
+                return Tape::Arrays{ in[0] / scalar };
+            });
+        }
+
+        return out;
     }
 
     Tensor operator/(float scalar, const Tensor& rhs) {
-        return Tensor::full(rhs.shape(), scalar, false) / rhs;
+        if (LazyMode::is_enabled()) return Tensor(lazy::record_unary(lazy::Op::RDivScalar, rhs.impl_, scalar));
+
+        Tensor out(scalar / rhs.data(),
+                   GradMode::is_enabled() && rhs.requires_grad(), rhs.shape());
+
+        if (out.requires_grad() && out.impl_->grad_fn() == nullptr) {
+            auto fn = std::make_shared<RDivScalarFunction>(scalar);
+            fn->set_inputs({ rhs.impl_ });
+            fn->save_for_backward({ out.data() });
+            out.impl_->grad_fn() = fn;
+        }
+
+        if (Tape::is_recording()) {
+            Tape::record(out.impl_, { rhs.impl_ }, [scalar](const Tape::Arrays& in) {
+                af::array y = scalar / in[0];
+                return Tape::Arrays{ y, y };
+            });
+        }
+
+        return out;
     }
 
 }
\ No newline at end of file
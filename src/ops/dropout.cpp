@@ -0,0 +1,41 @@
+#include "ops/dropout.hpp"
+#include "autograd/capture.hpp"
+#include "autograd/function.hpp"
+#include "autograd/gradmode.hpp"
+#include "tensor/shapeutils.hpp"
+#include "tensor/tensor.hpp"
+
+#include <stdexcept>
+#include <string>
+
+namespace cppgrad {
+
+    Tensor dropout(const Tensor& x, float p, bool training) {
+        if (p < 0.0f || p > 1.0f) {
+            throw std::runtime_error("dropout: probability " + std::to_string(p) + " not in [0, 1]");
+        }
+        if (!training || p == 0.0f) return x;
+
+        const float scale = p < 1.0f ? 1.0f / (1.0f - p) : 0.0f;
+        af::array keep = af::randu(ShapeUtils::fold(x.shape())) >= p;
+        Tensor out(x.data() * keep * scale, GradMode::is_enabled() && x.requires_grad(), x.shape());
+
+        if (out.requires_grad() && out.impl_->grad_fn() == nullptr) {
+            auto fn = std::make_shared<DropoutFunction>(scale);
+            fn->set_inputs({ x.impl_ });
+            fn->save_for_backward({ keep });   // b8: one byte per element
+            out.impl_->grad_fn() = fn;
+        }
+
+        // A fresh mask on every replay
+        if (Tape::is_recording()) {
+            Tape::record(out.impl_, { x.impl_ }, [p, scale](const Tape::Arrays& in) {
+                af::array keep = af::randu(in[0].dims()) >= p;
+                return Tape::Arrays{ in[0] * keep * scale, keep };
+            });
+        }
+
+        return out;
+    }
+
+}
@@ -0,0 +1,43 @@
+#include "ops/embedding.hpp"
+#include "autograd/function.hpp"
+#include "autograd/gradmode.hpp"
+#include "tensor/shapeutils.hpp"
+#include "tensor/tensor.hpp"
+
+#include <stdexcept>
+#include <string>
+
+namespace cppgrad {
+
+    Tensor embedding(const Tensor& indices, const Tensor& weight) {
+        const Shape& table = weight.shape();
+        if (table.size() != 2) {
+            throw std::runtime_error("embedding: weight must be (num_embeddings, dim), got " +
+                                     ShapeUtils::to_string(table));
+        }
+        const dim_t num = static_cast<dim_t>(table[0]);
+
+        // Column-major order of the indices is the row order of the result
+        af::array flat = af::flat(indices.data());
+        if (af::anyTrue<bool>(flat < 0 || flat >= static_cast<float>(num) || flat != af::floor(flat))) {
+            throw std::runtime_error("embedding: indices must be whole numbers in [0, " +
+                                     std::to_string(num) + ")");
+        }
+        af::array idx = flat.as(u32);
+
+        Shape shape = indices.shape();
+        shape.push_back(table[1]);
+        af::array rows = af::lookup(weight.data(), idx, 0);   // (count, dim)
+        Tensor out(af::moddims(rows, ShapeUtils::fold(shape)), GradMode::is_enabled() && weight.requires_grad(), shape);
+
+        if (out.requires_grad() && out.impl_->grad_fn() == nullptr) {
+            auto fn = std::make_shared<EmbeddingFunction>();
+            fn->set_inputs({ weight.impl_ });
+            fn->save_for_backward({ idx });
+            out.impl_->grad_fn() = fn;
+        }
+
+        return out;
+    }
+
+}
@@ -1,18 +1,32 @@
 #include "ops/exp.hpp"
+#include "autograd/capture.hpp"
 #include "autograd/function.hpp"
+#include "autograd/gradmode.hpp"
+#include "lazy/graph.hpp"
+#include "lazy/lazymode.hpp"
 #include "tensor/tensor.hpp"
 
 namespace cppgrad {
 
     Tensor exp(const Tensor& a) {
-        Tensor out(af::exp(a.data()), a.requires_grad());
+        if (LazyMode::is_enabled()) return Tensor(lazy::record_unary(lazy::Op::Exp, a.impl_));
+
+        Tensor out(af::exp(a.data()), GradMode::is_enabled() && a.requires_grad(), a.shape());
 
         if (out.requires_grad() && out.impl_->grad_fn() == nullptr) {
             auto fn = std::make_shared<ExpFunction>();
-            fn->inputs = { a.impl_ };
+            fn->set_inputs({ a.impl_ });
+            fn->save_for_backward({ out.data() });  // exp(a) is its own derivative
             out.impl_->grad_fn() = fn;
         }
 
+        if (Tape::is_recording()) {
+            Tape::record(out.impl_, { a.impl_ }, [](const Tape::Arrays& in) {
+                af::array y = af::exp(in[0]);
+                return Tape::Arrays{ y, y };
+            });
+        }
+
         return out;
     }
 
@@ -0,0 +1,32 @@
+#include "ops/gelu.hpp"
+#include "autograd/capture.hpp"
+#include "autograd/function.hpp"
+#include "autograd/gradmode.hpp"
+#include "tensor/tensor.hpp"
+
+namespace cppgrad {
+
+    Tensor gelu(const Tensor& a) {
+        const af::array& x = a.data();
+        const float inv_sqrt_2 = 0.7071067811865476f;
+        af::array cdf = 0.5f * (1.0f + af::erf(x * inv_sqrt_2));
+        Tensor out(x * cdf, GradMode::is_enabled() && a.requires_grad(), a.shape());
+
+        if (out.requires_grad() && out.impl_->grad_fn() == nullptr) {
+            auto fn = std::make_shared<GeluFunction>();
+            fn->set_inputs({ a.impl_ });
+            fn->save_for_backward({ cdf });  // Φ(x), reused by backward
+            out.impl_->grad_fn() = fn;
+        }
+
+        if (Tape::is_recording()) {
+            Tape::record(out.impl_, { a.impl_ }, [inv_sqrt_2](const Tape::Arrays& in) {
+                af::array cdf = 0.5f * (1.0f + af::erf(in[0] * inv_sqrt_2));
+                return Tape::Arrays{ in[0] * cdf, cdf };
+            });
+        }
+
+        return out;
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "ops/layer_norm.hpp"
+#include "autograd/function.hpp"
+#include "autograd/gradmode.hpp"
+#include "tensor/reduction.hpp"
+#include "tensor/shapeutils.hpp"
+#include "tensor/tensor.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+namespace cppgrad {
+
+    namespace {
+
+        /// Forward of `layer_norm`; `weight` and `bias` are both null or both set.
+        std::shared_ptr<TensorImpl> layer_norm_forward(const Tensor& x, const std::vector<size_t>& normalized_shape,
+                                                       const Tensor* weight, const Tensor* bias, float eps) {
+            const Shape& shape = x.shape();
+            const size_t k = normalized_shape.size();
+            if (k == 0 || k > shape.size() ||
+                !std::equal(normalized_shape.begin(), normalized_shape.end(), shape.end() - k)) {
+                throw std::runtime_error("layer_norm: normalized shape " + ShapeUtils::to_string(normalized_shape) +
+                                         " does not match the trailing axes of " + ShapeUtils::to_string(shape));
+            }
+            if (weight != nullptr && (weight->shape() != normalized_shape || bias->shape() != normalized_shape)) {
+                throw std::runtime_error("layer_norm: weight and bias must have shape " +
+                                         ShapeUtils::to_string(normalized_shape));
+            }
+
+            // Trailing axes are the slow ones in column-major storage: (rows, n, 1)
+            std::vector<int> dims(k);
+            std::iota(dims.begin(), dims.end(), static_cast<int>(shape.size() - k));
+            const Reduction r(shape, dims, true);
+            const dim_t rows = r.grouped()[0];
+            const unsigned n = static_cast<unsigned>(r.count());
+
+            af::array xg = r.group(x.data());
+            af::array mean, var;
+            af::meanvar(mean, var, xg, af::array(), AF_VARIANCE_POPULATION, 1);
+            af::array rstd = af::rsqrt(var + eps);
+
+            af::array y = (xg - af::tile(mean, 1, n)) * af::tile(rstd, 1, n);
+            if (weight != nullptr) {
+                const unsigned reps = static_cast<unsigned>(rows);
+                y = y * af::tile(af::moddims(weight->data(), 1, n), reps) + af::tile(af::moddims(bias->data(), 1, n), reps);
+            }
+
+            const bool requires_grad = GradMode::is_enabled() &&
+                (x.requires_grad() || (weight != nullptr && (weight->requires_grad() || bias->requires_grad())));
+            auto impl = std::make_shared<TensorImpl>(r.ungroup(y), shape, requires_grad);
+
+            if (requires_grad) {
+                auto fn = std::make_shared<LayerNormFunction>(r);
+                if (weight != nullptr) fn->set_inputs({ x.impl(), weight->impl(), bias->impl() });
+                else fn->set_inputs({ x.impl() });
+                fn->save_for_backward({ mean, rstd });
+                impl->grad_fn() = fn;
+            }
+            return impl;
+        }
+
+    } // namespace
+
+    Tensor layer_norm(const Tensor& x, const std::vector<size_t>& normalized_shape,
+                      const Tensor& weight, const Tensor& bias, float eps) {
+        return Tensor(layer_norm_forward(x, normalized_shape, &weight, &bias, eps));
+    }
+
+    Tensor layer_norm(const Tensor& x, const std::vector<size_t>& normalized_shape, float eps) {
+        return Tensor(layer_norm_forward(x, normalized_shape, nullptr, nullptr, eps));
+    }
+
+}
@@ -0,0 +1,93 @@
+#include "ops/linear.hpp"
+#include "autograd/capture.hpp"
+#include "autograd/function.hpp"
+#include "autograd/gradmode.hpp"
+#include "tensor/gemm.hpp"
+#include "tensor/shapeutils.hpp"
+#include "tensor/tensor.hpp"
+
+#include <stdexcept>
+
+namespace cppgrad {
+
+    namespace {
+
+        af::array activate(const af::array& z, Activation activation) {
+            switch (activation) {
+                case Activation::Relu:    return af::max(z, 0.0);
+                case Activation::Sigmoid: return af::sigmoid(z);
+                case Activation::Tanh:    return af::tanh(z);
+                case Activation::None:    break;
+            }
+            return z;
+        }
+
+        /// Forward of `linear`; `bias` may be null.
+        std::shared_ptr<TensorImpl> linear_forward(const Tensor& x, const Tensor& weight, const Tensor* bias,
+                                                   Activation activation) {
+            const Shape& x_shape = x.shape();
+            const Shape& w_shape = weight.shape();
+            if (x_shape.empty() || w_shape.size() != 2 || x_shape.back() != w_shape[1]) {
+                throw std::runtime_error("linear: expected x (..., in) and weight (out, in), got " +
+                                         ShapeUtils::to_string(x_shape) + " and " + ShapeUtils::to_string(w_shape));
+            }
+            const dim_t in = static_cast<dim_t>(w_shape[1]);
+            const dim_t out = static_cast<dim_t>(w_shape[0]);
+            if (bias != nullptr && bias->shape() != Shape{ w_shape[0] }) {
+                throw std::runtime_error("linear: bias must have shape [" + std::to_string(out) + "], got " +
+                                         ShapeUtils::to_string(bias->shape()));
+            }
+
+            // Every leading axis of x becomes a row of one (rows × in) GEMM operand
+            const dim_t rows = static_cast<dim_t>(ShapeUtils::numel(x_shape)) / in;
+            af_mat_prop w_prop;
+            af::array w = Gemm::operand(*weight.impl(), w_prop);
+            af::array z = af::matmul(af::moddims(x.data(), rows, in), w, AF_MAT_NONE, Gemm::flip(w_prop));
+            if (bias != nullptr) {
+                z = z + af::tile(af::moddims(bias->data(), 1, out), static_cast<unsigned>(rows));
+            }
+
+            Shape out_shape = x_shape;
+            out_shape[out_shape.size() - 1] = static_cast<size_t>(out);
+            af::array y = af::moddims(activate(z, activation), ShapeUtils::fold(out_shape));
+
+            const bool requires_grad = GradMode::is_enabled() &&
+                (x.requires_grad() || weight.requires_grad() || (bias != nullptr && bias->requires_grad()));
+            auto impl = std::make_shared<TensorImpl>(y, std::move(out_shape), requires_grad);
+
+            if (requires_grad) {
+                auto fn = std::make_shared<LinearFunction>(activation);
+                if (bias != nullptr) fn->set_inputs({ x.impl(), weight.impl(), bias->impl() });
+                else fn->set_inputs({ x.impl(), weight.impl() });
+                if (activation != Activation::None) fn->save_for_backward({ y });  // derivative from the output
+                impl->grad_fn() = fn;
+            }
+
+            if (Tape::is_recording()) {
+                const bool has_bias = bias != nullptr;
+                std::vector<std::shared_ptr<TensorImpl>> inputs{ x.impl(), weight.impl() };
+                if (has_bias) inputs.push_back(bias->impl());
+                Tape::record(impl, std::move(inputs),
+                             [rows, in, out, has_bias, activation, dims = y.dims()](const Tape::Arrays& a) {
+                    // Replayed operands are materialized, so W is always read transposed
+                    af::array z = af::matmul(af::moddims(a[0], rows, in), a[1], AF_MAT_NONE, AF_MAT_TRANS);
+                    if (has_bias) z = z + af::tile(af::moddims(a[2], 1, out), static_cast<unsigned>(rows));
+                    af::array y = af::moddims(activate(z, activation), dims);
+                    if (activation == Activation::None) return Tape::Arrays{ y };
+                    return Tape::Arrays{ y, y };
+                });
+            }
+            return impl;
+        }
+
+    } // namespace
+
+    Tensor linear(const Tensor& x, const Tensor& weight, const Tensor& bias, Activation activation) {
+        return Tensor(linear_forward(x, weight, &bias, activation));
+    }
+
+    Tensor linear(const Tensor& x, const Tensor& weight, Activation activation) {
+        return Tensor(linear_forward(x, weight, nullptr, activation));
+    }
+
+}
@@ -0,0 +1,53 @@
+#include "ops/log_softmax.hpp"
+#include "autograd/capture.hpp"
+#include "autograd/function.hpp"
+#include "autograd/gradmode.hpp"
+#include "tensor/shapeutils.hpp"
+#include "tensor/tensor.hpp"
+
+#include <stdexcept>
+
+namespace cppgrad {
+
+    namespace {
+
+        /// Log-softmax along dim 1 of `data` viewed as `grouped` (before, n, after),
+        /// returned with the input's folded `dims`.
+        af::array log_softmax_kernel(const af::array& data, const af::dim4& grouped, const af::dim4& dims) {
+            const unsigned n = static_cast<unsigned>(grouped[1]);
+            af::array x = af::moddims(data, grouped);
+            af::array m = af::max(x, 1);
+            af::array lse = m + af::log(af::sum(af::exp(x - af::tile(m, 1, n)), 1));
+            return af::moddims(x - af::tile(lse, 1, n), dims);
+        }
+
+    } // namespace
+
+    Tensor log_softmax(const Tensor& a, int dim) {
+        if (dim < 0 || static_cast<size_t>(dim) >= a.shape().size()) {
+            throw std::runtime_error("log_softmax: dim out of range for shape " + ShapeUtils::to_string(a.shape()));
+        }
+
+        const af::dim4 grouped = ShapeUtils::around(a.shape(), dim);
+        const af::dim4 dims = ShapeUtils::fold(a.shape());
+
+        Tensor out(log_softmax_kernel(a.data(), grouped, dims), GradMode::is_enabled() && a.requires_grad(), a.shape());
+
+        if (out.requires_grad() && out.impl_->grad_fn() == nullptr) {
+            auto fn = std::make_shared<LogSoftmaxFunction>(a.shape(), dim);
+            fn->set_inputs({ a.impl_ });
+            fn->save_for_backward({ out.data() });  // softmax = exp(output)
+            out.impl_->grad_fn() = fn;
+        }
+
+        if (Tape::is_recording()) {
+            Tape::record(out.impl_, { a.impl_ }, [grouped, dims](const Tape::Arrays& in) {
+                af::array y = log_softmax_kernel(in[0], grouped, dims);
+                return Tape::Arrays{ y, y };
+            });
+        }
+
+        return out;
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#include "ops/logsumexp.hpp"
+#include "autograd/function.hpp"
+#include "autograd/gradmode.hpp"
+#include "tensor/reduction.hpp"
+#include "tensor/tensor.hpp"
+
+namespace cppgrad {
+
+    namespace {
+
+        /// Forward of `logsumexp` over a planned reduction.
+        std::shared_ptr<TensorImpl> logsumexp_forward(const Tensor& a, const Reduction& r) {
+            const unsigned n = static_cast<unsigned>(r.count());
+            af::array x = r.group(a.data());
+            af::array m = af::max(x, 1);
+            af::array lse = m + af::log(af::sum(af::exp(x - af::tile(m, 1, n)), 1));   // (before, 1, after)
+
+            const bool requires_grad = GradMode::is_enabled() && a.requires_grad();
+            auto impl = std::make_shared<TensorImpl>(r.result(lse), r.output_shape(), requires_grad);
+
+            if (requires_grad) {
+                auto fn = std::make_shared<LogSumExpFunction>(r);
+                fn->set_inputs({ a.impl() });
+                fn->save_for_backward({ lse });
+                impl->grad_fn() = fn;
+            }
+            return impl;
+        }
+
+    } // namespace
+
+    Tensor logsumexp(const Tensor& a, int dim, bool keepdim) {
+        return Tensor(logsumexp_forward(a, Reduction(a.shape(), dim, keepdim)));
+    }
+
+    Tensor logsumexp(const Tensor& a, const std::vector<int>& dims, bool keepdim) {
+        return Tensor(logsumexp_forward(a, Reduction(a.shape(), dims, keepdim)));
+    }
+
+}
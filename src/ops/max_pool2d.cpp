@@ -0,0 +1,53 @@
+#include "ops/max_pool2d.hpp"
+#include "autograd/function.hpp"
+#include "autograd/gradmode.hpp"
+#include "tensor/imagelayout.hpp"
+#include "tensor/tensor.hpp"
+
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace cppgrad {
+
+    Tensor max_pool2d(const Tensor& x, size_t kernel, size_t stride, size_t padding) {
+        const Shape& xs = x.shape();
+        ImageLayout::check_nchw(xs, "max_pool2d");
+        // A wider padding allows windows that lie entirely in the padding,
+        // whose -inf output has no input to send a gradient to
+        if (2 * padding > kernel) {
+            throw std::runtime_error("max_pool2d: padding " + std::to_string(padding) +
+                                     " must be at most half the kernel size " + std::to_string(kernel));
+        }
+        if (stride == 0) stride = kernel;
+        const size_t OH = ImageLayout::output_size(xs[2], kernel, stride, padding);
+        const size_t OW = ImageLayout::output_size(xs[3], kernel, stride, padding);
+
+        // Pad with -inf rather than unwrap's zeros so padding never wins the max
+        af::array image = ImageLayout::to_image(x.data());
+        if (padding > 0) {
+            af::array padded = af::constant(-std::numeric_limits<float>::infinity(),
+                                            af::dim4(xs[2] + 2 * padding, xs[3] + 2 * padding, xs[1], xs[0]));
+            padded(af::seq(padding, padding + xs[2] - 1), af::seq(padding, padding + xs[3] - 1),
+                   af::span, af::span) = image;
+            image = padded;
+        }
+
+        // (K, L, C, N): one window per column, max down the column
+        af::array windows = af::unwrap(image, kernel, kernel, stride, stride, 0, 0, true);
+        af::array values, indices;
+        af::max(values, indices, windows, 0);
+        af::array y = ImageLayout::from_image(af::moddims(values, OH, OW, xs[1], xs[0]));
+
+        Tensor out(y, GradMode::is_enabled() && x.requires_grad(), Shape{ xs[0], xs[1], OH, OW });
+
+        if (out.requires_grad() && out.impl_->grad_fn() == nullptr) {
+            auto fn = std::make_shared<MaxPool2dFunction>(xs, kernel, stride, padding);
+            fn->set_inputs({ x.impl_ });
+            fn->save_for_backward({ indices });
+            out.impl_->grad_fn() = fn;
+        }
+        return out;
+    }
+
+}
@@ -1,19 +1,31 @@
 #include "ops/neg.hpp"
+#include "autograd/capture.hpp"
 #include "autograd/function.hpp"
+#include "autograd/gradmode.hpp"
+#include "lazy/graph.hpp"
+#include "lazy/lazymode.hpp"
 #include "tensor/tensor.hpp"
 
 
 namespace cppgrad {
 
     Tensor operator-(const Tensor& a) {
-        Tensor out(-a.data(), a.requires_grad());
+        if (LazyMode::is_enabled()) return Tensor(lazy::record_unary(lazy::Op::Neg, a.impl_));
+
+        Tensor out(-a.data(), GradMode::is_enabled() && a.requires_grad(), a.shape());
 
         if (out.requires_grad() && out.impl_->grad_fn() == nullptr) {
             auto fn = std::make_shared<NegFunction>();
-            fn->inputs = { a.impl_ };
+            fn->set_inputs({ a.impl_ });
             out.impl_->grad_fn() = fn;
         }
 
+        if (Tape::is_recording()) {
+            Tape::record(out.impl_, { a.impl_ }, [](const Tape::Arrays& in) {
+                return Tape::Arrays{ -in[0] };
+            });
+        }
+
         return out;
     }
 
@@ -1,32 +1,82 @@
 #include "ops/pow.hpp"
+#include "autograd/capture.hpp"
 #include "autograd/function.hpp"
+#include "autograd/gradmode.hpp"
+#include "lazy/graph.hpp"
+#include "lazy/lazymode.hpp"
+#include "tensor/broadcast.hpp"
 #include "tensor/tensor.hpp"
 
 namespace cppgrad {
 
     Tensor pow(const Tensor& base, const Tensor& exponent) {
-        if (base.shape() != exponent.shape())
-            throw std::runtime_error("Shape mismatch in pow");
+        // Broadcast operands (throws if the shapes are incompatible)
+        Shape shape = Broadcast::result_shape(base.shape(), exponent.shape());
 
-        Tensor out(af::pow(base.data(), exponent.data()),
-                   base.requires_grad() || exponent.requires_grad());
+        Tensor out(af::pow(Broadcast::expand(base.data(), base.shape(), shape),
+                           Broadcast::expand(exponent.data(), exponent.shape(), shape)),
+                   GradMode::is_enabled() && (base.requires_grad() || exponent.requires_grad()), shape);
 
         if (out.requires_grad() && out.impl_->grad_fn() == nullptr) {
             auto fn = std::make_shared<PowFunction>();
-            fn->inputs = { base.impl_, exponent.impl_ };
+            fn->set_inputs({ base.impl_, exponent.impl_ });
+            fn->save_for_backward({ out.data() });
             out.impl_->grad_fn() = fn;
         }
 
+        if (Tape::is_recording()) {
+            Tape::record(out.impl_, { base.impl_, exponent.impl_ }, [sb = base.shape(), se = exponent.shape(), shape](const Tape::Arrays& in) {
+                af::array y = af::pow(Broadcast::expand(in[0], sb, shape), Broadcast::expand(in[1], se, shape));
+                return Tape::Arrays{ y, y };
+            });
+        }
+
         return out;
     }
 
     // scalar overloads
     Tensor pow(const Tensor& base, float scalar) {
-        return pow(base, Tensor::full(base.shape(), scalar, false));
+        if (LazyMode::is_enabled()) return Tensor(lazy::record_unary(lazy::Op::PowScalar, base.impl_, scalar));
+
+        Tensor out(af::pow(base.data(), scalar),
+                   GradMode::is_enabled() && base.requires_grad(), base.shape());
+
+        if (out.requires_grad() && out.impl_->grad_fn() == nullptr) {
+            auto fn = std::make_shared<PowScalarFunction>(scalar);
+            fn->set_inputs({ base.impl_ });
+            out.impl_->grad_fn() = fn;
+        }
+
+        if (Tape::is_recording()) {
+            Tape::record(out.impl_, { base.impl_ }, [scalar](const Tape::Arrays& in) {
+                return Tape::Arrays{ af::pow(in[0], scalar) };
+            });
+        }
+
+        return out;
     }
 
     Tensor pow(float scalar, const Tensor& exponent) {
-        return pow(Tensor::full(exponent.shape(), scalar, false), exponent);
+        if (LazyMode::is_enabled()) return Tensor(lazy::record_unary(lazy::Op::RPowScalar, exponent.impl_, scalar));
+
+        Tensor out(af::pow(scalar, exponent.data()),
+                   GradMode::is_enabled() && exponent.requires_grad(), exponent.shape());
+
+        if (out.requires_grad() && out.impl_->grad_fn() == nullptr) {
+            auto fn = std::make_shared<RPowScalarFunction>(scalar);
+            fn->set_inputs({ exponent.impl_ });
+            fn->save_for_backward({ out.data() });
+            out.impl_->grad_fn() = fn;
+        }
+
+        if (Tape::is_recording()) {
+            Tape::record(out.impl_, { exponent.impl_ }, [scalar](const Tape::Arrays& in) {
+                af::array y = af::pow(scalar, in[0]);
+                return Tape::Arrays{ y, y };
+            });
+        }
+
+        return out;
     }
 
 }
\ No newline at end of file
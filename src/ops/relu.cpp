@@ -0,0 +1,33 @@
+#include "ops/relu.hpp"
+#include "autograd/capture.hpp"
+#include "autograd/function.hpp"
+#include "autograd/gradmode.hpp"
+#include "lazy/graph.hpp"
+#include "lazy/lazymode.hpp"
+#include "tensor/tensor.hpp"
+
+namespace cppgrad {
+
+    Tensor relu(const Tensor& a) {
+        if (LazyMode::is_enabled()) return Tensor(lazy::record_unary(lazy::Op::Relu, a.impl_));
+
+        Tensor out(af::max(a.data(), 0.0), GradMode::is_enabled() && a.requires_grad(), a.shape());
+
+        if (out.requires_grad() && out.impl_->grad_fn() == nullptr) {
+            auto fn = std::make_shared<ReluFunction>();
+            fn->set_inputs({ a.impl_ });
+            fn->save_for_backward({ out.data() });  // relu(a) > 0 marks where the gradient passes
+            out.impl_->grad_fn() = fn;
+        }
+
+        if (Tape::is_recording()) {
+            Tape::record(out.impl_, { a.impl_ }, [](const Tape::Arrays& in) {
+                af::array y = af::max(in[0], 0.0);
+                return Tape::Arrays{ y, y };
+            });
+        }
+
+        return out;
+    }
+
+}
\ No newline at end of file
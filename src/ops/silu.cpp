@@ -0,0 +1,31 @@
+#include "ops/silu.hpp"
+#include "autograd/capture.hpp"
+#include "autograd/function.hpp"
+#include "autograd/gradmode.hpp"
+#include "tensor/tensor.hpp"
+
+namespace cppgrad {
+
+    Tensor silu(const Tensor& a) {
+        af::array s = af::sigmoid(a.data());
+        Tensor out(a.data() * s, GradMode::is_enabled() && a.requires_grad(), a.shape());
+
+        if (out.requires_grad() && out.impl_->grad_fn() == nullptr) {
+            auto fn = std::make_shared<SiluFunction>();
+            fn->set_inputs({ a.impl_ });
+            fn->save_for_backward({ s, out.data() });  // derivative is s + y * (1 - s)
+            out.impl_->grad_fn() = fn;
+        }
+
+        if (Tape::is_recording()) {
+            Tape::record(out.impl_, { a.impl_ }, [](const Tape::Arrays& in) {
+                af::array s = af::sigmoid(in[0]);
+                af::array y = in[0] * s;
+                return Tape::Arrays{ y, s, y };
+            });
+        }
+
+        return out;
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+#include "ops/softmax.hpp"
+#include "autograd/capture.hpp"
+#include "autograd/function.hpp"
+#include "autograd/gradmode.hpp"
+#include "tensor/shapeutils.hpp"
+#include "tensor/tensor.hpp"
+
+#include <stdexcept>
+
+namespace cppgrad {
+
+    namespace {
+
+        /// Softmax along dim 1 of `data` viewed as `grouped` (before, n, after),
+        /// returned with the input's folded `dims`.
+        af::array softmax_kernel(const af::array& data, const af::dim4& grouped, const af::dim4& dims) {
+            const unsigned n = static_cast<unsigned>(grouped[1]);
+            af::array x = af::moddims(data, grouped);
+            af::array e = af::exp(x - af::tile(af::max(x, 1), 1, n));
+            return af::moddims(e / af::tile(af::sum(e, 1), 1, n), dims);
+        }
+
+    } // namespace
+
+    Tensor softmax(const Tensor& a, int dim) {
+        if (dim < 0 || static_cast<size_t>(dim) >= a.shape().size()) {
+            throw std::runtime_error("softmax: dim out of range for shape " + ShapeUtils::to_string(a.shape()));
+        }
+
+        // (before, n, after): the softmax axis is ArrayFire dim 1 for every rank
+        const af::dim4 grouped = ShapeUtils::around(a.shape(), dim);
+        const af::dim4 dims = ShapeUtils::fold(a.shape());
+
+        Tensor out(softmax_kernel(a.data(), grouped, dims), GradMode::is_enabled() && a.requires_grad(), a.shape());
+
+        if (out.requires_grad() && out.impl_->grad_fn() == nullptr) {
+            auto fn = std::make_shared<SoftmaxFunction>(a.shape(), dim);
+            fn->set_inputs({ a.impl_ });
+            fn->save_for_backward({ out.data() });  // backward only needs the probabilities
+            out.impl_->grad_fn() = fn;
+        }
+
+        if (Tape::is_recording()) {
+            Tape::record(out.impl_, { a.impl_ }, [grouped, dims](const Tape::Arrays& in) {
+                af::array y = softmax_kernel(in[0], grouped, dims);
+                return Tape::Arrays{ y, y };
+            });
+        }
+
+        return out;
+    }
+
+}
\ No newline at end of file
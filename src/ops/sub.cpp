@@ -1,34 +1,62 @@
 #include "ops/sub.hpp"
+#include "autograd/capture.hpp"
 #include "autograd/function.hpp"
+#include "autograd/gradmode.hpp"
+#include "lazy/graph.hpp"
+#include "lazy/lazymode.hpp"
+#include "tensor/broadcast.hpp"
 #include "tensor/tensor.hpp"
 
-#include <stdexcept>
 
 namespace cppgrad {
 
     Tensor operator-(const Tensor& a, const Tensor& b) {
-        // Check shape compatibility (broadcasting not yet implemented)
-        if (a.shape() != b.shape())
-            throw std::runtime_error("shape mismatch");
+        if (LazyMode::is_enabled()) return Tensor(lazy::record_binary(lazy::Op::Sub, a.impl_, b.impl_));
 
-        Tensor out(a.data() - b.data(),
-                   a.requires_grad() || b.requires_grad());
+        // Broadcast operands (throws if the shapes are incompatible)
+        Shape shape = Broadcast::result_shape(a.shape(), b.shape());
+
+        Tensor out(Broadcast::expand(a.data(), a.shape(), shape) - Broadcast::expand(b.data(), b.shape(), shape),
+                   GradMode::is_enabled() && (a.requires_grad() || b.requires_grad()), shape);
 
         if (out.requires_grad() && out.impl_->grad_fn() == nullptr) {
             auto fn = std::make_shared<SubFunction>();
-            fn->inputs = { a.impl_, b.impl_ };
+            fn->set_inputs({ a.impl_, b.impl_ });
             out.impl_->grad_fn() = fn;
         }
 
+        if (Tape::is_recording()) {
+            Tape::record(out.impl_, { a.impl_, b.impl_ }, [sa = a.shape(), sb = b.shape(), shape](const Tape::Arrays& in) {
+                return Tape::Arrays{ Broadcast::expand(in[0], sa, shape) - Broadcast::expand(in[1], sb, shape) };
+            });
+        }
+
         return out;
     }
 
     Tensor operator-(const Tensor& lhs, float scalar) {
-        return lhs - Tensor::full(lhs.shape(), scalar, false);
+        return lhs + (-scalar);
     }
 
     Tensor operator-(float scalar, const Tensor& rhs) {
-        return Tensor::full(rhs.shape(), scalar, false) - rhs;
+        if (LazyMode::is_enabled()) return Tensor(lazy::record_unary(lazy::Op::RSubScalar, rhs.impl_, scalar));
+
+        Tensor out(scalar - rhs.data(),
+                   GradMode::is_enabled() && rhs.requires_grad(), rhs.shape());
+
+        if (out.requires_grad() && out.impl_->grad_fn() == nullptr) {
+            auto fn = std::make_shared<RSubScalarFunction>();
+            fn->set_inputs({ rhs.impl_ });
+            out.impl_->grad_fn() = fn;
+        }
+
+        if (Tape::is_recording()) {
+            Tape::record(out.impl_, { rhs.impl_ }, [scalar](const Tape::Arrays& in) {
+                return Tape::Arrays{ scalar - in[0] };
+            });
+        }
+
+        return out;
     }
 
 }
\ No newline at end of file
@@ -0,0 +1,33 @@
+#include "ops/tanh.hpp"
+#include "autograd/capture.hpp"
+#include "autograd/function.hpp"
+#include "autograd/gradmode.hpp"
+#include "lazy/graph.hpp"
+#include "lazy/lazymode.hpp"
+#include "tensor/tensor.hpp"
+
+namespace cppgrad {
+
+    Tensor tanh(const Tensor& a) {
+        if (LazyMode::is_enabled()) return Tensor(lazy::record_unary(lazy::Op::Tanh, a.impl_));
+
+        Tensor out(af::tanh(a.data()), GradMode::is_enabled() && a.requires_grad(), a.shape());
+
+        if (out.requires_grad() && out.impl_->grad_fn() == nullptr) {
+            auto fn = std::make_shared<TanhFunction>();
+            fn->set_inputs({ a.impl_ });
+            fn->save_for_backward({ out.data() });  // derivative is 1 - t²
+            out.impl_->grad_fn() = fn;
+        }
+
+        if (Tape::is_recording()) {
+            Tape::record(out.impl_, { a.impl_ }, [](const Tape::Arrays& in) {
+                af::array y = af::tanh(in[0]);
+                return Tape::Arrays{ y, y };
+            });
+        }
+
+        return out;
+    }
+
+}
\ No newline at end of file
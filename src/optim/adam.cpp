@@ -0,0 +1,62 @@
+#include "optim/adam.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace cppgrad::optim {
+
+    Adam::Adam(std::vector<Tensor> params, const AdamOptions& options)
+    : Optimizer(std::move(params)), options_(options),
+      exp_avg_(zeros()), exp_avg_sq_(zeros()), steps_(this->params().size(), 0) {}
+
+    af::array Adam::update(const af::array& params, const af::array& grads) {
+        af::array g = grads;
+        if (options_.weight_decay != 0.0f) g = g + options_.weight_decay * params;
+        return adam_update(params, g);
+    }
+
+    af::array Adam::adam_update(const af::array& params, const af::array& grads) {
+        const float b1 = options_.beta1, b2 = options_.beta2;
+        for (size_t i = 0; i < steps_.size(); ++i) {
+            if (active(i)) ++steps_[i];
+        }
+
+        exp_avg_ = b1 * exp_avg_ + (1.0f - b1) * grads;
+        exp_avg_sq_ = b2 * exp_avg_sq_ + (1.0f - b2) * grads * grads;
+
+        // p -= lr / (1 - b1^t) * m / (sqrt(v) / sqrt(1 - b2^t) + eps)
+        auto bias1 = [&](uint64_t t) { return static_cast<float>(1.0 - std::pow(b1, static_cast<double>(t))); };
+        auto bias2_sqrt = [&](uint64_t t) { return static_cast<float>(std::sqrt(1.0 - std::pow(b2, static_cast<double>(t)))); };
+        if (std::adjacent_find(steps_.begin(), steps_.end(), std::not_equal_to<>()) == steps_.end()) {
+            af::array denom = af::sqrt(exp_avg_sq_) / bias2_sqrt(steps_.front()) + options_.eps;
+            return params - (options_.lr / bias1(steps_.front())) * exp_avg_ / denom;
+        }
+
+        // Parameters skipped in some steps have their own step counts; a count
+        // of 0 only occurs for parameters masked out of this step
+        std::vector<float> lr_t(steps_.size()), bias2_t(steps_.size());
+        for (size_t i = 0; i < steps_.size(); ++i) {
+            const uint64_t t = std::max<uint64_t>(steps_[i], 1);
+            lr_t[i] = options_.lr / bias1(t);
+            bias2_t[i] = bias2_sqrt(t);
+        }
+        af::array denom = af::sqrt(exp_avg_sq_) / per_param(bias2_t) + options_.eps;
+        return params - per_param(lr_t) * exp_avg_ / denom;
+    }
+
+    std::vector<af::array*> Adam::state() {
+        return { &exp_avg_, &exp_avg_sq_ };
+    }
+
+    AdamW::AdamW(std::vector<Tensor> params, const AdamOptions& options)
+    : Adam(std::move(params), options) {}
+
+    af::array AdamW::update(const af::array& params, const af::array& grads) {
+        af::array decayed = options_.weight_decay != 0.0f
+            ? params * (1.0f - options_.lr * options_.weight_decay)
+            : params;
+        return adam_update(decayed, grads);
+    }
+
+}
@@ -0,0 +1,168 @@
+#include "optim/optimizer.hpp"
+#include "tensor/shapeutils.hpp"
+#include "tensor/tensorimpl.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+
+namespace cppgrad::optim {
+
+    namespace {
+
+        // Inputs per af_join_many call
+        constexpr size_t kJoinBatch = 10;
+
+        /// Concatenate 1-D arrays, a batch of inputs per kernel.
+        af::array join_flat(std::vector<af::array> parts) {
+            while (parts.size() > 1) {
+                std::vector<af::array> joined;
+                for (size_t i = 0; i < parts.size(); i += kJoinBatch) {
+                    const size_t n = std::min(kJoinBatch, parts.size() - i);
+                    if (n == 1) {
+                        joined.push_back(parts[i]);
+                        continue;
+                    }
+                    std::vector<af_array> handles;
+                    for (size_t k = 0; k < n; ++k) handles.push_back(parts[i + k].get());
+                    af_array out = nullptr;
+                    af_err err = af_join_many(&out, 0, static_cast<unsigned>(n), handles.data());
+                    if (err != AF_SUCCESS) {
+                        throw std::runtime_error("optim: af_join_many failed (af_err " + std::to_string(err) + ")");
+                    }
+                    joined.emplace_back(out);
+                }
+                parts = std::move(joined);
+            }
+            return parts.front();
+        }
+
+    } // namespace
+
+    Optimizer::Optimizer(std::vector<Tensor> params)
+    : params_(std::move(params)) {
+        if (params_.empty()) throw std::runtime_error("optim: empty parameter list");
+
+        std::unordered_set<const TensorImpl*> seen;
+        for (const Tensor& p : params_) {
+            if (!p.requires_grad()) {
+                throw std::runtime_error("optim: parameter of shape " + ShapeUtils::to_string(p.shape()) +
+                                         " does not require grad");
+            }
+            if (!seen.insert(p.impl().get()).second) {
+                throw std::runtime_error("optim: parameter passed twice");
+            }
+            offsets_.push_back(numel_);
+            numel_ += p.numel();
+        }
+        pack();
+    }
+
+    void Optimizer::pack() {
+        std::vector<af::array> parts;
+        parts.reserve(params_.size());
+        for (const Tensor& p : params_) parts.push_back(af::flat(p.data()));
+        flat_ = join_flat(std::move(parts));
+        flat_.eval();
+        bind(false);
+    }
+
+    void Optimizer::bind(bool bump_version) {
+        versions_.resize(params_.size());
+        for (size_t i = 0; i < params_.size(); ++i) {
+            TensorImpl& impl = *params_[i].impl();
+            const dim_t first = static_cast<dim_t>(offsets_[i]);
+            const dim_t last = first + static_cast<dim_t>(params_[i].numel()) - 1;
+
+            // A contiguous range of a 1-D array is a view of the same buffer
+            impl.data() = af::moddims(flat_(af::seq(static_cast<double>(first), static_cast<double>(last))),
+                                      ShapeUtils::fold(impl.shape()));
+            if (bump_version && active_[i]) impl.bump_version();
+            versions_[i] = impl.version();
+        }
+    }
+
+    af::array Optimizer::gather_grads() const {
+        std::vector<af::array> parts;
+        parts.reserve(params_.size());
+        for (const Tensor& p : params_) {
+            // A parameter without a gradient is masked out of the update, so
+            // its own values fill the slot instead of a freshly allocated zero buffer
+            const TensorImpl& impl = *p.impl();
+            parts.push_back(af::flat(impl.has_grad() ? impl.grad() : p.data()));
+        }
+        return join_flat(std::move(parts));
+    }
+
+    af::array Optimizer::zeros() const {
+        return af::constant(0, static_cast<dim_t>(numel_));
+    }
+
+    af::array Optimizer::per_param(const std::vector<float>& values) const {
+        if (segments_.isempty()) {
+            // Index of the owning parameter for every element, built once
+            std::vector<af::array> parts;
+            parts.reserve(params_.size());
+            for (size_t i = 0; i < params_.size(); ++i) {
+                parts.push_back(af::constant(static_cast<unsigned>(i), static_cast<dim_t>(params_[i].numel()), u32));
+            }
+            segments_ = join_flat(std::move(parts));
+            segments_.eval();
+        }
+        return af::lookup(af::array(static_cast<dim_t>(values.size()), values.data()), segments_);
+    }
+
+    af::array Optimizer::mask(const std::vector<bool>& flags) const {
+        std::vector<float> values(flags.begin(), flags.end());
+        return per_param(values) != 0.0f;
+    }
+
+    void Optimizer::step() {
+        // Re-pack if anything wrote to a parameter since the last step
+        for (size_t i = 0; i < params_.size(); ++i) {
+            if (params_[i].version() != versions_[i]) {
+                pack();
+                break;
+            }
+        }
+
+        ++step_count_;
+        bool any = false;
+        all_active_ = true;
+        active_.resize(params_.size());
+        for (size_t i = 0; i < params_.size(); ++i) {
+            active_[i] = params_[i].impl()->has_grad();
+            any = any || active_[i];
+            all_active_ = all_active_ && active_[i];
+        }
+        if (!any) return;
+
+        std::vector<af::array> before;
+        for (const af::array* s : state()) before.push_back(*s);
+
+        af::array updated = update(flat_, gather_grads());
+        std::vector<af::array*> outputs = state();
+
+        // Parameters without a gradient keep their values and their state
+        if (!all_active_) {
+            const af::array keep = mask(active_);
+            updated = af::select(keep, updated, flat_);
+            for (size_t i = 0; i < outputs.size(); ++i) {
+                *outputs[i] = af::select(keep, *outputs[i], before[i]);
+            }
+        }
+
+        // Parameters and state in one evaluation, so ArrayFire fuses them
+        outputs.push_back(&updated);
+        af::eval(static_cast<int>(outputs.size()), outputs.data());
+
+        flat_ = updated;
+        bind(true);
+    }
+
+    void Optimizer::zero_grad() {
+        for (const Tensor& p : params_) p.zero_grad();
+    }
+
+}
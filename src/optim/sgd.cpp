@@ -0,0 +1,39 @@
+#include "optim/sgd.hpp"
+
+#include <algorithm>
+
+namespace cppgrad::optim {
+
+    SGD::SGD(std::vector<Tensor> params, const SGDOptions& options)
+    : Optimizer(std::move(params)), options_(options) {
+        if (options_.momentum != 0.0f) {
+            momentum_ = zeros();
+            seeded_.assign(this->params().size(), false);
+        }
+    }
+
+    af::array SGD::update(const af::array& params, const af::array& grads) {
+        af::array g = grads;
+        if (options_.weight_decay != 0.0f) g = g + options_.weight_decay * params;
+
+        if (options_.momentum != 0.0f) {
+            // A parameter's first step seeds its slice with the gradient itself
+            const bool all_seeded = std::all_of(seeded_.begin(), seeded_.end(), [](bool s) { return s; });
+            const bool none_seeded = std::none_of(seeded_.begin(), seeded_.end(), [](bool s) { return s; });
+            af::array next = options_.momentum * momentum_ + (1.0f - options_.dampening) * g;
+            if (all_seeded) momentum_ = next;
+            else if (none_seeded) momentum_ = g;
+            else momentum_ = af::select(mask(seeded_), next, g);
+            for (size_t i = 0; i < seeded_.size(); ++i) seeded_[i] = seeded_[i] || active(i);
+
+            g = options_.nesterov ? g + options_.momentum * momentum_ : momentum_;
+        }
+        return params - options_.lr * g;
+    }
+
+    std::vector<af::array*> SGD::state() {
+        if (momentum_.isempty()) return {};
+        return { &momentum_ };
+    }
+
+}
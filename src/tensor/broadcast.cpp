@@ -0,0 +1,119 @@
+#include "tensor/broadcast.hpp"
+#include "tensor/shapeutils.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace cppgrad {
+
+    Shape Broadcast::result_shape(const Shape& a,
+                                                const Shape& b) {
+        if (a == b) return a;
+
+        const size_t rank = std::max(a.size(), b.size());
+        Shape out(rank);
+        for (size_t i = 0; i < rank; ++i) {
+            // Walk from the trailing axis; missing leading axes act as size 1
+            const size_t da = i < a.size() ? a[a.size() - 1 - i] : 1;
+            const size_t db = i < b.size() ? b[b.size() - 1 - i] : 1;
+            if (da != db && da != 1 && db != 1) {
+                throw std::runtime_error(
+                    "Shapes " + ShapeUtils::to_string(a) + " and " + ShapeUtils::to_string(b) +
+                    " are not broadcastable"
+                );
+            }
+            out[rank - 1 - i] = std::max(da, db);
+        }
+        return out;
+    }
+
+    void Broadcast::coalesce(const Shape& small,
+                             const Shape& large,
+                             af::dim4& small_dims,
+                             af::dim4& large_dims) {
+        if (small.size() > large.size()) {
+            throw std::runtime_error(
+                "Cannot broadcast " + ShapeUtils::to_string(small) + " to " + ShapeUtils::to_string(large)
+            );
+        }
+
+        std::vector<dim_t> s_groups, l_groups;
+        std::vector<bool> expanded;
+        const size_t shift = large.size() - small.size();
+        for (size_t i = 0; i < large.size(); ++i) {
+            const size_t s = i < shift ? 1 : small[i - shift];
+            const size_t l = large[i];
+            if (s != l && s != 1) {
+                throw std::runtime_error(
+                    "Cannot broadcast " + ShapeUtils::to_string(small) + " to " + ShapeUtils::to_string(large)
+                );
+            }
+            if (l == 1) continue;  // size 1 on both sides: no effect on layout
+
+            const bool is_expanded = s == 1;
+            if (!expanded.empty() && expanded.back() == is_expanded) {
+                s_groups.back() *= static_cast<dim_t>(s);
+                l_groups.back() *= static_cast<dim_t>(l);
+            } else {
+                s_groups.push_back(static_cast<dim_t>(s));
+                l_groups.push_back(static_cast<dim_t>(l));
+                expanded.push_back(is_expanded);
+            }
+        }
+
+        if (s_groups.size() > 4) {
+            throw std::runtime_error(
+                "Broadcasting " + ShapeUtils::to_string(small) + " to " + ShapeUtils::to_string(large) +
+                " needs more than 4 dims after coalescing"
+            );
+        }
+
+        small_dims = af::dim4(1, 1, 1, 1);
+        large_dims = af::dim4(1, 1, 1, 1);
+        for (size_t i = 0; i < s_groups.size(); ++i) {
+            small_dims[i] = s_groups[i];
+            large_dims[i] = l_groups[i];
+        }
+    }
+
+    af::array Broadcast::expand(const af::array& arr,
+                                const Shape& from,
+                                const Shape& to) {
+        const af::dim4 target = ShapeUtils::fold(to);
+
+        // Same element count: only leading 1s differ, so this is a relabel
+        if (ShapeUtils::numel(from) == ShapeUtils::numel(to)) {
+            return arr.dims() == target ? arr : af::moddims(arr, target);
+        }
+
+        af::dim4 small_dims, large_dims;
+        coalesce(from, to, small_dims, large_dims);
+
+        af::dim4 reps(1, 1, 1, 1);
+        for (unsigned i = 0; i < 4; ++i) reps[i] = large_dims[i] / small_dims[i];
+
+        af::array out = af::tile(af::moddims(arr, small_dims), reps);
+        return large_dims == target ? out : af::moddims(out, target);
+    }
+
+    af::array Broadcast::reduce_to(const af::array& grad,
+                                   const Shape& from,
+                                   const Shape& to) {
+        const af::dim4 target = ShapeUtils::fold(to);
+
+        if (ShapeUtils::numel(from) == ShapeUtils::numel(to)) {
+            return grad.dims() == target ? grad : af::moddims(grad, target);
+        }
+
+        af::dim4 small_dims, large_dims;
+        coalesce(to, from, small_dims, large_dims);
+
+        af::array out = large_dims == grad.dims() ? grad : af::moddims(grad, large_dims);
+        for (int i = 0; i < 4; ++i) {
+            if (small_dims[i] == 1 && large_dims[i] > 1) out = af::sum(out, i);
+        }
+        return small_dims == target ? out : af::moddims(out, target);
+    }
+
+}
@@ -0,0 +1,77 @@
+#include "tensor/gemm.hpp"
+#include "tensor/shapeutils.hpp"
+#include "tensor/tensorimpl.hpp"
+
+#include <array>
+#include <stdexcept>
+
+namespace cppgrad {
+
+    Shape Gemm::result_shape(const Shape& a, const Shape& b) {
+        if (a.size() <= 2 && b.size() <= 2) {
+            const af::dim4 ad = ShapeUtils::fold(a), bd = ShapeUtils::fold(b);
+            if (ad[1] != bd[0]) {
+                throw std::runtime_error("matmul: inner dimensions differ for " +
+                                         ShapeUtils::to_string(a) + " @ " + ShapeUtils::to_string(b));
+            }
+            return Shape{ static_cast<size_t>(ad[0]), static_cast<size_t>(bd[1]) };
+        }
+
+        const Shape& batched = a.size() >= b.size() ? a : b;
+        if (a.size() < 2 || b.size() < 2 ||
+            a[a.size() - 1] != b[b.size() - 2] ||
+            (a.size() > 2 && b.size() > 2 && a.size() != b.size())) {
+            throw std::runtime_error("matmul: incompatible shapes " +
+                                     ShapeUtils::to_string(a) + " @ " + ShapeUtils::to_string(b));
+        }
+        if (a.size() > 2 && b.size() > 2) {
+            for (size_t i = 0; i + 2 < a.size(); ++i) {
+                if (a[i] != b[i]) {
+                    throw std::runtime_error("matmul: batch axes differ for " +
+                                             ShapeUtils::to_string(a) + " @ " + ShapeUtils::to_string(b));
+                }
+            }
+        }
+
+        Shape out = batched;
+        out[out.size() - 2] = a[a.size() - 2];
+        out[out.size() - 1] = b[b.size() - 1];
+        return out;
+    }
+
+    af::array Gemm::operand(const TensorImpl& impl, af_mat_prop& prop) {
+        af::array source;
+        std::array<unsigned, 4> perm{};
+        if (impl.permuted_source(source, perm) && perm == std::array<unsigned, 4>{1, 0, 2, 3}) {
+            prop = AF_MAT_TRANS;
+            return source;
+        }
+        prop = AF_MAT_NONE;
+        return impl.data();
+    }
+
+    af_mat_prop Gemm::flip(af_mat_prop prop) {
+        return prop == AF_MAT_TRANS ? AF_MAT_NONE : AF_MAT_TRANS;
+    }
+
+    dim_t Gemm::batch_count(const Shape& shape) {
+        dim_t count = 1;
+        for (size_t i = 0; i + 2 < shape.size(); ++i) count *= static_cast<dim_t>(shape[i]);
+        return count;
+    }
+
+    af::array Gemm::to_batched(const af::array& data, const Shape& shape) {
+        const size_t r = shape.size();
+        const dim_t rows = static_cast<dim_t>(shape[r - 2]);
+        const dim_t cols = static_cast<dim_t>(shape[r - 1]);
+        const dim_t batch = batch_count(shape);
+        if (batch == 1) return af::moddims(data, rows, cols);
+        return af::reorder(af::moddims(data, batch, rows, cols), 1, 2, 0);
+    }
+
+    af::array Gemm::from_batched(const af::array& batched, const Shape& shape) {
+        if (batch_count(shape) == 1) return af::moddims(batched, ShapeUtils::fold(shape));
+        return af::moddims(af::reorder(batched, 2, 0, 1), ShapeUtils::fold(shape));
+    }
+
+}
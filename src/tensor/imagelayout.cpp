@@ -0,0 +1,99 @@
+#include "tensor/imagelayout.hpp"
+#include "tensor/shapeutils.hpp"
+
+#include <stdexcept>
+#include <string>
+
+namespace cppgrad {
+
+    af::array ImageLayout::to_image(const af::array& nchw) {
+        return af::reorder(nchw, 2, 3, 1, 0);
+    }
+
+    af::array ImageLayout::from_image(const af::array& image) {
+        return af::reorder(image, 3, 2, 0, 1);
+    }
+
+    af::array ImageLayout::to_filter(const af::array& weight) {
+        return af::reorder(weight, 2, 3, 1, 0);
+    }
+
+    af::array ImageLayout::from_filter(const af::array& filter) {
+        return af::reorder(filter, 3, 2, 0, 1);
+    }
+
+    af::array ImageLayout::flip_filter(const af::array& filter) {
+        return af::flip(af::flip(filter, 0), 1);
+    }
+
+    af::array ImageLayout::im2col(const af::array& image, dim_t kh, dim_t kw,
+                                  dim_t stride, dim_t padding) {
+        // unwrap gives (KH*KW, L, C, N); channels move next to the window so one
+        // column holds a full receptive field
+        af::array cols = af::unwrap(image, kh, kw, stride, stride, padding, padding, true);
+        const dim_t windows = cols.dims(1);
+        return af::moddims(af::reorder(cols, 0, 2, 1, 3), kh * kw * image.dims(2), windows * image.dims(3));
+    }
+
+    af::array ImageLayout::col2im(const af::array& cols, const af::dim4& image_dims,
+                                  dim_t kh, dim_t kw, dim_t stride, dim_t padding) {
+        const dim_t windows = cols.dims(1) / image_dims[3];
+        af::array unwrapped = af::reorder(af::moddims(cols, kh * kw, image_dims[2], windows, image_dims[3]), 0, 2, 1, 3);
+        return af::wrap(unwrapped, image_dims[0], image_dims[1], kh, kw, stride, stride, padding, padding, true);
+    }
+
+    af::array ImageLayout::filter_matrix(const af::array& filter) {
+        const af::dim4 d = filter.dims();
+        return af::moddims(af::reorder(filter, 3, 0, 1, 2), d[3], d[0] * d[1] * d[2]);
+    }
+
+    af::array ImageLayout::from_filter_matrix(const af::array& matrix, const af::dim4& filter_dims) {
+        return af::reorder(af::moddims(matrix, filter_dims[3], filter_dims[0], filter_dims[1], filter_dims[2]), 1, 2, 3, 0);
+    }
+
+    af::array ImageLayout::from_gemm(const af::array& matrix, dim_t oh, dim_t ow) {
+        const dim_t f = matrix.dims(0);
+        return af::reorder(af::moddims(matrix, f, oh, ow, matrix.dims(1) / (oh * ow)), 1, 2, 0, 3);
+    }
+
+    af::array ImageLayout::to_gemm(const af::array& image) {
+        const af::dim4 d = image.dims();
+        return af::moddims(af::reorder(image, 2, 0, 1, 3), d[2], d[0] * d[1] * d[3]);
+    }
+
+    af::array ImageLayout::group(const af::array& arr, unsigned dim, dim_t index, dim_t size) {
+        if (arr.dims(dim) == size) return arr;
+        const af::seq channels(static_cast<double>(index * size), static_cast<double>((index + 1) * size - 1));
+        if (dim == 2) return arr(af::span, af::span, channels, af::span);
+        return arr(af::span, af::span, af::span, channels);
+    }
+
+    void ImageLayout::assign_group(af::array& dst, unsigned dim, dim_t index, dim_t size,
+                                   const af::array& src) {
+        if (dst.isempty() || dst.dims(dim) == size) {
+            dst = src;
+            return;
+        }
+        const af::seq channels(static_cast<double>(index * size), static_cast<double>((index + 1) * size - 1));
+        if (dim == 2) dst(af::span, af::span, channels, af::span) = src;
+        else dst(af::span, af::span, af::span, channels) = src;
+    }
+
+    size_t ImageLayout::output_size(size_t input, size_t kernel, size_t stride,
+                                    size_t padding, size_t dilation) {
+        const size_t span = dilation * (kernel - 1) + 1;
+        if (stride == 0 || input + 2 * padding < span) {
+            throw std::runtime_error("window of " + std::to_string(span) + " does not fit input of " +
+                                     std::to_string(input) + " with padding " + std::to_string(padding));
+        }
+        return (input + 2 * padding - span) / stride + 1;
+    }
+
+    void ImageLayout::check_nchw(const Shape& shape, const char* op) {
+        if (shape.size() != 4) {
+            throw std::runtime_error(std::string(op) + ": expected (N, C, H, W) input, got " +
+                                     ShapeUtils::to_string(shape));
+        }
+    }
+
+}
@@ -0,0 +1,111 @@
+#include "tensor/reduction.hpp"
+#include "tensor/shapeutils.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+namespace cppgrad {
+
+    Reduction::Reduction(const Shape& shape, std::vector<int> dims, bool keepdim)
+    : input_shape_(shape), grouped_(1, 1, 1, 1) {
+        const int rank = static_cast<int>(shape.size());
+        if (dims.empty()) {
+            dims.resize(rank);
+            std::iota(dims.begin(), dims.end(), 0);
+        }
+        std::sort(dims.begin(), dims.end());
+        for (size_t i = 0; i < dims.size(); ++i) {
+            if (dims[i] < 0 || dims[i] >= rank) {
+                throw std::runtime_error("reduction dim " + std::to_string(dims[i]) +
+                                         " out of range for shape " + ShapeUtils::to_string(shape));
+            }
+            if (i > 0 && dims[i] == dims[i - 1]) {
+                throw std::runtime_error("reduction dim " + std::to_string(dims[i]) + " repeated");
+            }
+        }
+
+        std::vector<bool> reduced(rank, false);
+        for (int d : dims) reduced[d] = true;
+        for (int i = 0; i < rank; ++i) {
+            if (!reduced[i]) output_shape_.push_back(shape[i]);
+            else if (keepdim) output_shape_.push_back(1);
+        }
+        if (dims.empty()) return;  // Rank 0: one value, nothing to move
+
+        // A contiguous run of axes is already one block of the column-major buffer
+        const int first = dims.front(), last = dims.back();
+        if (last - first + 1 == static_cast<int>(dims.size())) {
+            for (int i = 0; i < rank; ++i) {
+                const int slot = i < first ? 0 : (i <= last ? 1 : 2);
+                grouped_[slot] *= static_cast<dim_t>(shape[i]);
+            }
+            return;
+        }
+
+        if (rank > 4) {
+            throw std::runtime_error("reduction over non-adjacent axes of " + ShapeUtils::to_string(shape) +
+                                     " needs rank <= 4");
+        }
+        // Kept axes first, reduced axes next, unused ArrayFire dims last
+        size_t next = 0;
+        for (int i = 0; i < rank; ++i) {
+            if (!reduced[i]) {
+                perm_[next++] = static_cast<unsigned>(i);
+                grouped_[0] *= static_cast<dim_t>(shape[i]);
+            }
+        }
+        for (int d : dims) {
+            perm_[next++] = static_cast<unsigned>(d);
+            grouped_[1] *= static_cast<dim_t>(shape[d]);
+        }
+        for (int i = rank; i < 4; ++i) perm_[next++] = static_cast<unsigned>(i);
+        permuted_ = true;
+    }
+
+    Reduction::Reduction(const Shape& shape, int dim, bool keepdim)
+    : Reduction(shape, dim == -1 ? std::vector<int>{} : std::vector<int>{ dim }, keepdim) {}
+
+    af::array Reduction::group(const af::array& data) const {
+        if (!permuted_) return af::moddims(data, grouped_);
+        return af::moddims(af::reorder(data, perm_[0], perm_[1], perm_[2], perm_[3]), grouped_);
+    }
+
+    af::array Reduction::ungroup(const af::array& grouped) const {
+        const af::dim4 dims = ShapeUtils::fold(input_shape_);
+        if (!permuted_) return af::moddims(grouped, dims);
+
+        af::dim4 permuted_dims;
+        std::array<unsigned, 4> inverse;
+        for (unsigned i = 0; i < 4; ++i) {
+            permuted_dims[i] = dims[perm_[i]];
+            inverse[perm_[i]] = i;
+        }
+        return af::reorder(af::moddims(grouped, permuted_dims), inverse[0], inverse[1], inverse[2], inverse[3]);
+    }
+
+    af::array Reduction::result(const af::array& reduced) const {
+        return af::moddims(reduced, ShapeUtils::fold(output_shape_));
+    }
+
+    af::array Reduction::expand(const af::array& grad) const {
+        af::array g = af::moddims(grad, af::dim4(grouped_[0], 1, grouped_[2]));
+        return ungroup(af::tile(g, 1, static_cast<unsigned>(grouped_[1])));
+    }
+
+    af::array Reduction::scatter(const af::array& grad, const af::array& indices) const {
+        const dim_t before = grouped_[0], n = grouped_[1], after = grouped_[2];
+
+        // Linear offset of each chosen element in the (before, n, after) buffer
+        af::array column = af::iota(af::dim4(before, 1, 1), af::dim4(1, 1, after), u32);
+        af::array block = af::iota(af::dim4(1, 1, after), af::dim4(before, 1, 1), u32);
+        af::array offsets = column + block * static_cast<unsigned>(before * n) +
+                            af::moddims(indices, af::dim4(before, 1, after)) * static_cast<unsigned>(before);
+
+        af::array out = af::constant(0, before * n * after);
+        out(af::flat(offsets)) = af::flat(grad);
+        return ungroup(af::moddims(out, grouped_));
+    }
+
+}
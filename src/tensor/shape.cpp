@@ -0,0 +1,124 @@
+#include "tensor/shape.hpp"
+
+#include <algorithm>
+
+namespace cppgrad {
+
+    // ----------------------------------------
+    // Constructors
+    // ----------------------------------------
+
+    Shape::Shape(std::initializer_list<size_t> dims) {
+        reserve(dims.size());
+        std::copy(dims.begin(), dims.end(), data());
+        size_ = dims.size();
+    }
+
+    Shape::Shape(const std::vector<size_t>& dims) {
+        reserve(dims.size());
+        std::copy(dims.begin(), dims.end(), data());
+        size_ = dims.size();
+    }
+
+    Shape::Shape(size_t rank, size_t value) {
+        reserve(rank);
+        std::fill_n(data(), rank, value);
+        size_ = rank;
+    }
+
+    Shape::Shape(const Shape& other) {
+        reserve(other.size_);
+        std::copy(other.begin(), other.end(), data());
+        size_ = other.size_;
+    }
+
+    /// A spilled shape hands over its heap buffer; an inline one is copied.
+    Shape::Shape(Shape&& other) noexcept
+        : heap_(std::move(other.heap_)), capacity_(other.capacity_), size_(other.size_) {
+        if (!heap_) {
+            std::copy(other.inline_, other.inline_ + size_, inline_);
+        }
+        other.capacity_ = kInlineRank;
+        other.size_ = 0;
+    }
+
+    Shape& Shape::operator=(const Shape& other) {
+        if (this != &other) {
+            size_ = 0;
+            reserve(other.size_);
+            std::copy(other.begin(), other.end(), data());
+            size_ = other.size_;
+        }
+        return *this;
+    }
+
+    Shape& Shape::operator=(Shape&& other) noexcept {
+        if (this != &other) {
+            heap_ = std::move(other.heap_);
+            capacity_ = other.capacity_;
+            size_ = other.size_;
+            if (!heap_) {
+                std::copy(other.inline_, other.inline_ + size_, inline_);
+            }
+            other.capacity_ = kInlineRank;
+            other.size_ = 0;
+        }
+        return *this;
+    }
+
+    // ----------------------------------------
+    // Queries
+    // ----------------------------------------
+
+    size_t Shape::numel() const {
+        size_t n = 1;
+        for (size_t d : *this) n *= d;
+        return n;
+    }
+
+    // ----------------------------------------
+    // Modification
+    // ----------------------------------------
+
+    void Shape::push_back(size_t dim) {
+        reserve(size_ + 1);
+        data()[size_++] = dim;
+    }
+
+    Shape::iterator Shape::insert(const_iterator pos, size_t dim) {
+        const size_t at = static_cast<size_t>(pos - begin());
+        reserve(size_ + 1);
+        size_t* d = data();
+        std::copy_backward(d + at, d + size_, d + size_ + 1);
+        d[at] = dim;
+        ++size_;
+        return d + at;
+    }
+
+    Shape::iterator Shape::erase(const_iterator pos) {
+        const size_t at = static_cast<size_t>(pos - begin());
+        size_t* d = data();
+        std::copy(d + at + 1, d + size_, d + at);
+        --size_;
+        return d + at;
+    }
+
+    void Shape::resize(size_t rank, size_t value) {
+        reserve(rank);
+        if (rank > size_) {
+            std::fill(data() + size_, data() + rank, value);
+        }
+        size_ = rank;
+    }
+
+    void Shape::reserve(size_t rank) {
+        if (rank <= capacity_) return;
+
+        const size_t capacity = std::max(rank, capacity_ * 2);
+        std::unique_ptr<size_t[]> grown(new size_t[capacity]);
+        std::copy(begin(), end(), grown.get());
+        heap_ = std::move(grown);
+        capacity_ = capacity;
+    }
+
+} // namespace cppgrad
@@ -0,0 +1,86 @@
+#include "tensor/shapeutils.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace cppgrad {
+
+    // Axes 0-2 map one to one; the rest multiply into dim 3.
+    af::dim4 ShapeUtils::fold(const Shape& shape) {
+        af::dim4 dims(1, 1, 1, 1);
+        for (size_t i = 0; i < shape.size(); ++i) {
+            if (i < 3) {
+                dims[i] = static_cast<dim_t>(shape[i]);
+            } else {
+                dims[3] *= static_cast<dim_t>(shape[i]);
+            }
+        }
+        return dims;
+    }
+
+    // Trailing size-1 dims are not part of the logical rank.
+    Shape ShapeUtils::from_dims(const af::dim4& dims) {
+        unsigned rank = 0;
+        for (unsigned i = 0; i < 4; ++i) {
+            if (dims[i] > 1) rank = i + 1;
+        }
+        Shape shape(rank);
+        for (unsigned i = 0; i < rank; ++i) {
+            shape[i] = static_cast<size_t>(dims[i]);
+        }
+        return shape;
+    }
+
+    size_t ShapeUtils::numel(const Shape& shape) {
+        size_t n = 1;
+        for (auto s : shape) n *= s;
+        return n;
+    }
+
+    af::dim4 ShapeUtils::around(const Shape& shape, int dim) {
+        if (dim < 0 || static_cast<size_t>(dim) >= shape.size()) {
+            throw std::runtime_error("dim " + std::to_string(dim) + " out of range for shape " + to_string(shape));
+        }
+        dim_t before = 1, after = 1;
+        for (int i = 0; i < dim; ++i) before *= static_cast<dim_t>(shape[i]);
+        for (size_t i = dim + 1; i < shape.size(); ++i) after *= static_cast<dim_t>(shape[i]);
+        return af::dim4(before, static_cast<dim_t>(shape[dim]), after, 1);
+    }
+
+    af::array ShapeUtils::permute(const af::array& data, const Shape& shape, const std::vector<unsigned>& perm) {
+        if (perm.size() != shape.size()) {
+            throw std::runtime_error("permute: " + std::to_string(perm.size()) + " axes for shape " + to_string(shape));
+        }
+        af::array out = data;
+        Shape dims = shape;
+        std::vector<unsigned> order(shape.size());    // Input axis now at each position
+        for (unsigned i = 0; i < order.size(); ++i) order[i] = i;
+
+        for (size_t i = 0; i < perm.size(); ++i) {
+            const size_t j = static_cast<size_t>(std::find(order.begin(), order.end(), perm[i]) - order.begin());
+            if (j == i) continue;
+
+            // Axes before i stay put; axis j moves in front of axes i..j-1
+            auto prod = [&](size_t first, size_t last) {
+                dim_t n = 1;
+                for (size_t k = first; k < last; ++k) n *= static_cast<dim_t>(dims[k]);
+                return n;
+            };
+            const af::dim4 grouped(prod(0, i), prod(i, j), static_cast<dim_t>(dims[j]), prod(j + 1, dims.size()));
+            out = af::reorder(af::moddims(out, grouped), 0, 2, 1, 3);
+            std::rotate(dims.begin() + i, dims.begin() + j, dims.begin() + j + 1);
+            std::rotate(order.begin() + i, order.begin() + j, order.begin() + j + 1);
+        }
+        return af::moddims(out, fold(dims));
+    }
+
+    std::string ShapeUtils::to_string(const Shape& shape) {
+        std::string out = "[";
+        for (size_t i = 0; i < shape.size(); ++i) {
+            out += std::to_string(shape[i]);
+            if (i + 1 < shape.size()) out += ", ";
+        }
+        return out + "]";
+    }
+
+}
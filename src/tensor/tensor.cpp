@@ -3,92 +3,116 @@
 #include <algorithm>
 #include <iostream>
 #include <numeric>
+#include <span>
 #include <stdexcept>
+#include <string>
 #include <utility>
 
+#include "autograd/capture.hpp"
+#include "autograd/engine.hpp"
 #include "autograd/function.hpp"
+#include "autograd/gradmode.hpp"
+#include "lazy/graph.hpp"
+#include "lazy/lazymode.hpp"
+#include "tensor/broadcast.hpp"
+#include "tensor/reduction.hpp"
+#include "tensor/shapeutils.hpp"
 
 namespace cppgrad {
 
-    // ----------------------------------------
-    // Constructors - Public
-    // ----------------------------------------
-
-    /// Main constructor: takes a row-major values vector, reshapes and reorders
-    /// it into ArrayFire’s column-major layout, then wraps it in TensorImpl.
-    ///
-    /// Steps:
-    /// 1. Validate that values.size() equals product(shape).
-    /// 2. Load raw 1D data into an ArrayFire array.
-    /// 3. Reverse `shape` to get dimensions for the column-major reshape.
-    /// 4. Call `af::moddims` to reshape into reversed dims.
-    /// 5. Build an axes list `[0,1,2,…]`, reverse it, then call `af::reorder`
-    ///    to permute back to the original axis order.
-    /// 6. Store the result in a new `TensorImpl`.
-    ///
-    /// ArrayFire specifics:
-    /// - Uses **column-major** storage: the fastest-moving index is the first (`dim0`).
-    /// - `af::dim4(d0,d1,d2,d3)` corresponds to sizes in x,y,z,w axes.
-    /// - `moddims`/`reorder` reinterpret the same buffer; no copy of data.
-    ///
-    /// How this plays out for 3D and 4D shapes:
-    ///  • **3D** `(D0, D1, D2)`
-    ///    - Input shape vector: `{D0, D1, D2}`
-    ///    - `to_dim4` yields `(D0, D1, D2, 1)`
-    ///    - Reverse → `(D2, D1, D0, 1)`, reshape to that, then reorder axes
-    ///      back to `(D0, D1, D2)` via `af::reorder` overload for 3 dims.
-    ///
-    ///  • **4D** `(D0, D1, D2, D3)`
-    ///    - Input shape vector: `{D0, D1, D2, D3}`
-    ///    - `to_dim4` yields exactly `(D0, D1, D2, D3)`
-    ///    - Reverse → `(D3, D2, D1, D0)`, reshape to that, then reorder axes
-    ///      via the 4-arg `af::reorder` call to `(D0, D1, D2, D3)`.
-    Tensor::Tensor(const std::vector<size_t>& shape,
-                   const std::vector<float>& values,
-                   bool requires_grad) {
-        // 1) Shape → af::dim4; verify element count
-        af::dim4 dims = to_dim4(shape);
-        size_t expected = dims.elements();
-        if (values.size() != expected) {
-            throw std::invalid_argument("Number of values does not match shape");
+    namespace {
+
+        /// Reorder row-major host values into column-major order for any rank.
+        std::vector<float> row_major_to_column_major(const std::vector<size_t>& shape,
+                                                     std::span<const float> values) {
+            std::vector<float> out(values.size());
+            std::vector<size_t> index(shape.size(), 0);
+            for (size_t src = 0; src < values.size(); ++src) {
+                // Column-major offset of the current row-major multi-index
+                size_t dst = 0, stride = 1;
+                for (size_t d = 0; d < shape.size(); ++d) {
+                    dst += index[d] * stride;
+                    stride *= shape[d];
+                }
+                out[dst] = values[src];
+
+                // Advance the multi-index, last axis fastest
+                for (size_t d = shape.size(); d-- > 0;) {
+                    if (++index[d] < shape[d]) break;
+                    index[d] = 0;
+                }
+            }
+            return out;
         }
 
-        // 2) Load raw linear data
-        af::array arr(static_cast<unsigned>(values.size()), values.data());
+        /// Give a host buffer (already in `arr`, in `layout` order, rank <= 4 if
+        /// row-major) its logical shape. Column-major data only needs a relabel;
+        /// row-major data becomes a view with its axes reversed.
+        std::shared_ptr<TensorImpl> wrap_host_layout(const af::array& arr,
+                                                     const std::vector<size_t>& shape,
+                                                     Layout layout,
+                                                     bool requires_grad) {
+            if (layout == Layout::ColumnMajor || shape.size() <= 1) {
+                return std::make_shared<TensorImpl>(af::moddims(arr, ShapeUtils::fold(shape)), shape, requires_grad);
+            }
+
+            const unsigned rank = static_cast<unsigned>(shape.size());
+            std::vector<size_t> reversed(shape.rbegin(), shape.rend());
+            std::array<unsigned, 4> perm = { 0, 1, 2, 3 };
+            for (unsigned i = 0; i < rank; ++i) perm[i] = rank - 1 - i;
 
-        // 3) Reverse shape for column-major reshape
-        std::vector<size_t> rev_shape(shape.rbegin(), shape.rend());
-        af::dim4 rev_dims = to_dim4(rev_shape);
+            return std::make_shared<TensorImpl>(
+                af::moddims(arr, ShapeUtils::fold(reversed)), perm, shape, requires_grad
+            );
+        }
 
-        // 4) Reshape into reversed dims
-        arr = af::moddims(arr, rev_dims);
+        /// In-place ops are not recorded in the graph, so refuse them wherever
+        /// they would silently detach a result from autograd.
+        void check_inplace(const Tensor& self, const Tensor* other, const char* op) {
+            if (!GradMode::is_enabled()) return;
+            if (self.requires_grad() || (other != nullptr && other->requires_grad())) {
+                throw std::runtime_error(std::string(op) +
+                    ": in-place ops are not tracked by autograd; use them on tensors that "
+                    "do not require grad or inside a NoGradGuard");
+            }
+        }
 
-        // 5) Build and reverse axes list to restore original ordering
-        std::vector<unsigned> axes(shape.size());
-        std::iota(axes.begin(), axes.end(), 0);
-        std::reverse(axes.begin(), axes.end());
+        /// Overwrite the buffer of `impl` with `values` (same dims) and bump its
+        /// version. The assignment writes into the existing buffer when it is not
+        /// shared; a buffer shared with other arrays is copied first.
+        void write_inplace(TensorImpl& impl, const af::array& values) {
+            af::array& data = impl.data();
+            data(af::span, af::span, af::span, af::span) = values;
+            impl.bump_version();
+        }
 
-        // 6) Reorder axes back to row-major layout
-        switch (axes.size()) {
-            case 1:
-                // 1D: no-op
-                break;
-            case 2:
-                arr = af::reorder(arr, axes[0], axes[1]);
-                break;
-            case 3:
-                arr = af::reorder(arr, axes[1], axes[2], axes[0]);
-                break;
-            case 4:
-                arr = af::reorder(arr, axes[3], axes[2], axes[1], axes[0]);
-                break;
-            default:
-                throw std::runtime_error("Tensor constructor only supports up to 4D");
+        void write_inplace(TensorImpl& impl, double value) {
+            af::array& data = impl.data();
+            data(af::span, af::span, af::span, af::span) = value;
+            impl.bump_version();
         }
 
-        // Store in impl
-        impl_ = std::make_shared<TensorImpl>(arr, requires_grad);
-    }
+        /// `other` expanded to `self`'s shape; the result may not grow `self`.
+        af::array inplace_operand(const Tensor& self, const Tensor& other, const char* op) {
+            if (Broadcast::result_shape(self.shape(), other.shape()) != self.shape()) {
+                throw std::runtime_error(std::string(op) + ": cannot broadcast " +
+                    ShapeUtils::to_string(other.shape()) + " into " + ShapeUtils::to_string(self.shape()));
+            }
+            return Broadcast::expand(other.data(), other.shape(), self.shape());
+        }
+
+    } // namespace
+
+    // ----------------------------------------
+    // Constructors - Public
+    // ----------------------------------------
+
+    /// Main constructor: takes a row-major values vector. Same as
+    /// `from_blob(values, shape, Layout::RowMajor, requires_grad)`.
+    Tensor::Tensor(const std::vector<size_t>& shape,
+                   const std::vector<float>& values,
+                   bool requires_grad)
+        : impl_(from_blob(std::span<const float>(values), shape, Layout::RowMajor, requires_grad).impl_) { }
 
     // ----------------------------------------
     // Constructors - Private
@@ -102,75 +126,129 @@ namespace cppgrad {
     Tensor::Tensor(const af::array& arr, bool requires_grad)
         : impl_(std::make_shared<TensorImpl>(arr, requires_grad)) { }
 
+    /// Construct from an array that already has the folded dims of `shape`.
+    Tensor::Tensor(const af::array& arr, bool requires_grad, Shape shape)
+        : impl_(std::make_shared<TensorImpl>(arr, std::move(shape), requires_grad)) { }
+
     // ----------------------------------------
     // Factory Methods
     // ----------------------------------------
 
     /// Create a zero-filled tensor.
     Tensor Tensor::zeros(const std::vector<size_t>& shape, bool requires_grad) {
+        if (LazyMode::is_enabled()) return full(shape, 0.0f, requires_grad);
         af::dim4 dims = to_dim4(shape);
-        return { af::constant(0.0f, dims), requires_grad };
+        return { af::constant(0.0f, dims), requires_grad, shape };
     }
 
     /// Create a one-filled tensor.
     Tensor Tensor::ones(const std::vector<size_t>& shape, bool requires_grad) {
+        if (LazyMode::is_enabled()) return full(shape, 1.0f, requires_grad);
         af::dim4 dims = to_dim4(shape);
-        return { af::constant(1.0f, dims), requires_grad };
+        return { af::constant(1.0f, dims), requires_grad, shape };
     }
 
     /// Create a tensor with all values = `value`.
     Tensor Tensor::full(const std::vector<size_t>& shape,
                         float value,
                         bool requires_grad) {
+        // A constant only becomes a node when nothing accumulates into it
+        if (LazyMode::is_enabled() && !requires_grad) return Tensor(lazy::record_constant(shape, value));
         af::dim4 dims = to_dim4(shape);
-        return { af::constant(value, dims), requires_grad };
+        return { af::constant(value, dims), requires_grad, shape };
     }
 
     /// Create a tensor of Gaussian noise.
     Tensor Tensor::randn(const std::vector<size_t>& shape, bool requires_grad) {
         af::dim4 dims = to_dim4(shape);
-        return { af::randn(dims), requires_grad };
+        return { af::randn(dims), requires_grad, shape };
     }
 
     /// Build tensor from a column-major values vector (simpler than main ctor).
     Tensor Tensor::from_array_column_major(const std::vector<size_t>& shape,
                                            const std::vector<float>& values,
                                            bool requires_grad) {
-        // Validate size
-        size_t expected = 1;
-        for (auto s : shape) expected *= s;
-        if (values.size() != expected) {
-            throw std::invalid_argument("Value count doesn't match shape");
-        }
-        // Reshape directly
+        return from_blob(std::span<const float>(values), shape, Layout::ColumnMajor, requires_grad);
+    }
+
+    /// Copy a host buffer with a single host→device upload.
+    ///
+    /// ArrayFire is column-major. A row-major buffer of shape (D0, …, Dn) is
+    /// byte-for-byte a column-major array of shape (Dn, …, D0), so it is
+    /// uploaded as that and wrapped in a permuted view that reverses the axes.
+    /// The physical reorder is deferred until a kernel reads the data (and
+    /// `matmul` folds a 2D one into the GEMM instead). Above rank 4 the axis
+    /// reversal cannot be expressed with `af::reorder`, so those buffers are
+    /// transposed on the host before the upload.
+    Tensor Tensor::from_blob(std::span<const float> values,
+                             const std::vector<size_t>& shape,
+                             Layout layout,
+                             bool requires_grad) {
         af::dim4 dims = to_dim4(shape);
-        af::array arr(static_cast<unsigned>(values.size()), values.data());
-        arr = af::moddims(arr, dims);
-        return { std::make_shared<TensorImpl>(arr, requires_grad) };
+        if (values.size() != static_cast<size_t>(dims.elements())) {
+            throw std::invalid_argument("Number of values does not match shape");
+        }
+
+        if (layout == Layout::RowMajor && shape.size() > 4) {
+            std::vector<float> column_major = row_major_to_column_major(shape, values);
+            return { std::make_shared<TensorImpl>(af::array(dims, column_major.data()), shape, requires_grad) };
+        }
+        return { wrap_host_layout(af::array(dims, values.data()), shape, layout, requires_grad) };
+    }
+
+    Tensor Tensor::from_blob(const float* data,
+                             const std::vector<size_t>& shape,
+                             Layout layout,
+                             bool requires_grad) {
+        return from_blob(std::span<const float>(data, ShapeUtils::numel(shape)), shape, layout, requires_grad);
+    }
+
+    /// Wrap caller-owned memory. On the CPU backend a device pointer is a host
+    /// pointer, so the buffer is handed to ArrayFire as `afDevice` memory and
+    /// locked, which stops ArrayFire from freeing or recycling it. Other
+    /// backends cannot address host memory and fall back to `from_blob`.
+    Tensor Tensor::borrow(float* data,
+                          const std::vector<size_t>& shape,
+                          Layout layout,
+                          bool requires_grad) {
+        // A row-major view is reordered into a fresh buffer on first use, so
+        // writes to `data` would silently stop showing through
+        if (layout == Layout::RowMajor && shape.size() > 1) {
+            throw std::runtime_error("borrow: only column-major buffers can be wrapped without a copy; "
+                                     "use from_blob for row-major data of shape " + ShapeUtils::to_string(shape));
+        }
+        if (af::getActiveBackend() != AF_BACKEND_CPU) {
+            return from_blob(data, shape, layout, requires_grad);
+        }
+
+        af::array arr(to_dim4(shape), data, afDevice);
+        arr.lock();
+        return { wrap_host_layout(arr, shape, layout, requires_grad) };
     }
 
     // ----------------------------------------
     // Shape & Metadata
     // ----------------------------------------
 
-    /// Return tensor shape as vector<size_t>.
-    std::vector<size_t> Tensor::shape() const {
-        af::dim4 d = impl_->data().dims();
-        std::vector<size_t> out;
-        for (int i = 0; i < 4 && d[i] > 1; ++i) {
-            out.push_back(d[i]);
-        }
-        return out;
+    /// Return the logical tensor shape (any rank). Cached in TensorImpl, so
+    /// this is a reference, not a rebuilt vector.
+    const Shape& Tensor::shape() const {
+        return impl_->shape();
     }
 
     /// Total number of elements.
     size_t Tensor::numel() const {
-        return impl_->data().elements();
+        return impl_->dims().elements();
     }
 
-    /// Number of dimensions (1–4).
+    /// Number of dimensions (0 for a scalar).
     size_t Tensor::ndim() const {
-        return impl_->data().numdims();
+        return impl_->shape().size();
+    }
+
+    /// True if the data is a dense buffer in this tensor's own axis order.
+    bool Tensor::is_contiguous() const {
+        return impl_->is_contiguous();
     }
 
     // ----------------------------------------
@@ -189,12 +267,7 @@ namespace cppgrad {
         data.host(host.data());
 
         // Header
-        std::cout << "Tensor(shape=[";
-        for (int i = 0; i < data.numdims(); ++i) {
-            std::cout << data.dims()[i];
-            if (i + 1 < data.numdims()) std::cout << ", ";
-        }
-        std::cout << "], values=";
+        std::cout << "Tensor(shape=" << ShapeUtils::to_string(shape()) << ", values=";
 
         // Content
         if (host.size() == 1) {
@@ -213,7 +286,7 @@ namespace cppgrad {
     /// Print gradient array (or empty if none).
     void Tensor::print_grad() const {
         if (requires_grad()) {
-            af_print(impl_->grad());
+            af_print(grad());
         } else {
             af_print(af::array());  // prints nothing
         }
@@ -228,18 +301,16 @@ namespace cppgrad {
         return impl_->requires_grad();
     }
 
-    /// Reset stored gradient to zeros.
+    /// Reset stored gradient. The buffer is released rather than filled with
+    /// zeros; the next accumulation allocates it again.
     void Tensor::zero_grad() const {
         if (requires_grad() && impl_->has_autograd()) {
-            impl_->grad() = af::constant(
-                0.0f,
-                impl_->data().dims(),
-                impl_->data().type()
-            );
+            impl_->grad() = af::array();
         }
     }
 
     /// Retrieve the stored gradient array (if any).
+    /// A leaf that has not received a gradient yet reports zeros.
     af::array Tensor::grad() const {
         if (!requires_grad() || !impl_->has_autograd()) {
     #ifndef NDEBUG
@@ -247,12 +318,37 @@ namespace cppgrad {
     #endif
             return {};
         }
-        return impl_->grad();
+        if (impl_->has_grad()) {
+            return impl_->grad();
+        }
+        if (!impl_->retains_grad()) {
+    #ifndef NDEBUG
+            std::cerr << "[warning] grad() called on a non-leaf tensor; call retain_grad() before backward.\n";
+    #endif
+            return {};
+        }
+        return af::constant(0.0f, impl_->data().dims(), impl_->data().type());
+    }
+
+    /// Ask backward to store the gradient of this tensor even if it is an
+    /// intermediate result. No-op for leaves, which always keep theirs.
+    void Tensor::retain_grad() const {
+        if (!requires_grad()) {
+            throw std::runtime_error("retain_grad() called on tensor which does not require gradient");
+        }
+        impl_->set_retains_grad(true);
+    }
+
+    /// True if this tensor was not produced by a recorded operation.
+    bool Tensor::is_leaf() const {
+        return impl_->is_leaf();
     }
 
-    /// Backpropagate from this tensor’s value (seeded with ones).
+    /// Backpropagate from this tensor’s value (seeded with ones unless
+    /// `grad_output` is given). Graph traversal is delegated to `Engine`.
+    /// The graph is freed afterwards unless `retain_graph` is true.
     /// Throws if tensor wasn’t created with requires_grad=true.
-    void Tensor::backward(const af::array & /*ignored*/) {
+    void Tensor::backward(const af::array& grad_output, bool retain_graph) {
         if (!requires_grad() || !impl_->has_autograd()) {
             throw std::runtime_error(
                 "You are calling backward on tensor which does not require gradient"
@@ -266,13 +362,7 @@ namespace cppgrad {
         }
 
         impl_->set_has_called_backward(true);
-        // Seed gradient = 1 for all elements
-        impl_->grad() = af::constant(1, impl_->data().dims());
-
-        // Recursively apply stored Function nodes
-        if (impl_->grad_fn()) {
-            impl_->grad_fn()->apply(impl_->grad());
-        }
+        Engine::backward(impl_, grad_output, retain_graph);
     }
 
     // ----------------------------------------
@@ -296,99 +386,466 @@ namespace cppgrad {
     /// Sum of elements. If dim==-1 sums all, otherwise along `dim`.
     /// If keepdim=true, retains reduced dimension as size=1.
     Tensor Tensor::sum(int dim, bool keepdim) const {
-        af::array result;
-        if (dim == -1) {
-            result = af::sum(af::flat(this->data()));
-        } else {
-            result = af::sum(this->data(), dim);
-            if (keepdim) {
-                af::dim4 d = this->data().dims();
-                d[dim] = 1;
-                result = af::moddims(result, d);
-            }
-        }
+        return sum_over(Reduction(shape(), dim, keepdim));
+    }
+
+    Tensor Tensor::sum(const std::vector<int>& dims, bool keepdim) const {
+        return sum_over(Reduction(shape(), dims, keepdim));
+    }
 
-        Tensor out(result, requires_grad());
+    Tensor Tensor::sum_over(const Reduction& r) const {
+        if (LazyMode::is_enabled()) return Tensor(lazy::record_reduction(lazy::Op::Sum, impl_, r));
+        Tensor out(r.result(af::sum(r.group(this->data()), 1)),
+                   GradMode::is_enabled() && requires_grad(), r.output_shape());
         if (out.requires_grad()) {
-            auto fn = std::make_shared<SumFunction>(
-                this->data().dims(), dim, keepdim
-            );
-            fn->inputs = { impl_ };
+            auto fn = std::make_shared<SumFunction>(r);
+            fn->set_inputs({ impl_ });
             out.impl_->grad_fn() = fn;
         }
+        if (Tape::is_recording()) {
+            Tape::record(out.impl_, { impl_ }, [r](const Tape::Arrays& in) {
+                return Tape::Arrays{ r.result(af::sum(r.group(in[0]), 1)) };
+            });
+        }
         return out;
     }
 
     /// Mean of elements (divides sum by count).
     /// Behavior and keepdim logic similar to sum().
     Tensor Tensor::mean(int dim, bool keepdim) const {
-        af::array result;
-        dim_t count;
-        if (dim == -1) {
-            result = af::mean(af::flat(this->data()));
-            count = this->data().elements();
-        } else {
-            result = af::sum(this->data(), dim);
-            count = this->data().dims(dim);
-            if (keepdim) {
-                af::dim4 d = this->data().dims();
-                d[dim] = 1;
-                result = af::moddims(result, d);
-            }
-            result /= static_cast<float>(count);
-        }
+        return mean_over(Reduction(shape(), dim, keepdim));
+    }
 
-        Tensor out(result, requires_grad());
+    Tensor Tensor::mean(const std::vector<int>& dims, bool keepdim) const {
+        return mean_over(Reduction(shape(), dims, keepdim));
+    }
+
+    Tensor Tensor::mean_over(const Reduction& r) const {
+        if (LazyMode::is_enabled()) return Tensor(lazy::record_reduction(lazy::Op::Mean, impl_, r));
+        af::array result = af::sum(r.group(this->data()), 1) / static_cast<float>(r.count());
+        Tensor out(r.result(result), GradMode::is_enabled() && requires_grad(), r.output_shape());
         if (out.requires_grad()) {
-            auto fn = std::make_shared<MeanFunction>(
-                this->data().dims(), dim, keepdim
-            );
-            fn->inputs = { impl_ };
+            auto fn = std::make_shared<MeanFunction>(r);
+            fn->set_inputs({ impl_ });
             out.impl_->grad_fn() = fn;
         }
+        if (Tape::is_recording()) {
+            Tape::record(out.impl_, { impl_ }, [r](const Tape::Arrays& in) {
+                return Tape::Arrays{ r.result(af::sum(r.group(in[0]), 1) / static_cast<float>(r.count())) };
+            });
+        }
         return out;
     }
 
     /// Maximum of elements. dim==-1 → global max (scalar), otherwise along `dim`.
     /// Retains dimension when keepdim=true.
     Tensor Tensor::max(int dim, bool keepdim) const {
-        af::array result;
+        return extremum_over(Reduction(shape(), dim, keepdim), true);
+    }
+
+    Tensor Tensor::max(const std::vector<int>& dims, bool keepdim) const {
+        return extremum_over(Reduction(shape(), dims, keepdim), true);
+    }
+
+    Tensor Tensor::min(int dim, bool keepdim) const {
+        return extremum_over(Reduction(shape(), dim, keepdim), false);
+    }
+
+    Tensor Tensor::min(const std::vector<int>& dims, bool keepdim) const {
+        return extremum_over(Reduction(shape(), dims, keepdim), false);
+    }
+
+    Tensor Tensor::extremum_over(const Reduction& r, bool largest) const {
+        af::array values, indices;
+        if (largest) af::max(values, indices, r.group(this->data()), 1);
+        else af::min(values, indices, r.group(this->data()), 1);
+
+        Tensor out(r.result(values), GradMode::is_enabled() && requires_grad(), r.output_shape());
+        if (out.requires_grad()) {
+            // The winning position of each column; backward scatters to it
+            // (the first one on ties) instead of comparing against the input again
+            std::shared_ptr<Function> fn;
+            if (largest) fn = std::make_shared<MaxFunction>(r);
+            else fn = std::make_shared<MinFunction>(r);
+            fn->set_inputs({ impl_ });
+            fn->save_for_backward({ indices });
+            out.impl_->grad_fn() = fn;
+        }
+        return out;
+    }
+
+    /// Product of elements; backward is exact at zeros (no division by the input).
+    Tensor Tensor::prod(int dim, bool keepdim) const {
+        return prod_over(Reduction(shape(), dim, keepdim));
+    }
+
+    Tensor Tensor::prod(const std::vector<int>& dims, bool keepdim) const {
+        return prod_over(Reduction(shape(), dims, keepdim));
+    }
+
+    Tensor Tensor::prod_over(const Reduction& r) const {
+        Tensor out(r.result(af::product(r.group(this->data()), 1)),
+                   GradMode::is_enabled() && requires_grad(), r.output_shape());
+        if (out.requires_grad()) {
+            auto fn = std::make_shared<ProdFunction>(r);
+            fn->set_inputs({ impl_ });
+            out.impl_->grad_fn() = fn;
+        }
+        return out;
+    }
+
+    /// Variance with Bessel's correction when `unbiased`. Mean and variance
+    /// come from one `af::meanvar` pass (Welford-style accumulation), so there
+    /// is no E[x²] - E[x]² cancellation.
+    Tensor Tensor::var(int dim, bool unbiased, bool keepdim) const {
+        return var_over(Reduction(shape(), dim, keepdim), unbiased, false);
+    }
+
+    Tensor Tensor::var(const std::vector<int>& dims, bool unbiased, bool keepdim) const {
+        return var_over(Reduction(shape(), dims, keepdim), unbiased, false);
+    }
+
+    Tensor Tensor::std(int dim, bool unbiased, bool keepdim) const {
+        return var_over(Reduction(shape(), dim, keepdim), unbiased, true);
+    }
+
+    Tensor Tensor::std(const std::vector<int>& dims, bool unbiased, bool keepdim) const {
+        return var_over(Reduction(shape(), dims, keepdim), unbiased, true);
+    }
+
+    Tensor Tensor::var_over(const Reduction& r, bool unbiased, bool take_sqrt) const {
+        af::array mean, variance;
+        af::meanvar(mean, variance, r.group(this->data()), af::array(),
+                    unbiased ? AF_VARIANCE_SAMPLE : AF_VARIANCE_POPULATION, 1);
+        af::array result = take_sqrt ? af::sqrt(variance) : variance;
+
+        Tensor out(r.result(result), GradMode::is_enabled() && requires_grad(), r.output_shape());
+        if (out.requires_grad()) {
+            std::shared_ptr<Function> fn;
+            if (take_sqrt) fn = std::make_shared<StdFunction>(r, unbiased);
+            else fn = std::make_shared<VarFunction>(r, unbiased);
+            fn->set_inputs({ impl_ });
+            if (take_sqrt) fn->save_for_backward({ mean, result });
+            else fn->save_for_backward({ mean });
+            out.impl_->grad_fn() = fn;
+        }
+        return out;
+    }
+
+    /// Index of the largest element along `dim`, as floats. With dim == -1 the
+    /// index is into the row-major flattening (as `torch.argmax`). Not differentiable.
+    Tensor Tensor::argmax(int dim, bool keepdim) const {
+        return arg_extremum(dim, keepdim, true);
+    }
+
+    Tensor Tensor::argmin(int dim, bool keepdim) const {
+        return arg_extremum(dim, keepdim, false);
+    }
+
+    Tensor Tensor::arg_extremum(int dim, bool keepdim, bool largest) const {
+        const Reduction r(shape(), dim, keepdim);
+        af::array values, indices;
+        if (largest) af::max(values, indices, r.group(this->data()), 1);
+        else af::min(values, indices, r.group(this->data()), 1);
+
+        af::array result = indices.as(f32);
         if (dim == -1) {
-            result = af::max<af::array>(af::flat(this->data()));
-            result = af::moddims(result, af::dim4(1,1,1,1));
+            // Column-major flat index → multi-index → row-major flat index
+            const Shape& in_shape = shape();
+            af::array remaining = indices.as(f64);
+            af::array row_major = af::constant(0, 1, f64);
+            double row_stride = 1;
+            for (size_t d = in_shape.size(); d-- > 0;) row_stride *= static_cast<double>(in_shape[d]);
+            for (size_t d = 0; d < in_shape.size(); ++d) {
+                const double n = static_cast<double>(in_shape[d]);
+                row_stride /= n;
+                af::array coord = af::mod(remaining, n);
+                remaining = (remaining - coord) / n;
+                row_major = row_major + coord * row_stride;
+            }
+            result = row_major.as(f32);
+        }
+        return Tensor(r.result(result), false, r.output_shape());
+    }
+
+    // ----------------------------------------
+    // View Operations
+    // ----------------------------------------
+
+    /// Slice along one axis. ArrayFire returns seq-indexed sub-arrays as
+    /// strided references into the parent buffer, so up to rank 4 no data is
+    /// copied. Above rank 4 the folded axes cannot be indexed separately and
+    /// the slice is taken from a (before, n, after) view and copied out.
+    Tensor Tensor::slice(int dim, long start, long end, long step) const {
+        const Shape& in_shape = shape();
+        if (dim < 0 || static_cast<size_t>(dim) >= in_shape.size()) {
+            throw std::runtime_error("slice: dim out of range for shape " + ShapeUtils::to_string(in_shape));
+        }
+        if (step <= 0) {
+            throw std::runtime_error("slice: step must be positive");
+        }
+
+        const long size = static_cast<long>(in_shape[dim]);
+        if (start < 0) start += size;
+        if (end < 0) end += size;
+        start = std::clamp(start, 0L, size);
+        end = std::clamp(end, 0L, size);
+        if (start >= end) {
+            throw std::runtime_error("slice: empty range");
+        }
+
+        const long count = (end - start + step - 1) / step;
+        const long last = start + (count - 1) * step;
+        const af::seq window(static_cast<double>(start), static_cast<double>(last), static_cast<double>(step));
+
+        Shape out_shape = in_shape;
+        out_shape[dim] = static_cast<size_t>(count);
+
+        af::array base = impl_->data();
+        af::array result;
+        if (in_shape.size() <= 4) {
+            af::index idx[4] = { af::span, af::span, af::span, af::span };
+            idx[dim] = window;
+            result = base(idx[0], idx[1], idx[2], idx[3]);
         } else {
-            result = af::max(this->data(), dim);
-            if (keepdim) {
-                af::dim4 d = this->data().dims();
-                d[dim] = 1;
-                result = af::moddims(result, d);
+            af::array grouped = af::moddims(base, ShapeUtils::around(in_shape, dim));
+            result = af::moddims(grouped(af::span, window, af::span).copy(), ShapeUtils::fold(out_shape));
+        }
+
+        Tensor out(result, GradMode::is_enabled() && requires_grad(), out_shape);
+        if (out.requires_grad()) {
+            auto fn = std::make_shared<SliceFunction>(in_shape, dim, start, last, step);
+            fn->set_inputs({ impl_ });
+            out.impl_->grad_fn() = fn;
+        }
+        return out;
+    }
+
+    Tensor Tensor::reshape(const Shape& shape) const {
+        return reshape_to(shape, false);
+    }
+
+    Tensor Tensor::view(const Shape& shape) const {
+        return reshape_to(shape, true);
+    }
+
+    /// Permute axes. Permuting a pending permute composes the two axis orders
+    /// over the original source, so chains such as `x.transpose().transpose()`
+    /// never copy. Above rank 4 there is no pending form, and the result is
+    /// materialized by `ShapeUtils::permute`.
+    Tensor Tensor::permute(const std::vector<unsigned>& dims) const {
+        const Shape& in_shape = shape();
+        if (dims.size() > 4 || in_shape.size() > 4) return permute_copy(dims);
+
+        // Explicit axes first, then the untouched ones in order
+        std::array<unsigned, 4> perm{};
+        std::array<bool, 4> used{};
+        for (size_t i = 0; i < dims.size(); ++i) {
+            if (dims[i] > 3 || used[dims[i]]) {
+                throw std::runtime_error("permute: dims must be a permutation of axes 0-3");
+            }
+            perm[i] = dims[i];
+            used[dims[i]] = true;
+        }
+        for (unsigned axis = 0, i = static_cast<unsigned>(dims.size()); i < 4; ++axis) {
+            if (!used[axis]) perm[i++] = axis;
+        }
+
+        // Output rank reaches the last axis that receives one of the input's axes
+        Shape out_shape(4, 1);
+        size_t rank = in_shape.size();
+        for (unsigned i = 0; i < 4; ++i) {
+            if (perm[i] < in_shape.size()) {
+                out_shape[i] = in_shape[perm[i]];
+                rank = std::max<size_t>(rank, i + 1);
             }
         }
+        out_shape.resize(rank);
+
+        af::array source;
+        std::array<unsigned, 4> inner{};
+        std::array<unsigned, 4> total = perm;
+        if (impl_->permuted_source(source, inner)) {
+            for (unsigned i = 0; i < 4; ++i) total[i] = inner[perm[i]];
+        } else {
+            source = impl_->data();
+        }
 
-        Tensor out(result, requires_grad());
+        Tensor out(std::make_shared<TensorImpl>(source, total, out_shape, GradMode::is_enabled() && requires_grad()));
         if (out.requires_grad()) {
-            auto fn = std::make_shared<MaxFunction>(
-                this->data(), dim, keepdim
-            );
-            fn->inputs = { impl_ };
+            auto fn = std::make_shared<PermuteFunction>(perm);
+            fn->set_inputs({ impl_ });
             out.impl_->grad_fn() = fn;
         }
         return out;
     }
 
+    Tensor Tensor::permute_copy(const std::vector<unsigned>& dims) const {
+        const Shape& in_shape = shape();
+        const size_t n = std::max(in_shape.size(), dims.size());
+
+        // Explicit axes first, then the untouched ones in order
+        std::vector<unsigned> perm(dims);
+        std::vector<bool> used(n);
+        for (unsigned axis : dims) {
+            if (axis >= n || used[axis]) {
+                throw std::runtime_error("permute: dims must be a permutation of axes 0-" + std::to_string(n - 1));
+            }
+            used[axis] = true;
+        }
+        for (unsigned axis = 0; axis < n; ++axis) {
+            if (!used[axis]) perm.push_back(axis);
+        }
+
+        Shape padded = in_shape;
+        padded.resize(n, 1);
+        Shape out_shape(n);
+        size_t rank = in_shape.size();
+        for (size_t i = 0; i < n; ++i) {
+            out_shape[i] = padded[perm[i]];
+            if (perm[i] < in_shape.size()) rank = std::max(rank, i + 1);
+        }
+
+        Shape trimmed = out_shape;
+        trimmed.resize(rank);
+
+        Tensor out(ShapeUtils::permute(impl_->data(), padded, perm),
+                   GradMode::is_enabled() && requires_grad(), std::move(trimmed));
+        if (out.requires_grad()) {
+            auto fn = std::make_shared<PermuteFunction>(std::move(perm), std::move(out_shape));
+            fn->set_inputs({ impl_ });
+            out.impl_->grad_fn() = fn;
+        }
+        return out;
+    }
+
+    Tensor Tensor::transpose(int dim0, int dim1) const {
+        const int n = static_cast<int>(std::max<size_t>(4, ndim()));
+        if (dim0 < 0 || dim0 >= n || dim1 < 0 || dim1 >= n) {
+            throw std::runtime_error("transpose: dims must be in [0, " + std::to_string(n - 1) + "]");
+        }
+        std::vector<unsigned> perm(n);
+        std::iota(perm.begin(), perm.end(), 0u);
+        std::swap(perm[dim0], perm[dim1]);
+        return permute(perm);
+    }
+
+    Tensor Tensor::squeeze(int dim) const {
+        const Shape& in_shape = shape();
+        Shape out_shape;
+        for (size_t i = 0; i < in_shape.size(); ++i) {
+            bool drop = in_shape[i] == 1 && (dim == -1 || dim == static_cast<int>(i));
+            if (!drop) out_shape.push_back(in_shape[i]);
+        }
+        return reshape_to(std::move(out_shape), false);
+    }
+
+    Tensor Tensor::unsqueeze(int dim) const {
+        Shape out_shape = shape();
+        if (dim < 0 || static_cast<size_t>(dim) > out_shape.size()) {
+            throw std::runtime_error("unsqueeze: dim out of range for shape " + ShapeUtils::to_string(out_shape));
+        }
+        out_shape.insert(out_shape.begin() + dim, 1);
+        return reshape_to(std::move(out_shape), false);
+    }
+
+    /// `af::moddims` only rewrites metadata on a dense buffer; on a strided
+    /// slice or pending permute the data is materialized first.
+    Tensor Tensor::reshape_to(Shape shape, bool require_contiguous) const {
+        if (static_cast<dim_t>(ShapeUtils::numel(shape)) != impl_->dims().elements()) {
+            throw std::runtime_error("reshape: element count does not match");
+        }
+        if (require_contiguous && !impl_->is_contiguous()) {
+            throw std::runtime_error("view: tensor is not contiguous; use reshape()");
+        }
+
+        af::array src = impl_->data();
+        af::array result = af::moddims(src, ShapeUtils::fold(shape));
+        Tensor out(result, GradMode::is_enabled() && requires_grad(), std::move(shape));
+        if (out.requires_grad()) {
+            auto fn = std::make_shared<ReshapeFunction>(src.dims());
+            fn->set_inputs({ impl_ });
+            out.impl_->grad_fn() = fn;
+        }
+        if (Tape::is_recording()) {
+            Tape::record(out.impl_, { impl_ }, [dims = result.dims()](const Tape::Arrays& in) {
+                return Tape::Arrays{ af::moddims(in[0], dims) };
+            });
+        }
+        return out;
+    }
+
+    // ----------------------------------------
+    // In-place Operations
+    // ----------------------------------------
+
+    Tensor& Tensor::add_(const Tensor& other) {
+        check_inplace(*this, &other, "add_");
+        write_inplace(*impl_, impl_->data() + inplace_operand(*this, other, "add_"));
+        return *this;
+    }
+
+    Tensor& Tensor::add_(float scalar) {
+        check_inplace(*this, nullptr, "add_");
+        write_inplace(*impl_, impl_->data() + scalar);
+        return *this;
+    }
+
+    Tensor& Tensor::sub_(const Tensor& other) {
+        check_inplace(*this, &other, "sub_");
+        write_inplace(*impl_, impl_->data() - inplace_operand(*this, other, "sub_"));
+        return *this;
+    }
+
+    Tensor& Tensor::sub_(float scalar) {
+        check_inplace(*this, nullptr, "sub_");
+        write_inplace(*impl_, impl_->data() - scalar);
+        return *this;
+    }
+
+    Tensor& Tensor::mul_(const Tensor& other) {
+        check_inplace(*this, &other, "mul_");
+        write_inplace(*impl_, impl_->data() * inplace_operand(*this, other, "mul_"));
+        return *this;
+    }
+
+    Tensor& Tensor::mul_(float scalar) {
+        check_inplace(*this, nullptr, "mul_");
+        write_inplace(*impl_, impl_->data() * scalar);
+        return *this;
+    }
+
+    Tensor& Tensor::fill_(float value) {
+        check_inplace(*this, nullptr, "fill_");
+        write_inplace(*impl_, static_cast<double>(value));
+        return *this;
+    }
+
+    Tensor& Tensor::zero_() {
+        return fill_(0.0f);
+    }
+
+    Tensor& Tensor::clamp_(float min, float max) {
+        check_inplace(*this, nullptr, "clamp_");
+        if (min > max) {
+            throw std::runtime_error("clamp_: min must not exceed max");
+        }
+        write_inplace(*impl_, af::clamp(impl_->data(), min, max));
+        return *this;
+    }
+
+    uint64_t Tensor::version() const {
+        return impl_->version();
+    }
 
     // ----------------------------------------
     // Utility
     // ----------------------------------------
 
     /// Convert a shape vector (row-major) into ArrayFire’s 4D dims.
-    /// If shape.size() > 4, higher dimensions are ignored.
+    /// Axes beyond the fourth are folded into dim 3 (see ShapeUtils::fold).
     af::dim4 Tensor::to_dim4(const std::vector<size_t>& shape) {
-        af::dim4 dims(1, 1, 1, 1);
-        for (size_t i = 0; i < std::min(static_cast<size_t>(4), shape.size()); ++i) {
-            dims[i] = shape[i];
-        }
-        return dims;
+        return ShapeUtils::fold(shape);
     }
 
 }  // namespace cppgrad
@@ -1,27 +1,130 @@
 #include "tensor/tensorimpl.hpp"
+#include "autograd/capture.hpp"
+#include "autograd/function.hpp"
+#include "autograd/gradmode.hpp"
+#include "lazy/passes.hpp"
+#include "tensor/shapeutils.hpp"
 
 
 namespace cppgrad {
 
     // Constructor: wraps an ArrayFire array and optionally enables autograd.
     // If `requires_grad` is true, initializes AutogradMeta to track gradient info.
-    TensorImpl::TensorImpl(const af::array &d, bool requires_grad)
-    : data_(d) {
-        if (requires_grad) {
-            autograd_ = std::make_unique<AutogradMeta>(true, data_);
+    // Inside an InferenceMode scope no autograd metadata is ever allocated.
+    TensorImpl::TensorImpl(const af::array &d, Shape shape, bool requires_grad)
+    : data_(d), shape_(std::move(shape)) {
+        Tape::note_allocation();
+        if (requires_grad && !GradMode::is_inference_mode()) {
+            autograd_ = std::make_unique<AutogradMeta>(true);
         }
     }
 
+    // Without an explicit shape the rank is inferred from the array dims.
+    TensorImpl::TensorImpl(const af::array &d, bool requires_grad)
+    : TensorImpl(d, ShapeUtils::from_dims(d.dims()), requires_grad) {}
+
+    // View constructor: keeps `source` untouched and records the axis order.
+    // An identity permutation is not pending, so the view is contiguous.
+    TensorImpl::TensorImpl(const af::array& source, const std::array<unsigned, 4>& perm,
+                           Shape shape, bool requires_grad)
+    : TensorImpl(source, std::move(shape), requires_grad) {
+        perm_ = perm;
+        pending_permute_.store(perm != std::array<unsigned, 4>{0, 1, 2, 3}, std::memory_order_release);
+    }
+
+    // Lazy constructor: no data until first read. The backward node is only
+    // attached on demand, since most lazy intermediates never need one.
+    TensorImpl::TensorImpl(std::shared_ptr<lazy::Node> node, bool requires_grad)
+    : TensorImpl(af::array(), node->shape, requires_grad) {
+        lazy_ = std::move(node);
+        pending_lazy_.store(true, std::memory_order_release);
+        pending_grad_fn_.store(autograd_ != nullptr, std::memory_order_release);
+    }
+
     // Const accessor for the underlying data array.
     const af::array& TensorImpl::data() const {
+        materialize();
         return data_;
     }
 
     // Mutable accessor for the underlying data array.
     af::array& TensorImpl::data() {
+        materialize();
         return data_;
     }
 
+    // Produce the reordered copy of a permuted view, once. Readers racing on
+    // the first access (e.g. parallel backward workers) serialize on the mutex.
+    // A lazy result runs the graph passes for its node instead.
+    void TensorImpl::materialize() const {
+        if (pending_lazy_.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(view_mutex_);
+            if (pending_lazy_.load(std::memory_order_relaxed)) {
+                data_ = lazy::evaluate({ lazy_ }).front();
+                pending_lazy_.store(false, std::memory_order_release);
+            }
+            return;
+        }
+        if (!pending_permute_.load(std::memory_order_acquire)) return;
+        std::lock_guard<std::mutex> lock(view_mutex_);
+        if (!pending_permute_.load(std::memory_order_relaxed)) return;
+        data_ = af::reorder(data_, perm_[0], perm_[1], perm_[2], perm_[3]);
+        pending_permute_.store(false, std::memory_order_release);
+    }
+
+    void TensorImpl::attach_lazy_grad_fn() const {
+        if (!pending_grad_fn_.load(std::memory_order_acquire)) return;
+        std::lock_guard<std::mutex> lock(view_mutex_);
+        if (!pending_grad_fn_.load(std::memory_order_relaxed)) return;
+        autograd_->grad_fn = std::make_shared<LazyFunction>(lazy_);
+        pending_grad_fn_.store(false, std::memory_order_release);
+    }
+
+    const std::shared_ptr<lazy::Node>& TensorImpl::lazy_node() const {
+        return lazy_;
+    }
+
+    bool TensorImpl::is_lazy() const {
+        return pending_lazy_.load(std::memory_order_acquire);
+    }
+
+    const Shape& TensorImpl::shape() const {
+        return shape_;
+    }
+
+    // ArrayFire dims of the tensor: the source dims permuted by perm_.
+    af::dim4 TensorImpl::dims() const {
+        if (pending_lazy_.load(std::memory_order_acquire)) return ShapeUtils::fold(shape_);
+        if (pending_permute_.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(view_mutex_);
+            if (pending_permute_.load(std::memory_order_relaxed)) {
+                af::dim4 src = data_.dims();
+                return af::dim4(src[perm_[0]], src[perm_[1]], src[perm_[2]], src[perm_[3]]);
+            }
+        }
+        return data_.dims();
+    }
+
+    // Contiguous means a dense column-major buffer: no pending permute and not
+    // a strided sub-array produced by indexing.
+    bool TensorImpl::is_contiguous() const {
+        if (pending_lazy_.load(std::memory_order_acquire)) return true;   // Computed into a fresh buffer
+        if (pending_permute_.load(std::memory_order_acquire)) return false;
+        bool linear = true;
+        af_is_linear(&linear, data_.get());
+        return linear;
+    }
+
+    // Snapshot the source and axis order of a pending permutation.
+    bool TensorImpl::permuted_source(af::array& source, std::array<unsigned, 4>& perm) const {
+        if (!pending_permute_.load(std::memory_order_acquire)) return false;
+        std::lock_guard<std::mutex> lock(view_mutex_);
+        if (!pending_permute_.load(std::memory_order_relaxed)) return false;
+        source = data_;
+        perm = perm_;
+        return true;
+    }
+
     // Checks if autograd is enabled for this tensor.
     // True only if autograd_ is initialized and requires_grad is set.
     bool TensorImpl::requires_grad() const {
@@ -44,13 +147,48 @@ namespace cppgrad {
         return autograd_->grad;
     }
 
+    // True once the gradient buffer has been allocated by accumulate_grad().
+    bool TensorImpl::has_grad() const {
+        return autograd_ && !autograd_->grad.isempty();
+    }
+
+    // Accumulate `g` into the gradient. The first accumulation adopts `g` as the
+    // buffer instead of adding it to a freshly allocated zero array.
+    void TensorImpl::accumulate_grad(const af::array& g) {
+        std::lock_guard<std::mutex> lock(grad_mutex_);
+        if (autograd_->grad.isempty()) {
+            autograd_->grad = g;
+        } else {
+            autograd_->grad += g;
+        }
+    }
+
+    // A leaf was created by the user rather than by a recorded operation.
+    bool TensorImpl::is_leaf() const {
+        attach_lazy_grad_fn();
+        return !autograd_ || !autograd_->grad_fn;
+    }
+
+    // Leaves always keep their gradient; intermediates only when asked to.
+    bool TensorImpl::retains_grad() const {
+        attach_lazy_grad_fn();
+        return autograd_ && (autograd_->retains_grad || !autograd_->grad_fn);
+    }
+
+    // Opt a non-leaf tensor in (or out) of storing its gradient during backward.
+    void TensorImpl::set_retains_grad(bool retains_grad) {
+        autograd_->retains_grad = retains_grad;
+    }
+
     // Mutable accessor to the backward function responsible for computing this tensor's grad.
     std::shared_ptr<Function>& TensorImpl::grad_fn() {
+        attach_lazy_grad_fn();
         return autograd_->grad_fn;
     }
 
     // Const accessor to the backward function.
     const std::shared_ptr<Function>& TensorImpl::grad_fn() const {
+        attach_lazy_grad_fn();
         return autograd_->grad_fn;
     }
 
@@ -64,6 +202,14 @@ namespace cppgrad {
         this->autograd_->has_called_backward = has_called_backwards;
     }
 
+    uint64_t TensorImpl::version() const {
+        return version_.load(std::memory_order_acquire);
+    }
+
+    void TensorImpl::bump_version() {
+        version_.fetch_add(1, std::memory_order_acq_rel);
+    }
+
 } // namespace cppgrad
 
 
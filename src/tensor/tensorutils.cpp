@@ -1,5 +1,9 @@
 #include "tensor/tensorutils.hpp"
+#include "autograd/capture.hpp"
 #include "autograd/function.hpp"
+#include "autograd/gradmode.hpp"
+#include "tensor/gemm.hpp"
+#include "tensor/shapeutils.hpp"
 #include "tensor/tensor.hpp"
 
 namespace cppgrad {
@@ -9,40 +13,64 @@ namespace cppgrad {
     Tensor TensorUtils::clone(const Tensor& input) {
         af::array cloned_data = input.data().copy();  // Deep copy of underlying array
 
-        auto new_impl = std::make_shared<TensorImpl>(cloned_data, false);  // No autograd tracking
+        auto new_impl = std::make_shared<TensorImpl>(cloned_data, input.shape(), false);  // No autograd tracking
         return Tensor(new_impl);
     }
 
     // Clone tensor and preserve autograd tracking if input.requires_grad() is true.
     Tensor TensorUtils::clone_with_grad(const Tensor& input) {
         af::array cloned_data = input.data().copy();  // Deep copy
-        bool req_grad = input.requires_grad();        // Carry over autograd flag
+        bool req_grad = GradMode::is_enabled() && input.requires_grad();  // Carry over autograd flag
 
-        auto new_impl = std::make_shared<TensorImpl>(cloned_data, req_grad);
+        auto new_impl = std::make_shared<TensorImpl>(cloned_data, input.shape(), req_grad);
         Tensor out(new_impl);
 
         // Register a backward function for autograd graph
         if (req_grad) {
             auto fn = std::make_shared<CloneFunction>();  // Forward clone op
-            fn->inputs = { input.impl_ };                 // Save input tensor for backward
+            fn->set_inputs({ input.impl_ });              // Save input tensor for backward
             out.impl_->grad_fn() = fn;                    // Attach backward function
         }
 
         return out;
     }
 
-    // Matrix multiplication: performs af::matmul(a, b)
+    // Matrix multiplication: performs af::matmul(a, b), batched over leading axes.
     // Returns a new tensor with autograd if either input requires gradients.
     Tensor TensorUtils::matmul(const Tensor &a, const Tensor &b) {
-        const af::array& a_data = a.data();
-        const af::array& b_data = b.data();
-
-        af::array result_data = af::matmul(a_data, b_data);  // Matrix product: M×K × K×N = M×N
+        const Shape& a_shape = a.shape();
+        const Shape& b_shape = b.shape();
+        Shape out_shape = Gemm::result_shape(a_shape, b_shape);
+
+        af::array result_data;
+        if (a_shape.size() <= 2 && b_shape.size() <= 2) {
+            // Plain GEMM; a pending transpose of either side becomes a flag
+            af_mat_prop a_prop, b_prop;
+            af::array a_data = Gemm::operand(*a.impl_, a_prop);
+            af::array b_data = Gemm::operand(*b.impl_, b_prop);
+            result_data = af::matmul(a_data, b_data, a_prop, b_prop);  // Matrix product: M×K × K×N = M×N
+        } else if (b_shape.size() == 2) {
+            // (b..., M, K) @ (K, N): the batch axes fold into the rows of one GEMM
+            af_mat_prop b_prop;
+            af::array b_data = Gemm::operand(*b.impl_, b_prop);
+            const dim_t rows = Gemm::batch_count(a_shape) * static_cast<dim_t>(a_shape[a_shape.size() - 2]);
+            af::array a_rows = af::moddims(a.data(), rows, static_cast<dim_t>(a_shape.back()));
+            result_data = af::moddims(af::matmul(a_rows, b_data, AF_MAT_NONE, b_prop), ShapeUtils::fold(out_shape));
+        } else {
+            // Batched GEMM; a 2D left operand is shared by every batch entry
+            const dim_t batch = Gemm::batch_count(b_shape);
+            af::array a_data = a_shape.size() == 2
+                ? af::tile(a.data(), 1, 1, static_cast<unsigned>(batch))
+                : Gemm::to_batched(a.data(), a_shape);
+            af::array b_data = Gemm::to_batched(b.data(), b_shape);
+            result_data = Gemm::from_batched(af::matmul(a_data, b_data), out_shape);
+        }
 
         // Enable gradient tracking if either input requires gradients
         auto result_impl = std::make_shared<TensorImpl>(
             result_data,
-            /*requires_grad=*/a.requires_grad() || b.requires_grad()
+            std::move(out_shape),
+            /*requires_grad=*/GradMode::is_enabled() && (a.requires_grad() || b.requires_grad())
         );
 
         Tensor result(result_impl);
@@ -50,19 +78,34 @@ namespace cppgrad {
         // If autograd enabled, attach MatMulFunction to compute backward later
         if (result.requires_grad()) {
             auto fn = std::make_shared<MatMulFunction>();
-            fn->inputs = { a.impl_, b.impl_ };         // Save inputs for backward
+            fn->set_inputs({ a.impl_, b.impl_ });      // Save inputs for backward
             result_impl->grad_fn() = fn;               // Attach function to result
         }
 
+        // Replay reads materialized operands, so no transpose flags are needed
+        if (Tape::is_recording()) {
+            Tape::record(result_impl, { a.impl_, b.impl_ },
+                         [a_shape, b_shape, out_shape = result_impl->shape()](const Tape::Arrays& in) {
+                if (a_shape.size() <= 2 && b_shape.size() <= 2) return Tape::Arrays{ af::matmul(in[0], in[1]) };
+                if (b_shape.size() == 2) {
+                    const dim_t rows = Gemm::batch_count(a_shape) * static_cast<dim_t>(a_shape[a_shape.size() - 2]);
+                    af::array a_rows = af::moddims(in[0], rows, static_cast<dim_t>(a_shape.back()));
+                    return Tape::Arrays{ af::moddims(af::matmul(a_rows, in[1]), ShapeUtils::fold(out_shape)) };
+                }
+                af::array a_data = a_shape.size() == 2
+                    ? af::tile(in[0], 1, 1, static_cast<unsigned>(Gemm::batch_count(b_shape)))
+                    : Gemm::to_batched(in[0], a_shape);
+                return Tape::Arrays{ Gemm::from_batched(af::matmul(a_data, Gemm::to_batched(in[1], b_shape)), out_shape) };
+            });
+        }
+
         return result;
     }
 
     // Transpose a 2D tensor (swap rows and columns).
-    // Keeps autograd flag from original tensor.
+    // Returns a lazy view with a Permute node, see Tensor::transpose().
     Tensor TensorUtils::transpose(const Tensor &t) {
-        af::array t_data = af::transpose(t.data());  // Transpose: M×N → N×M
-        auto new_impl = std::make_shared<TensorImpl>(t_data, t.requires_grad());
-        return {new_impl};  // Construct new Tensor
+        return t.transpose(0, 1);  // Transpose: M×N → N×M
     }
 
 } // namespace cppgrad
@@ -1,7 +1,33 @@
 #include <catch2/catch_test_macros.hpp>
 #include "cppgrad/tensor/tensor.hpp"
 #include "cppgrad/tensor/tensorutils.hpp"
+#include "cppgrad/autograd/gradmode.hpp"
+#include "cppgrad/autograd/engine.hpp"
+#include "cppgrad/autograd/function.hpp"
+#include "cppgrad/autograd/capture.hpp"
+#include "cppgrad/autograd/checkpoint.hpp"
+#include "cppgrad/lazy/lazymode.hpp"
+#include "cppgrad/ops/avg_pool2d.hpp"
+#include "cppgrad/ops/batch_norm.hpp"
+#include "cppgrad/ops/conv2d.hpp"
+#include "cppgrad/ops/cross_entropy.hpp"
+#include "cppgrad/ops/dropout.hpp"
+#include "cppgrad/ops/embedding.hpp"
+#include "cppgrad/ops/layer_norm.hpp"
+#include "cppgrad/ops/linear.hpp"
+#include "cppgrad/ops/logsumexp.hpp"
+#include "cppgrad/ops/max_pool2d.hpp"
+#include "cppgrad/nn/activation.hpp"
+#include "cppgrad/nn/dropout.hpp"
+#include "cppgrad/nn/embedding.hpp"
+#include "cppgrad/nn/linear.hpp"
+#include "cppgrad/nn/sequential.hpp"
+#include "cppgrad/optim/adam.hpp"
+#include "cppgrad/optim/sgd.hpp"
 #include <catch2/catch_approx.hpp>
+#include <cmath>
+#include <cstring>
+#include <tuple>
 
 using namespace Catch;
 
@@ -22,6 +48,7 @@ TEST_CASE("Test1: e = a*b + d backward grads", "[autograd]") {
     auto d = cppgrad::Tensor::full({2,2}, 2.0f, true);
     auto c = a * b;
     auto e = c + d;
+    c.retain_grad();
     e.backward();
 //    REQUIRE(to_scalar(e.grad()) == Approx(1.0f));
     REQUIRE(to_scalar(c.grad()) == Approx(1.0f));
@@ -100,7 +127,7 @@ TEST_CASE("Test9: backward called twice warning (debug)", "[autograd]") {
     auto a = cppgrad::Tensor::full({}, 2.0f, true);
     auto b = cppgrad::Tensor::full({}, 2.0f, true);
     auto c = a * b;
-    c.backward();
+    c.backward(af::array(), /*retain_graph=*/true);
     REQUIRE_NOTHROW(c.backward());
 }
 
@@ -134,6 +161,7 @@ TEST_CASE("Test14 & 15: clone without and with autograd", "[tensor][autograd]")
     REQUIRE_THROWS(b.backward());
 
     auto b2 = cppgrad::TensorUtils::clone_with_grad(a);
+    b2.retain_grad();
     auto c = b2 * 2.0f;
     c.backward();
     REQUIRE(to_vector(a.grad()) == to_vector(b2.grad()));
@@ -156,3 +184,881 @@ TEST_CASE("Test14 & 15: clone without and with autograd", "[tensor][autograd]")
 //     for (auto v : to_vector(a.grad())) REQUIRE(std::isfinite(v));
 //     for (auto v : to_vector(b.grad())) REQUIRE(std::isfinite(v));
 // }
+
+TEST_CASE("Test16: diamond graph applies shared node once", "[autograd][engine]") {
+    auto x = cppgrad::Tensor::full({2}, 3.0f, true);
+    auto y = x * x;          // shared by both branches below
+    auto z = y + y * y;      // dz/dy = 1 + 2y, dy/dx = 2x
+    z.backward();
+    for (auto v : to_vector(x.grad())) REQUIRE(v == Approx((1.0f + 2.0f * 9.0f) * 6.0f));
+}
+
+TEST_CASE("Test17: deep chain backward does not recurse", "[autograd][engine]") {
+    auto x = cppgrad::Tensor::full({}, 1.0f, true);
+    auto y = x;
+    for (int i = 0; i < 5000; ++i) y = -y;
+    y.backward();
+    REQUIRE(to_scalar(x.grad()) == Approx(1.0f));
+}
+
+TEST_CASE("Test18: backward with explicit grad_output", "[autograd][engine]") {
+    auto a = cppgrad::Tensor::full({2}, 2.0f, true);
+    auto b = a * 3.0f;
+    b.backward(af::constant(2.0f, 2));
+    REQUIRE(to_vector(a.grad()) == std::vector<float>{6.0f, 6.0f});
+}
+
+TEST_CASE("Test19: gradients are stored on leaves only unless retained", "[autograd]") {
+    auto a = cppgrad::Tensor::full({2}, 3.0f, true);
+    auto b = a * a;
+    auto c = b * 2.0f;
+    REQUIRE(a.is_leaf());
+    REQUIRE(!b.is_leaf());
+    REQUIRE(!a.impl()->has_grad());   // allocated lazily
+
+    c.backward();
+    REQUIRE(a.impl()->has_grad());
+    REQUIRE(!b.impl()->has_grad());
+    REQUIRE(to_vector(a.grad()) == std::vector<float>{12.0f, 12.0f});
+
+    a.zero_grad();
+    REQUIRE(!a.impl()->has_grad());
+    REQUIRE(to_vector(a.grad()) == std::vector<float>{0.0f, 0.0f});
+}
+
+TEST_CASE("Test20: NoGradGuard skips graph construction", "[autograd][gradmode]") {
+    auto w = cppgrad::Tensor::full({2}, 3.0f, true);
+    {
+        cppgrad::NoGradGuard no_grad;
+        auto y = exp(w * w + 1.0f).sum();
+        REQUIRE(!y.requires_grad());
+        REQUIRE(!y.impl()->has_autograd());
+        REQUIRE_THROWS(y.backward());
+
+        // leaves may still be created as trainable inside the guard
+        auto p = cppgrad::Tensor::zeros({2}, true);
+        REQUIRE(p.requires_grad());
+    }
+    REQUIRE(cppgrad::GradMode::is_enabled());
+    auto z = w * w;
+    REQUIRE(z.requires_grad());
+}
+
+TEST_CASE("Test21: InferenceMode produces plain tensors", "[autograd][gradmode]") {
+    auto w = cppgrad::Tensor::full({2}, 3.0f, true);
+    {
+        cppgrad::InferenceMode guard;
+        auto p = cppgrad::Tensor::zeros({2}, true);
+        REQUIRE(!p.impl()->has_autograd());
+        auto y = w * p;
+        REQUIRE(!y.impl()->has_autograd());
+        {
+            cppgrad::NoGradGuard nested;
+        }
+        REQUIRE(!cppgrad::GradMode::is_enabled());
+    }
+    REQUIRE(cppgrad::GradMode::is_enabled());
+    REQUIRE(!cppgrad::GradMode::is_inference_mode());
+}
+
+TEST_CASE("Test22: backward frees the graph unless retained", "[autograd][engine]") {
+    auto a = cppgrad::Tensor::full({2}, 2.0f, true);
+    std::weak_ptr<cppgrad::TensorImpl> mid;
+    cppgrad::Tensor out = [&] {
+        auto b = a * a;
+        mid = b.impl();
+        return b * 3.0f;
+    }();
+
+    REQUIRE(!mid.expired());
+    out.backward();
+    REQUIRE(mid.expired());
+    REQUIRE(to_vector(a.grad()) == std::vector<float>{12.0f, 12.0f});
+    REQUIRE_THROWS(out.backward());
+}
+
+TEST_CASE("Test23: parallel backward matches serial", "[autograd][engine]") {
+    auto run = [] {
+        auto x = cppgrad::Tensor::full({3}, 0.5f, true);
+        auto w = cppgrad::Tensor::full({3}, 2.0f, true);
+        auto total = x * w;
+        for (int i = 0; i < 16; ++i) {
+            auto branch = exp(x * static_cast<float>(i + 1)) * w;
+            total = total + branch;
+        }
+        total.sum().backward();
+        return std::make_pair(to_vector(x.grad()), to_vector(w.grad()));
+    };
+
+    auto serial = run();
+
+    cppgrad::Engine::set_num_threads(4);
+    auto parallel = run();
+    cppgrad::Engine::set_deterministic(true);
+    auto forced_serial = run();
+    cppgrad::Engine::set_deterministic(false);
+    cppgrad::Engine::set_num_threads(1);
+
+    for (size_t i = 0; i < serial.first.size(); ++i) {
+        REQUIRE(parallel.first[i] == Approx(serial.first[i]));
+        REQUIRE(parallel.second[i] == Approx(serial.second[i]));
+    }
+    REQUIRE(forced_serial == serial);
+}
+
+TEST_CASE("Test24: saved forward outputs drive exp, pow, div and max backward", "[autograd]") {
+    auto a = cppgrad::Tensor::full({2}, 2.0f, true);
+    auto b = cppgrad::Tensor::full({2}, 4.0f, true);
+
+    auto e = exp(a);
+    e.backward();
+    for (auto v : to_vector(a.grad())) REQUIRE(v == Approx(std::exp(2.0f)));
+    a.zero_grad();
+
+    auto q = a / b;
+    q.backward();
+    for (auto v : to_vector(a.grad())) REQUIRE(v == Approx(0.25f));
+    for (auto v : to_vector(b.grad())) REQUIRE(v == Approx(-2.0f / 16.0f));
+    a.zero_grad();
+    b.zero_grad();
+
+    auto p = pow(a, b);
+    p.backward();
+    for (auto v : to_vector(a.grad())) REQUIRE(v == Approx(4.0f * 8.0f));
+    for (auto v : to_vector(b.grad())) REQUIRE(v == Approx(16.0f * std::log(2.0f)));
+
+    auto m = cppgrad::Tensor({2, 2}, {1, 7, 3, 4}, true);
+    auto mx = m.max(1);
+    mx.backward();
+    REQUIRE(to_vector(m.grad()) == std::vector<float>{0, 0, 1, 1});  // column-major host order
+}
+
+TEST_CASE("Test25: scalar operators record a single-input node", "[autograd]") {
+    auto x = cppgrad::Tensor::full({2}, 2.0f, true);
+
+    auto y = x * 0.5f + 1.0f;
+    REQUIRE(y.impl()->grad_fn()->name() == "AddScalar");
+    REQUIRE(y.impl()->grad_fn()->inputs.size() == 1);
+    y.backward();
+    REQUIRE(to_vector(x.grad()) == std::vector<float>{0.5f, 0.5f});
+    x.zero_grad();
+
+    auto z = (3.0f - x) + (8.0f / x) + (x / 4.0f) + (x - 1.0f);
+    z.backward();   // -1 - 8/x² + 1/4 + 1
+    for (auto v : to_vector(x.grad())) REQUIRE(v == Approx(-1.0f - 2.0f + 0.25f + 1.0f));
+    x.zero_grad();
+
+    auto p = pow(x, 3.0f) + pow(2.0f, x);
+    p.backward();   // 3x² + 2^x ln 2
+    for (auto v : to_vector(x.grad())) REQUIRE(v == Approx(12.0f + 4.0f * std::log(2.0f)));
+}
+
+TEST_CASE("Test26: broadcast gradients are reduced to input shapes", "[autograd]") {
+    auto x = cppgrad::Tensor::full({2,3}, 2.0f, true);
+    auto bias = cppgrad::Tensor::full({3}, 1.0f, true);
+    auto col = cppgrad::Tensor::full({2,1}, 3.0f, true);
+
+    auto y = (x * col + bias).sum();
+    y.backward();
+    REQUIRE(to_vector(bias.grad()) == std::vector<float>{2.0f, 2.0f, 2.0f});
+    REQUIRE(to_vector(col.grad()) == std::vector<float>{6.0f, 6.0f});
+    REQUIRE(to_vector(x.grad()) == std::vector<float>(6, 3.0f));
+
+    auto a = cppgrad::Tensor::full({2,3}, 6.0f, true);
+    auto b = cppgrad::Tensor::full({3}, 2.0f, true);
+    auto z = (a / b).sum();
+    z.backward();   // ∂/∂b = Σ_rows -a / b²
+    REQUIRE(b.grad().elements() == 3);
+    for (auto v : to_vector(b.grad())) REQUIRE(v == Approx(-3.0f));
+    for (auto v : to_vector(a.grad())) REQUIRE(v == Approx(0.5f));
+}
+
+TEST_CASE("Test27: view gradients map back to the base tensor", "[autograd][view]") {
+    auto x = cppgrad::Tensor({2,3}, {1,2,3,4,5,6}, true);
+
+    // slice gets 2 on columns 1-2; transpose+reshape adds 1 everywhere
+    auto y = (x.slice(1, 1, 3) * 2.0f).sum() + x.transpose().reshape({6}).sum();
+    y.backward();
+    REQUIRE(to_vector(x.grad()) == std::vector<float>{1,1,3,3,3,3});
+    x.zero_grad();
+
+    // sum(xᵀx) = Σ_k (row sum k)², so ∂/∂x[k][i] = 2 · rowsum_k
+    auto z = cppgrad::TensorUtils::matmul(x.transpose(), x).sum();
+    REQUIRE(to_scalar(z.data()) == Approx(6.0f * 6.0f + 15.0f * 15.0f));
+    z.backward();
+    REQUIRE(to_vector(x.grad()) == std::vector<float>{12,30,12,30,12,30});
+}
+
+TEST_CASE("Test28: gradients through rank-5 broadcast, reduction and slice", "[autograd][rank]") {
+    auto x = cppgrad::Tensor::full({2,3,2,2,2}, 1.0f, true);
+    auto b = cppgrad::Tensor::full({2,1}, 2.0f, true);
+
+    auto y = (x * b).sum(3).sum();
+    y.backward();
+    REQUIRE(x.grad().elements() == 48);
+    for (auto v : to_vector(x.grad())) REQUIRE(v == Approx(2.0f));
+    REQUIRE(to_vector(b.grad()) == std::vector<float>{24.0f, 24.0f});
+    x.zero_grad();
+
+    // The last axis is the slowest in storage: its first half gets the gradient
+    auto z = x.slice(4, 0, 1).sum();
+    z.backward();
+    std::vector<float> expected(48, 0.0f);
+    std::fill(expected.begin(), expected.begin() + 24, 1.0f);
+    REQUIRE(to_vector(x.grad()) == expected);
+}
+
+
+TEST_CASE("Test29: in-place ops bump versions and invalidate saved inputs", "[autograd][inplace]") {
+    auto w = cppgrad::Tensor({2}, {1, 2}, true);
+    auto x = cppgrad::Tensor({2}, {3, 4}, false);
+
+    // Mul reads x in backward to produce w's gradient
+    auto y = (w * x).sum();
+    x.mul_(2.0f);
+    REQUIRE(x.version() == 1);
+    REQUIRE_THROWS_AS(y.backward(), std::runtime_error);
+
+    // Add never reads its inputs, so modifying them is harmless
+    auto z = (w + x).sum();
+    x.zero_();
+    z.backward();
+    REQUIRE(to_vector(w.grad()) == std::vector<float>{1, 1});
+
+    // Parameters can only be updated outside graph recording
+    REQUIRE_THROWS_AS(w.sub_(1.0f), std::runtime_error);
+    {
+        cppgrad::NoGradGuard no_grad;
+        w.sub_(cppgrad::Tensor({2}, {0.5f, 0.5f}, false));
+    }
+    REQUIRE(to_vector(w.data()) == std::vector<float>{0.5f, 1.5f});
+}
+
+TEST_CASE("Test30: fused activations match their composed gradients", "[autograd][activation]") {
+    const std::vector<float> xs = {-2.0f, -0.5f, 0.25f, 1.5f};
+    auto x = cppgrad::Tensor({4}, xs, true);
+
+    // One node per activation
+    auto s = sigmoid(x);
+    REQUIRE(s.impl()->grad_fn()->name() == "Sigmoid");
+
+    auto check = [&](const cppgrad::Tensor& fused, const cppgrad::Tensor& composed) {
+        fused.sum().backward();
+        auto g_fused = to_vector(x.grad());
+        x.zero_grad();
+        composed.sum().backward();
+        auto g_composed = to_vector(x.grad());
+        x.zero_grad();
+        for (size_t i = 0; i < xs.size(); ++i) REQUIRE(g_fused[i] == Approx(g_composed[i]).margin(1e-5));
+    };
+
+    auto composed_sigmoid = [&] { return 1.0f / (1.0f + exp(-x)); };
+    check(sigmoid(x), composed_sigmoid());
+    check(tanh(x), 2.0f * (1.0f / (1.0f + exp(-2.0f * x))) - 1.0f);
+    check(silu(x), x * composed_sigmoid());
+
+    relu(x).sum().backward();
+    REQUIRE(to_vector(x.grad()) == std::vector<float>{0, 0, 1, 1});
+    x.zero_grad();
+
+    // d/dx gelu(x) = Φ(x) + x·φ(x)
+    gelu(x).sum().backward();
+    auto g = to_vector(x.grad());
+    for (size_t i = 0; i < xs.size(); ++i) {
+        const float cdf = 0.5f * (1.0f + std::erf(xs[i] / std::sqrt(2.0f)));
+        const float pdf = std::exp(-0.5f * xs[i] * xs[i]) / std::sqrt(2.0f * 3.14159265f);
+        REQUIRE(g[i] == Approx(cdf + xs[i] * pdf).margin(1e-5));
+    }
+}
+
+TEST_CASE("Test31: softmax family gradients are closed-form", "[autograd][softmax]") {
+    auto x = cppgrad::Tensor({2, 3}, {1, 2, 3, -1, 0, 4}, true);
+
+    // cross_entropy: (softmax - onehot) / N
+    auto loss = cross_entropy(x, {0, 2});
+    REQUIRE(loss.impl()->grad_fn()->name() == "CrossEntropy");
+    loss.backward();
+    auto p = to_vector(softmax(x, 1).data());
+    auto g = to_vector(x.grad());
+    const std::vector<float> onehot = {1, 0, 0, 0, 0, 1};   // column-major (2, 3)
+    for (size_t i = 0; i < g.size(); ++i) REQUIRE(g[i] == Approx((p[i] - onehot[i]) / 2.0f));
+    x.zero_grad();
+
+    // log_softmax picked at the labels gives the same gradient (times N)
+    auto w = cppgrad::Tensor({2, 3}, {-1, 0, 0, 0, 0, -1}, false);   // -onehot, row-major
+    (log_softmax(x, 1) * w).sum().backward();
+    auto g2 = to_vector(x.grad());
+    for (size_t i = 0; i < g2.size(); ++i) REQUIRE(g2[i] == Approx(2.0f * g[i]));
+    x.zero_grad();
+
+    // ∂ logsumexp / ∂x = softmax; softmax weighted by a constant matches the composed graph
+    logsumexp(x, 1).sum().backward();
+    auto g3 = to_vector(x.grad());
+    for (size_t i = 0; i < g3.size(); ++i) REQUIRE(g3[i] == Approx(p[i]));
+    x.zero_grad();
+
+    auto c = cppgrad::Tensor({2, 3}, {1, 2, 3, 4, 5, 6}, false);
+    (softmax(x, 1) * c).sum().backward();
+    auto fused = to_vector(x.grad());
+    x.zero_grad();
+    auto e = exp(x);
+    (e / e.sum(1, true) * c).sum().backward();
+    auto composed = to_vector(x.grad());
+    for (size_t i = 0; i < fused.size(); ++i) REQUIRE(fused[i] == Approx(composed[i]).margin(1e-5));
+}
+
+TEST_CASE("Test32: batched matmul and linear gradients", "[autograd][matmul]") {
+    using cppgrad::TensorUtils;
+    auto x = cppgrad::Tensor({2, 2, 3}, {1, 2, 3, 4, 5, 6, -1, 0, 1, 2, -2, 0.5f}, true);
+    auto y = cppgrad::Tensor({2, 3, 2}, {1, -1, 2, 0, 0, 3, 0.5f, 1, -2, 1, 1, 1}, true);
+
+    TensorUtils::matmul(x, y).sum().backward();
+    auto gx = to_vector(x.grad());
+    auto gy = to_vector(y.grad());
+    x.zero_grad();
+    y.zero_grad();
+
+    // Same product, one 2D matmul per batch entry
+    auto per_batch = [&](long i) {
+        auto xi = x.slice(0, i, i + 1).reshape({2, 3});
+        auto yi = y.slice(0, i, i + 1).reshape({3, 2});
+        return TensorUtils::matmul(xi, yi).sum();
+    };
+    (per_batch(0) + per_batch(1)).backward();
+    REQUIRE(to_vector(x.grad()) == gx);
+    REQUIRE(to_vector(y.grad()) == gy);
+    x.zero_grad();
+
+    // linear + relu in one node vs the composed graph
+    auto in = cppgrad::Tensor({3, 2}, {1, -2, 0.5f, 3, -1, 1}, true);
+    auto W = cppgrad::Tensor({4, 2}, {1, 0, -1, 1, 0.5f, 0.5f, 2, -1}, true);
+    auto b = cppgrad::Tensor({4}, {0.1f, -0.2f, 0.3f, 0}, true);
+
+    auto fused = linear(in, W, b, cppgrad::Activation::Relu);
+    REQUIRE(fused.impl()->grad_fn()->name() == "Linear");
+    fused.sum().backward();
+    auto g_in = to_vector(in.grad()), g_W = to_vector(W.grad()), g_b = to_vector(b.grad());
+    in.zero_grad(); W.zero_grad(); b.zero_grad();
+
+    relu(TensorUtils::matmul(in, W.transpose()) + b).sum().backward();
+    REQUIRE(to_vector(in.grad()) == g_in);
+    REQUIRE(to_vector(W.grad()) == g_W);
+    REQUIRE(to_vector(b.grad()) == g_b);
+}
+
+TEST_CASE("Test33: conv2d and pooling gradients", "[autograd][conv]") {
+    using cppgrad::ConvAlgorithm;
+    auto x = cppgrad::Tensor::randn({2, 4, 6, 6}, true);
+    auto w = cppgrad::Tensor::randn({6, 2, 3, 3}, true);
+    auto b = cppgrad::Tensor::randn({6}, true);
+
+    // The im2col and direct backward passes agree on every input, with groups
+    cppgrad::Conv2dOptions opts{ .stride = 2, .padding = 1, .groups = 2 };
+    std::vector<std::vector<float>> grads[2];
+    int run = 0;
+    for (auto algorithm : {ConvAlgorithm::Im2col, ConvAlgorithm::Direct}) {
+        opts.algorithm = algorithm;
+        auto y = conv2d(x, w, b, opts);
+        REQUIRE(y.impl()->grad_fn()->name() == "Conv2d");
+        (y * y).sum().backward();
+        grads[run++] = { to_vector(x.grad()), to_vector(w.grad()), to_vector(b.grad()) };
+        x.zero_grad(); w.zero_grad(); b.zero_grad();
+    }
+    for (size_t t = 0; t < 3; ++t) {
+        REQUIRE(grads[0][t].size() == grads[1][t].size());
+        for (size_t i = 0; i < grads[0][t].size(); ++i)
+            REQUIRE(grads[0][t][i] == Approx(grads[1][t][i]).margin(1e-3));
+    }
+
+    // ∂Σy/∂b counts the output positions of each filter
+    conv2d(x, w, b, opts).sum().backward();
+    for (float g : to_vector(b.grad())) REQUIRE(g == Approx(2 * 3 * 3));
+
+    // Max pooling routes the gradient to each window's argmax only
+    auto img = cppgrad::Tensor({1, 1, 2, 4}, {1, 5, 2, 0, 3, 4, 8, 7}, true);
+    cppgrad::max_pool2d(img, 2).sum().backward();
+    REQUIRE(to_vector(img.grad()) == to_vector(cppgrad::Tensor({1, 1, 2, 4}, {0, 1, 0, 0, 0, 0, 1, 0}).data()));
+    img.zero_grad();
+
+    // Average pooling spreads it evenly
+    cppgrad::avg_pool2d(img, 2).sum().backward();
+    for (float g : to_vector(img.grad())) REQUIRE(g == Approx(0.25f));
+}
+
+TEST_CASE("Test34: reductions reuse saved indices and cover several axes", "[autograd][reduction]") {
+    // Ties: only the first maximum receives the gradient
+    auto x = cppgrad::Tensor({3}, {2, 2, 1}, true);
+    x.max().backward();
+    REQUIRE(to_vector(x.grad()) == std::vector<float>{1, 0, 0});
+    x.zero_grad();
+    x.min().backward();
+    REQUIRE(to_vector(x.grad()) == std::vector<float>{0, 0, 1});
+
+    // prod is exact around a zero
+    auto p = cppgrad::Tensor({3}, {2, 0, 3}, true);
+    p.prod().backward();
+    REQUIRE(to_vector(p.grad()) == std::vector<float>{0, 6, 0});
+
+    // var / std match their composed definitions
+    auto r = cppgrad::Tensor::randn({3, 4}, true);
+    r.var(1).sum().backward();
+    auto g_var = to_vector(r.grad());
+    r.zero_grad();
+    (pow(r - r.mean(1, true), 2.0f).sum(1) / 3.0f).sum().backward();
+    auto g_ref = to_vector(r.grad());
+    r.zero_grad();
+    for (size_t i = 0; i < g_var.size(); ++i) REQUIRE(g_var[i] == Approx(g_ref[i]).margin(1e-5));
+
+    r.std(0, false).sum().backward();
+    auto g_std = to_vector(r.grad());
+    r.zero_grad();
+    pow(r.var(0, false), 0.5f).sum().backward();
+    g_ref = to_vector(r.grad());
+    r.zero_grad();
+    for (size_t i = 0; i < g_std.size(); ++i) REQUIRE(g_std[i] == Approx(g_ref[i]).margin(1e-5));
+
+    // Non-adjacent axes (reordered internally) vs one axis at a time
+    auto m = cppgrad::Tensor::randn({2, 3, 2}, true);
+    auto w = cppgrad::Tensor({3}, {1, 2, 3});
+    (m.max({0, 2}) * w).sum().backward();
+    auto g_multi = to_vector(m.grad());
+    m.zero_grad();
+    (m.max(2).max(0) * w).sum().backward();
+    REQUIRE(to_vector(m.grad()) == g_multi);
+    m.zero_grad();
+
+    (m.sum({0, 2}) * w).sum().backward();
+    g_multi = to_vector(m.grad());
+    m.zero_grad();
+    (m.sum(2).sum(0) * w).sum().backward();
+    REQUIRE(to_vector(m.grad()) == g_multi);
+}
+
+TEST_CASE("Test35: fused layer_norm and batch_norm match the composed graphs", "[autograd][norm]") {
+    const float eps = 1e-5f;
+    auto require_close = [](const std::vector<float>& a, const std::vector<float>& b) {
+        REQUIRE(a.size() == b.size());
+        for (size_t i = 0; i < a.size(); ++i) REQUIRE(a[i] == Approx(b[i]).margin(1e-4));
+    };
+
+    auto x = cppgrad::Tensor::randn({4, 2, 3}, true);
+    auto w = cppgrad::Tensor::randn({2, 3}, true);
+    auto b = cppgrad::Tensor::randn({2, 3}, true);
+    auto c = cppgrad::Tensor::randn({4, 2, 3});
+
+    auto fused = layer_norm(x, {2, 3}, w, b, eps);
+    REQUIRE(fused.impl()->grad_fn()->name() == "LayerNorm");
+    (fused * c).sum().backward();
+    auto gx = to_vector(x.grad()), gw = to_vector(w.grad()), gb = to_vector(b.grad());
+    x.zero_grad(); w.zero_grad(); b.zero_grad();
+
+    auto centered = x - x.mean({1, 2}, true);
+    auto composed = centered * pow(x.var({1, 2}, false, true) + eps, -0.5f) * w + b;
+    (composed * c).sum().backward();
+    require_close(gx, to_vector(x.grad()));
+    require_close(gw, to_vector(w.grad()));
+    require_close(gb, to_vector(b.grad()));
+
+    // Batch norm over (N, H, W) per channel, training mode
+    auto img = cppgrad::Tensor::randn({3, 2, 4, 4}, true);
+    auto gamma = cppgrad::Tensor::randn({2}, true);
+    auto beta = cppgrad::Tensor::randn({2}, true);
+    auto mask = cppgrad::Tensor::randn({3, 2, 4, 4});
+    auto running_mean = cppgrad::Tensor::zeros({2});
+    auto running_var = cppgrad::Tensor::ones({2});
+
+    auto bn = batch_norm(img, running_mean, running_var, gamma, beta, { .eps = eps });
+    REQUIRE(bn.impl()->grad_fn()->name() == "BatchNorm");
+    (bn * mask).sum().backward();
+    auto g_img = to_vector(img.grad()), g_gamma = to_vector(gamma.grad()), g_beta = to_vector(beta.grad());
+    img.zero_grad(); gamma.zero_grad(); beta.zero_grad();
+
+    auto normalized = (img - img.mean({0, 2, 3}, true)) * pow(img.var({0, 2, 3}, false, true) + eps, -0.5f);
+    ((normalized * gamma.reshape({1, 2, 1, 1}) + beta.reshape({1, 2, 1, 1})) * mask).sum().backward();
+    require_close(g_img, to_vector(img.grad()));
+    require_close(g_gamma, to_vector(gamma.grad()));
+    require_close(g_beta, to_vector(beta.grad()));
+    img.zero_grad();
+
+    // Eval mode: the running statistics are constants
+    batch_norm(img, running_mean, running_var, { .training = false, .eps = eps }).sum().backward();
+    auto rv = to_vector(running_var.data());
+    auto g_eval = to_vector(img.grad());
+    REQUIRE(g_eval[0] == Approx(1.0f / std::sqrt(rv[0] + eps)));
+}
+
+TEST_CASE("Test36: optimizers update flat parameter buffers", "[autograd][optim]") {
+    auto w = cppgrad::Tensor({2}, {1, -2}, true);
+    auto b = cppgrad::Tensor({1}, {0.5f}, true);
+
+    // SGD with momentum: buf = g on the first step, then m * buf + g
+    cppgrad::optim::SGD sgd({ w, b }, { .lr = 0.1f, .momentum = 0.9f });
+    REQUIRE(sgd.numel() == 3);
+    (w * w).sum().backward();                 // g_w = 2w = {2, -4}, b has no grad
+    sgd.step();
+    REQUIRE(to_vector(w.data()) == std::vector<float>{1 - 0.2f, -2 + 0.4f});
+    REQUIRE(to_vector(b.data()) == std::vector<float>{0.5f});
+    REQUIRE(w.version() == 1);
+
+    sgd.zero_grad();
+    REQUIRE(to_vector(w.grad()) == std::vector<float>{0, 0});
+    (w * w).sum().backward();                 // g_w = {1.6, -3.2}
+    sgd.step();
+    auto v = to_vector(w.data());
+    REQUIRE(v[0] == Approx(0.8f - 0.1f * (0.9f * 2 + 1.6f)));
+    REQUIRE(v[1] == Approx(-1.6f - 0.1f * (0.9f * -4 - 3.2f)));
+
+    // Writes outside the optimizer are picked up before the next step
+    {
+        cppgrad::NoGradGuard no_grad;
+        w.fill_(1.0f);
+    }
+    sgd.zero_grad();
+    sgd.step();                               // no gradient: momentum does not move w
+    REQUIRE(to_vector(w.data()) == std::vector<float>{1, 1});
+
+    // b's first gradient seeds its own momentum slice
+    (b * 2.0f).sum().backward();              // g_b = 2
+    sgd.step();
+    REQUIRE(to_vector(b.data())[0] == Approx(0.5f - 0.1f * 2));
+    REQUIRE(to_vector(w.data()) == std::vector<float>{1, 1});
+
+    // Adam's first step moves every coordinate by lr against the gradient sign
+    auto x = cppgrad::Tensor({3}, {1, -1, 3}, true);
+    cppgrad::optim::Adam adam({ x }, { .lr = 0.01f });
+    (x * x).sum().backward();
+    adam.step();
+    v = to_vector(x.data());
+    REQUIRE(v[0] == Approx(0.99f));
+    REQUIRE(v[1] == Approx(-0.99f));
+    REQUIRE(v[2] == Approx(2.99f));
+
+    // AdamW decays the parameters directly, but leaves unused ones untouched
+    auto y = cppgrad::Tensor({2}, {2, -2}, true);
+    auto unused = cppgrad::Tensor({2}, {2, -2}, true);
+    cppgrad::optim::AdamW adamw({ y, unused }, { .lr = 0.1f, .weight_decay = 0.5f });
+    (y * y).sum().backward();
+    adamw.step();
+    v = to_vector(y.data());
+    REQUIRE(v[0] == Approx(2 * 0.95f - 0.1f));
+    REQUIRE(v[1] == Approx(-2 * 0.95f + 0.1f));
+    REQUIRE(to_vector(unused.data()) == std::vector<float>{2, -2});
+    REQUIRE(unused.version() == 0);
+
+    // Its first update is bias-corrected as a first step, too
+    adamw.zero_grad();
+    (unused * unused).sum().backward();
+    adamw.step();
+    v = to_vector(unused.data());
+    REQUIRE(v[0] == Approx(2 * 0.95f - 0.1f));
+    REQUIRE(v[1] == Approx(-2 * 0.95f + 0.1f));
+
+    // Minimizing (z - 3)^2 converges
+    auto z = cppgrad::Tensor({1}, {0}, true);
+    cppgrad::optim::SGD opt({ z }, { .lr = 0.1f });
+    for (int i = 0; i < 100; ++i) {
+        opt.zero_grad();
+        pow(z - 3.0f, 2.0f).sum().backward();
+        opt.step();
+    }
+    REQUIRE(to_vector(z.data())[0] == Approx(3.0f).margin(1e-4));
+
+    REQUIRE_THROWS(cppgrad::optim::SGD({ cppgrad::Tensor::ones({2}) }));
+    REQUIRE_THROWS(cppgrad::optim::SGD({ w, w }));
+}
+
+TEST_CASE("Test37: nn modules register parameters and train end to end", "[autograd][nn]") {
+    namespace nn = cppgrad::nn;
+
+    // Embedding: repeated indices accumulate into the same row
+    auto table = cppgrad::Tensor::from_array_column_major({3, 2}, {1, 2, 3, 10, 20, 30}, true);
+    auto idx = cppgrad::Tensor({2, 2}, {2, 0, 2, 2});
+    auto e = embedding(idx, table);
+    REQUIRE(e.shape() == cppgrad::Shape{2, 2, 2});
+    e.sum().backward();
+    REQUIRE(to_vector(table.grad()) == std::vector<float>{1, 0, 3, 1, 0, 3});
+    REQUIRE_THROWS(embedding(cppgrad::Tensor::full({1}, 3.0f), table));
+
+    // Dropout: identity in eval mode, kept elements scaled by 1 / (1 - p) in training
+    auto x = cppgrad::Tensor::ones({1000}, true);
+    REQUIRE(dropout(x, 0.5f, false).impl() == x.impl());
+    auto d = dropout(x, 0.25f);
+    d.sum().backward();
+    auto dv = to_vector(d.data());
+    auto gv = to_vector(x.grad());
+    for (size_t i = 0; i < dv.size(); ++i) {
+        REQUIRE((dv[i] == 0.0f || dv[i] == Approx(4.0f / 3.0f)));
+        REQUIRE(gv[i] == dv[i]);
+    }
+
+    // Registry: dotted names, depth-first, shared children counted once
+    auto hidden = std::make_shared<nn::Linear>(4, 8, cppgrad::Activation::Tanh);
+    nn::Sequential model({
+        hidden,
+        std::make_shared<nn::Dropout>(0.1f),
+        std::make_shared<nn::Linear>(8, 1, /*bias=*/false),
+    });
+    auto named = model.named_parameters();
+    REQUIRE(named.size() == 3);
+    REQUIRE(named[0].first == "0.weight");
+    REQUIRE(named[1].first == "0.bias");
+    REQUIRE(named[2].first == "2.weight");
+    REQUIRE(named[0].second.impl() == hidden->weight().impl());
+    REQUIRE(nn::Sequential({ hidden, hidden }).parameters().size() == 2);
+
+    // eval() reaches every child and disables graph recording
+    model.eval();
+    REQUIRE_FALSE(model[1].is_training());
+    auto input = cppgrad::Tensor::randn({16, 4});
+    REQUIRE_FALSE(model(input).requires_grad());
+    model.train();
+    REQUIRE(model(input).requires_grad());
+
+    // A small MLP fits y = x0 - x1 with Adam
+    nn::Sequential mlp({
+        std::make_shared<nn::Linear>(2, 16),
+        std::make_shared<nn::ReLU>(),
+        std::make_shared<nn::Linear>(16, 1),
+    });
+    auto data = cppgrad::Tensor::randn({64, 2});
+    auto target = (data.slice(1, 0, 1) - data.slice(1, 1, 2));
+    cppgrad::optim::Adam opt(mlp.parameters(), { .lr = 0.01f });
+    float first = 0, last = 0;
+    for (int i = 0; i < 200; ++i) {
+        opt.zero_grad();
+        auto loss = pow(mlp(data) - target, 2.0f).mean();
+        loss.backward();
+        opt.step();
+        (i == 0 ? first : last) = to_scalar(loss.data());
+    }
+    REQUIRE(last < 0.1f * first);
+}
+
+TEST_CASE("Test38: checkpointed segments recompute and match the recorded graph", "[autograd][checkpoint]") {
+    auto w = cppgrad::Tensor({2, 2}, {0.5f, -1, 2, 0.25f}, true);
+    auto b = cppgrad::Tensor({2}, {0.1f, -0.2f}, true);
+    auto block = [&](const cppgrad::Tensor& h) { return tanh(linear(h, w, b)); };
+
+    // Reference: every node recorded
+    auto x = cppgrad::Tensor({3, 2}, {1, 2, -1, 0.5f, 3, -2}, true);
+    block(block(x)).sum().backward();
+    auto x_ref = to_vector(x.grad());
+    auto w_ref = to_vector(w.grad());
+    auto b_ref = to_vector(b.grad());
+
+    // Checkpointed: one node per block, parameters reached by the inner backward
+    x.zero_grad();
+    w.zero_grad();
+    b.zero_grad();
+    auto h = cppgrad::checkpoint(block, x);
+    REQUIRE(h.impl()->grad_fn()->name() == "Checkpoint");
+    REQUIRE(h.impl()->grad_fn()->inputs.size() == 1);
+    cppgrad::checkpoint(block, h).sum().backward();
+
+    auto xv = to_vector(x.grad());
+    auto wv = to_vector(w.grad());
+    auto bv = to_vector(b.grad());
+    for (size_t i = 0; i < xv.size(); ++i) REQUIRE(xv[i] == Approx(x_ref[i]));
+    for (size_t i = 0; i < wv.size(); ++i) REQUIRE(wv[i] == Approx(w_ref[i]));
+    for (size_t i = 0; i < bv.size(); ++i) REQUIRE(bv[i] == Approx(b_ref[i]));
+
+    // Dropout replays the forward mask: d(out)/d(in) = mask * 2 = out for in = 1
+    auto ones = cppgrad::Tensor::ones({256}, true);
+    auto dropped = cppgrad::checkpoint([](const cppgrad::Tensor& in) { return dropout(in, 0.5f); }, ones);
+    dropped.sum().backward();
+    REQUIRE(to_vector(ones.grad()) == to_vector(dropped.data()));
+
+    // Several inputs; an input modified after forward is detected
+    auto p = cppgrad::Tensor({2}, {1, 2}, true);
+    auto q = cppgrad::Tensor({2}, {3, 4});
+    auto pq = cppgrad::checkpoint([](const std::vector<cppgrad::Tensor>& in) { return in[0] * in[1]; }, { p, q });
+    pq.sum().backward(af::array(), /*retain_graph=*/true);
+    REQUIRE(to_vector(p.grad()) == std::vector<float>{3, 4});
+    q.fill_(0.0f);
+    REQUIRE_THROWS(pq.sum().backward());
+
+    // Without grad mode the segment just runs
+    cppgrad::NoGradGuard no_grad;
+    REQUIRE_FALSE(cppgrad::checkpoint(block, x).requires_grad());
+}
+
+TEST_CASE("Test39: captured steps replay the tape and match eager execution", "[autograd][capture]") {
+    auto w = cppgrad::Tensor({2, 3}, {0.5f, -1, 0.25f, 2, 0.1f, -0.3f}, true);
+    auto b = cppgrad::Tensor({2}, {0.1f, -0.2f}, true);
+    auto loss_fn = [&](const std::vector<cppgrad::Tensor>& in) {
+        return pow(linear(in[0], w, b, cppgrad::Activation::Tanh) - in[1], 2.0f).mean();
+    };
+    auto eager = [&](const cppgrad::Tensor& x, const cppgrad::Tensor& y) {
+        w.zero_grad();
+        b.zero_grad();
+        auto loss = loss_fn({ x, y });
+        loss.backward();
+        return std::make_tuple(to_scalar(loss.data()), to_vector(w.grad()), to_vector(b.grad()));
+    };
+    auto check = [&](float loss, const std::tuple<float, std::vector<float>, std::vector<float>>& ref) {
+        REQUIRE(loss == Approx(std::get<0>(ref)));
+        auto wv = to_vector(w.grad());
+        auto bv = to_vector(b.grad());
+        for (size_t i = 0; i < wv.size(); ++i) REQUIRE(wv[i] == Approx(std::get<1>(ref)[i]));
+        for (size_t i = 0; i < bv.size(); ++i) REQUIRE(bv[i] == Approx(std::get<2>(ref)[i]));
+    };
+
+    auto step = cppgrad::capture(loss_fn);
+    auto x1 = cppgrad::Tensor({4, 3}, {1, 2, 3, -1, 0, 1, 0.5f, 0.5f, -2, 3, 1, 0});
+    auto y1 = cppgrad::Tensor({4, 2}, {0, 1, 1, 0, -1, 0.5f, 0.2f, 0.3f});
+    auto x2 = cppgrad::Tensor({4, 3}, {-2, 1, 0, 0.3f, 0.7f, -1, 2, -0.5f, 1, 0, 0, 1});
+    auto y2 = cppgrad::Tensor({4, 2}, {1, 1, 0, 0, 0.5f, -1, -0.3f, 0.1f});
+
+    // First call records (linear, sub, pow, mean) and runs backward
+    auto ref1 = eager(x1, y1);
+    w.zero_grad();
+    b.zero_grad();
+    check(to_scalar(step({ x1, y1 }).data()), ref1);
+    REQUIRE(step.is_replayable());
+    REQUIRE(step.tape_size() == 4);
+
+    // New data replays into the same graph, also after an optimizer update
+    cppgrad::optim::SGD sgd({ w, b }, { .lr = 0.1f });
+    sgd.step();
+    auto ref2 = eager(x2, y2);
+    w.zero_grad();
+    b.zero_grad();
+    check(to_scalar(step({ x2, y2 }).data()), ref2);
+    REQUIRE(step.replays() == 1);
+
+    // A different batch size runs eagerly
+    auto x3 = cppgrad::Tensor::randn({5, 3});
+    auto y3 = cppgrad::Tensor::randn({5, 2});
+    auto ref3 = eager(x3, y3);
+    w.zero_grad();
+    b.zero_grad();
+    check(to_scalar(step({ x3, y3 }).data()), ref3);
+    REQUIRE(step.fallbacks() == 1);
+
+    // Inputs that require grad receive it through the tape's slots
+    auto p = cppgrad::Tensor({3}, {1, 2, 3}, true);
+    auto square = cppgrad::capture([](const std::vector<cppgrad::Tensor>& in) { return (in[0] * in[0]).sum(); });
+    square({ p });
+    square({ p });
+    REQUIRE(square.replays() == 1);
+    REQUIRE(to_vector(p.grad()) == std::vector<float>{4, 8, 12});
+
+    // An input computed upstream passes its gradient on to the upstream
+    // parameters, whether the call records, replays or falls back
+    auto enc = cppgrad::Tensor({3}, {0.5f, -1, 2}, true);
+    auto raw = cppgrad::Tensor({3}, {1, 2, 3});
+    auto scaled = cppgrad::capture([](const std::vector<cppgrad::Tensor>& in) { return (in[0] * in[0]).sum(); });
+    for (int call = 0; call < 2; ++call) {
+        enc.zero_grad();
+        scaled({ raw * enc });                // d/d enc of sum((raw * enc)^2) = 2 raw^2 enc
+        auto g = to_vector(enc.grad());
+        REQUIRE(g[0] == Approx(1.0f));
+        REQUIRE(g[1] == Approx(-8.0f));
+        REQUIRE(g[2] == Approx(36.0f));
+    }
+    REQUIRE(scaled.replays() == 1);
+    enc.zero_grad();
+    scaled({ cppgrad::Tensor({2}, {1, 2}) * enc.sum() });
+    REQUIRE(scaled.fallbacks() == 1);
+    for (float v : to_vector(enc.grad())) REQUIRE(v == Approx(10 * 1.5f));    // loss = 5 sum(enc)^2
+
+    // A tensor no op recorded (here a factory) makes the tape non-replayable
+    auto with_constant = cppgrad::capture([](const std::vector<cppgrad::Tensor>& in) {
+        return (in[0] * cppgrad::Tensor::full({3}, 2.0f)).sum();
+    });
+    auto q = cppgrad::Tensor({3}, {1, 2, 3}, true);
+    REQUIRE(to_scalar(with_constant({ q }).data()) == Approx(12.0f));
+    REQUIRE_FALSE(with_constant.is_replayable());
+    REQUIRE(to_scalar(with_constant({ q }).data()) == Approx(12.0f));
+    REQUIRE(with_constant.fallbacks() == 1);
+}
+
+TEST_CASE("Test40: lazy mode optimizes the recorded graph and matches eager execution", "[autograd][lazy]") {
+    auto x = cppgrad::Tensor({2, 3}, {0.5f, -1, 2, 0.1f, -0.3f, 1.5f}, true);
+    auto w = cppgrad::Tensor({3}, {0.2f, -0.4f, 0.6f}, true);
+    auto loss_fn = [&] {
+        auto h = tanh(x * w + 0.5f);
+        auto s = sigmoid(x * w);    // Same product as above
+        return (h * s * cppgrad::Tensor::full({2, 3}, 2.0f)).mean() + relu(-x).sum();
+    };
+
+    auto eager = loss_fn();
+    eager.backward();
+    auto gx = to_vector(x.grad());
+    auto gw = to_vector(w.grad());
+    x.zero_grad();
+    w.zero_grad();
+
+    // Nothing runs until the loss is read by backward
+    cppgrad::LazyMode::reset_stats();
+    auto [loss, unused] = [&] {
+        cppgrad::LazyMode lazy;
+        return std::make_tuple(loss_fn(), exp(x).sum());
+    }();
+    REQUIRE(loss.impl()->is_lazy());
+    REQUIRE(cppgrad::LazyMode::stats().emitted == 0);
+
+    loss.backward();
+    REQUIRE(to_scalar(loss.data()) == Approx(to_scalar(eager.data())));
+    auto lx = to_vector(x.grad());
+    auto lw = to_vector(w.grad());
+    for (size_t i = 0; i < gx.size(); ++i) REQUIRE(lx[i] == Approx(gx[i]));
+    for (size_t i = 0; i < gw.size(); ++i) REQUIRE(lw[i] == Approx(gw[i]));
+
+    auto stats = cppgrad::LazyMode::stats();
+    REQUIRE(stats.merged >= 1);                 // x * w
+    REQUIRE(stats.folded >= 1);                 // * full(2) became a scalar multiply
+    REQUIRE(stats.materializations == 2);       // Forward, then every gradient at once
+    REQUIRE(unused.impl()->is_lazy());          // Dead code never reached ArrayFire
+
+    // Several results in one batch: the shared exp(x) is evaluated once for
+    // both kernels, the results together
+    auto [a, b] = [&] {
+        cppgrad::NoGradGuard no_grad;
+        cppgrad::LazyMode lazy;
+        return std::make_tuple(exp(x) + 1.0f, (exp(x) * 2.0f).sum());
+    }();
+    cppgrad::LazyMode::reset_stats();
+    cppgrad::materialize({ a, b });
+    REQUIRE(cppgrad::LazyMode::stats().materializations == 1);
+    REQUIRE(cppgrad::LazyMode::stats().evals == 2);
+    auto av = to_vector(a.data());
+    auto xv = to_vector(x.data());
+    float total = 0;
+    for (size_t i = 0; i < xv.size(); ++i) {
+        REQUIRE(av[i] == Approx(std::exp(xv[i]) + 1.0f));
+        total += 2.0f * std::exp(xv[i]);
+    }
+    REQUIRE(to_scalar(b.data()) == Approx(total));
+
+    // A lazy result read by an eager op still backpropagates to the leaves
+    x.zero_grad();
+    auto peak = [&] {
+        cppgrad::LazyMode lazy;
+        return (relu(x) * 3.0f).max();
+    }();
+    peak.backward();
+    REQUIRE(to_scalar(peak.data()) == Approx(6.0f));
+    auto gv = to_vector(x.grad());
+    for (size_t i = 0; i < xv.size(); ++i) REQUIRE(gv[i] == (xv[i] == 2.0f ? 3.0f : 0.0f));
+}
+
+TEST_CASE("Test41: division gives the same bits with and without grad", "[autograd][div]") {
+    // Denormal divisors: a reciprocal would overflow to inf
+    auto a = cppgrad::Tensor({2, 3}, {1e-40f, 3, -7, 1e-39f, 1e-38f, 5}, true);
+    auto b = cppgrad::Tensor({3}, {1e-40f, 0.3f, 7}, true);
+
+    auto with_grad = a / b;
+    cppgrad::Tensor without_grad = [&] {
+        cppgrad::NoGradGuard no_grad;
+        return a / b;
+    }();
+    REQUIRE(with_grad.requires_grad());
+    REQUIRE_FALSE(without_grad.requires_grad());
+
+    auto on = to_vector(with_grad.data());
+    auto off = to_vector(without_grad.data());
+    REQUIRE(on.size() == off.size());
+    REQUIRE(std::memcmp(on.data(), off.data(), on.size() * sizeof(float)) == 0);
+    for (float v : on) REQUIRE(std::isfinite(v));
+}
@@ -1,7 +1,19 @@
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_approx.hpp>
+#include <cmath>
 #include "cppgrad/tensor/tensor.hpp"
+#include "cppgrad/tensor/shape.hpp"
+#include "cppgrad/memory/memorypool.hpp"
+#include "cppgrad/ops/avg_pool2d.hpp"
+#include "cppgrad/ops/batch_norm.hpp"
+#include "cppgrad/ops/conv2d.hpp"
+#include "cppgrad/ops/cross_entropy.hpp"
+#include "cppgrad/ops/layer_norm.hpp"
+#include "cppgrad/ops/linear.hpp"
+#include "cppgrad/ops/logsumexp.hpp"
+#include "cppgrad/ops/max_pool2d.hpp"
+#include "cppgrad/tensor/tensorutils.hpp"
 
 using namespace Catch;
 
@@ -36,6 +48,43 @@ TEST_CASE("Tensor manual construction and from_array_column_major", "[tensor]")
     REQUIRE(to_vector(t2) == values);
 }
 
+TEST_CASE("Host buffer ingestion: from_blob, borrow and row-major views", "[tensor][blob]") {
+    // Row-major {2, 2, 2}: element (i, j, k) holds 4i + 2j + k
+    std::vector<float> row_major = {0, 1, 2, 3, 4, 5, 6, 7};
+    auto r = cppgrad::Tensor::from_blob(std::span<const float>(row_major), {2, 2, 2});
+    REQUIRE(r.shape() == std::vector<size_t>{2, 2, 2});
+    REQUIRE(!r.is_contiguous());
+    REQUIRE(to_vector(r) == std::vector<float>{0, 4, 2, 6, 1, 5, 3, 7});
+
+    cppgrad::Tensor ctor({2, 2, 2}, row_major);
+    REQUIRE(to_vector(ctor) == to_vector(r));
+
+    std::vector<float> values = {1, 2, 3, 4, 5, 6};
+    auto c = cppgrad::Tensor::from_blob(values.data(), {2, 3}, cppgrad::Layout::ColumnMajor);
+    REQUIRE(c.is_contiguous());
+    REQUIRE(to_vector(c) == to_vector(cppgrad::Tensor::from_array_column_major({2, 3}, values)));
+
+    std::vector<float> owned = {1, 2, 3, 4};
+    auto b = cppgrad::Tensor::borrow(owned.data(), {2, 2});
+    REQUIRE(to_vector(b) == owned);
+    if (af::getActiveBackend() == AF_BACKEND_CPU) {
+        owned[0] = 10.0f;
+        REQUIRE(to_vector(b)[0] == Approx(10.0f));
+
+        // A write after an op has read the tensor reaches later ops only
+        auto before = b + 1.0f;
+        REQUIRE(to_vector(before)[3] == Approx(5.0f));
+        owned[3] = 40.0f;
+        REQUIRE(to_vector(b)[3] == Approx(40.0f));
+        REQUIRE(to_vector(b * 2.0f)[3] == Approx(80.0f));
+        REQUIRE(to_vector(before)[3] == Approx(5.0f));
+    }
+    REQUIRE_THROWS(cppgrad::Tensor::borrow(owned.data(), {2, 2}, cppgrad::Layout::RowMajor));
+
+    std::vector<float> too_short = {1, 2, 3};
+    REQUIRE_THROWS(cppgrad::Tensor::from_blob(std::span<const float>(too_short), {2, 2}));
+}
+
 TEST_CASE("Factory initializers: zeros, ones, full, randn", "[tensor]") {
     auto z = cppgrad::Tensor::zeros({3, 2}, true);
     REQUIRE(z.shape() == std::vector<size_t>{3, 2});
@@ -97,6 +146,21 @@ TEST_CASE("Basic arithmetic operations and broadcasting", "[tensor]") {
     auto neg = -a;
     std::vector<float> exp_neg(4, -2.0f);
     REQUIRE(to_vector(neg) == exp_neg);
+
+    // broadcasting: row vector against a matrix (host order is column-major)
+    auto m = cppgrad::Tensor({2,3}, {1,2,3,4,5,6});
+    auto row = cppgrad::Tensor({3}, {10,20,30});
+    std::vector<float> exp_row = {11,14,22,25,33,36};
+    REQUIRE(to_vector(m + row) == exp_row);
+    REQUIRE(to_vector(row + m) == exp_row);
+
+    // keepdim reduction broadcast back over its axis
+    auto centered = m - m.mean(1, true);
+    std::vector<float> exp_centered = {-1,-1,0,0,1,1};
+    REQUIRE(to_vector(centered) == exp_centered);
+
+    // incompatible shapes still throw
+    REQUIRE_THROWS(m + cppgrad::Tensor::ones({4}));
 }
 
 TEST_CASE("Elementwise functions: exp, log, pow", "[tensor]") {
@@ -113,6 +177,55 @@ TEST_CASE("Elementwise functions: exp, log, pow", "[tensor]") {
     for (auto v : to_vector(pw2)) REQUIRE(v == Approx(std::pow(4.0f, 2.0f)));
 }
 
+TEST_CASE("Activations: relu, sigmoid, tanh, gelu, silu", "[tensor][activation]") {
+    auto x = cppgrad::Tensor({4}, {-2.0f, -0.5f, 0.0f, 1.5f});
+    const std::vector<float> xs = {-2.0f, -0.5f, 0.0f, 1.5f};
+
+    auto r = to_vector(relu(x));
+    auto s = to_vector(sigmoid(x));
+    auto t = to_vector(tanh(x));
+    auto g = to_vector(gelu(x));
+    auto si = to_vector(silu(x));
+    for (size_t i = 0; i < xs.size(); ++i) {
+        const float sig = 1.0f / (1.0f + std::exp(-xs[i]));
+        REQUIRE(r[i] == Approx(std::max(xs[i], 0.0f)));
+        REQUIRE(s[i] == Approx(sig));
+        REQUIRE(t[i] == Approx(std::tanh(xs[i])));
+        REQUIRE(g[i] == Approx(0.5f * xs[i] * (1.0f + std::erf(xs[i] / std::sqrt(2.0f)))).margin(1e-6));
+        REQUIRE(si[i] == Approx(xs[i] * sig).margin(1e-6));
+    }
+    REQUIRE(relu(x).shape() == x.shape());
+}
+
+TEST_CASE("Softmax family is stable for large logits", "[tensor][softmax]") {
+    // Rows (1000, 1001, 1002) and (0, 0, 0): exp would overflow without the max shift
+    auto x = cppgrad::Tensor({2, 3}, {1000, 1001, 1002, 0, 0, 0});
+
+    const float e0 = std::exp(-2.0f), e1 = std::exp(-1.0f);
+    const float z = e0 + e1 + 1.0f;
+    auto p = to_vector(softmax(x, 1));
+    REQUIRE(p[0] == Approx(e0 / z));            // column-major: (0,0), (1,0), (0,1), ...
+    REQUIRE(p[1] == Approx(1.0f / 3.0f));
+    REQUIRE(p[4] == Approx(1.0f / z));
+    for (auto v : p) REQUIRE(std::isfinite(v));
+
+    auto lp = to_vector(log_softmax(x, 1));
+    REQUIRE(lp[4] == Approx(-std::log(z)));
+    REQUIRE(lp[5] == Approx(-std::log(3.0f)));
+
+    auto lse = logsumexp(x, 1);
+    REQUIRE(lse.shape() == std::vector<size_t>{2});
+    REQUIRE(to_vector(lse)[0] == Approx(1002.0f + std::log(z)));
+    REQUIRE(to_scalar(logsumexp(x)) == Approx(1002.0f + std::log(z)));
+
+    // Mean of -log p[label]: row 0 → class 2, row 1 → class 0
+    auto loss = cross_entropy(x, {2, 0});
+    REQUIRE(loss.shape().empty());
+    REQUIRE(to_scalar(loss) == Approx(0.5f * (std::log(z) + std::log(3.0f))));
+    REQUIRE_THROWS(cross_entropy(x, {3, 0}));
+    REQUIRE_THROWS(cross_entropy(x, {0}));
+}
+
 TEST_CASE("Reduction operations: sum, mean, max", "[tensor]") {
     std::vector<float> vals = {1,2,3,4,5,6};
     auto t = cppgrad::Tensor({2,3}, vals);
@@ -124,13 +237,312 @@ TEST_CASE("Reduction operations: sum, mean, max", "[tensor]") {
     REQUIRE(to_scalar(mx_all) == Approx(6.0f));
 
     auto s_dim0 = t.sum(0);
-    //REQUIRE(s_dim0.shape() == std::vector<size_t>{3});
+    REQUIRE(s_dim0.shape() == std::vector<size_t>{3});
     std::vector<float> exp_s0 = {1+4,2+5,3+6};
     REQUIRE(to_vector(s_dim0) == exp_s0);
 
     auto m_dim1_k = t.mean(1, true);
-    //REQUIRE(m_dim1_k.shape() == std::vector<size_t>{2,1});
+    REQUIRE(m_dim1_k.shape() == std::vector<size_t>{2,1});
     std::vector<float> exp_m1 = {(1+2+3)/3.0f, (4+5+6)/3.0f};
     REQUIRE(to_vector(m_dim1_k) == exp_m1);
 }
 
+TEST_CASE("Reductions: min, prod, var, std, argmax and multiple axes", "[tensor][reduction]") {
+    auto t = cppgrad::Tensor({2, 3}, {4, -1, 2, 0, 5, 3});
+
+    REQUIRE(to_scalar(t.min()) == Approx(-1.0f));
+    REQUIRE(to_vector(t.min(1)) == std::vector<float>{-1, 0});
+    REQUIRE(to_vector(t.prod(0)) == to_vector(cppgrad::Tensor({3}, {0, -5, 6})));
+    REQUIRE(to_scalar(t.var()) == Approx(161.0f / 30));       // Σ(x - 13/6)² = 161/6, unbiased
+    REQUIRE(to_scalar(t.var(-1, false)) == Approx(161.0f / 36));
+    REQUIRE(to_scalar(t.std()) == Approx(std::sqrt(161.0f / 30)));
+    REQUIRE(t.var(1, true, true).shape() == std::vector<size_t>{2, 1});
+
+    // Large offsets do not cancel the variance
+    auto shifted = cppgrad::Tensor({4}, {1e4f + 1, 1e4f + 2, 1e4f + 3, 1e4f + 4});
+    REQUIRE(to_scalar(shifted.var(0, false)) == Approx(1.25f));
+
+    // argmax along an axis, or as a row-major flat index
+    REQUIRE(to_vector(t.argmax(1)) == std::vector<float>{0, 1});
+    REQUIRE(to_vector(t.argmin(0)) == to_vector(cppgrad::Tensor({3}, {1, 0, 0})));
+    REQUIRE(to_scalar(t.argmax()) == Approx(4.0f));
+    REQUIRE_FALSE(cppgrad::Tensor::ones({3}, true).argmax().requires_grad());
+
+    // Several axes: adjacent at any rank, arbitrary sets up to rank 4
+    auto u = cppgrad::Tensor::ones({2, 3, 4});
+    REQUIRE(to_vector(u.sum({1, 2})) == std::vector<float>{12, 12});
+    REQUIRE(u.sum({0, 2}, true).shape() == std::vector<size_t>{1, 3, 1});
+    REQUIRE(to_vector(u.sum({0, 2})) == std::vector<float>{8, 8, 8});
+    REQUIRE(to_vector(t.max({0, 1})) == std::vector<float>{5});
+    REQUIRE(to_vector(u.mean({2, 0})) == std::vector<float>{1, 1, 1});
+    REQUIRE(cppgrad::Tensor::ones({2, 1, 3, 1, 2}).sum({2, 3, 4}).shape() == std::vector<size_t>{2, 1});
+    REQUIRE_THROWS(cppgrad::Tensor::ones({2, 1, 3, 1, 2}).sum({0, 4}));
+    REQUIRE_THROWS(u.sum({1, 1}));
+    REQUIRE(to_scalar(logsumexp(cppgrad::Tensor::zeros({2, 2}), std::vector<int>{0, 1})) == Approx(std::log(4.0f)));
+}
+
+TEST_CASE("In-place operations: add_, sub_, mul_, fill_, zero_, clamp_", "[tensor][inplace]") {
+    auto t = cppgrad::Tensor({2, 2}, {1, 2, 3, 4});
+    auto row = cppgrad::Tensor({2}, {10, 20});
+
+    t.add_(row);                                    // broadcast over rows
+    REQUIRE(to_vector(t) == std::vector<float>{11, 13, 22, 24});
+    t.sub_(1.0f).mul_(0.5f);
+    REQUIRE(to_vector(t) == std::vector<float>{5, 6, 10.5f, 11.5f});
+    t.clamp_(6.0f, 11.0f);
+    REQUIRE(to_vector(t) == std::vector<float>{6, 6, 10.5f, 11});
+    REQUIRE(t.version() == 4);
+
+    t.fill_(3.0f);
+    for (auto v : to_vector(t)) REQUIRE(v == Approx(3.0f));
+    t.zero_();
+    for (auto v : to_vector(t)) REQUIRE(v == Approx(0.0f));
+    REQUIRE(t.shape() == std::vector<size_t>{2, 2});
+
+    // The operand may broadcast into the tensor, not grow it
+    REQUIRE_THROWS(row.add_(t));
+}
+
+TEST_CASE("Batched matmul and fused linear", "[tensor][matmul]") {
+    using cppgrad::TensorUtils;
+    auto a = cppgrad::Tensor({2, 2, 2}, {1, 2, 3, 4,   5, 6, 7, 8});
+    auto b = cppgrad::Tensor({2, 2, 2}, {1, 0, 0, 1,   0, 1, 1, 0});   // identity, swap
+
+    auto c = TensorUtils::matmul(a, b);
+    REQUIRE(c.shape() == std::vector<size_t>{2, 2, 2});
+    REQUIRE(to_vector(c.slice(0, 0, 1).reshape({2, 2})) == to_vector(cppgrad::Tensor({2, 2}, {1, 2, 3, 4})));
+    REQUIRE(to_vector(c.slice(0, 1, 2).reshape({2, 2})) == to_vector(cppgrad::Tensor({2, 2}, {6, 5, 8, 7})));
+
+    // A 2D right operand is shared by every batch entry
+    auto w = cppgrad::Tensor({2, 3}, {1, 0, 1, 0, 1, 1});
+    auto d = TensorUtils::matmul(a, w);
+    REQUIRE(d.shape() == std::vector<size_t>{2, 2, 3});
+    REQUIRE(to_vector(d.slice(0, 1, 2).reshape({2, 3})) == to_vector(cppgrad::Tensor({2, 3}, {5, 6, 11, 7, 8, 15})));
+    REQUIRE_THROWS(TensorUtils::matmul(a, cppgrad::Tensor::ones({3, 2})));
+
+    // linear(x, W, b) = x @ Wᵀ + b with W stored as (out, in)
+    auto x = cppgrad::Tensor({2, 3}, {1, 2, 3, -1, -2, -3});
+    auto W = cppgrad::Tensor({2, 3}, {1, 1, 1, 0, 1, 0});
+    auto bias = cppgrad::Tensor({2}, {0.5f, -1.0f});
+    auto y = linear(x, W, bias);
+    REQUIRE(y.shape() == std::vector<size_t>{2, 2});
+    REQUIRE(to_vector(y) == to_vector(cppgrad::Tensor({2, 2}, {6.5f, 1, -5.5f, -3})));
+    REQUIRE(to_vector(linear(x, W, bias, cppgrad::Activation::Relu)) ==
+            to_vector(cppgrad::Tensor({2, 2}, {6.5f, 1, 0, 0})));
+    REQUIRE(linear(cppgrad::Tensor::ones({4, 2, 3}), W).shape() == std::vector<size_t>{4, 2, 2});
+}
+
+TEST_CASE("layer_norm and batch_norm", "[tensor][norm]") {
+    const float s = std::sqrt(1.5f);   // 1 / std of {1, 2, 3}
+    auto x = cppgrad::Tensor({2, 3}, {1, 2, 3, 10, 20, 30});
+
+    auto y = layer_norm(x, {3}, 0.0f);
+    auto expected = to_vector(cppgrad::Tensor({2, 3}, {-s, 0, s, -s, 0, s}));
+    auto got = to_vector(y);
+    for (size_t i = 0; i < got.size(); ++i) REQUIRE(got[i] == Approx(expected[i]).margin(1e-5));
+
+    auto w = cppgrad::Tensor({3}, {1, 2, 3});
+    auto b = cppgrad::Tensor({3}, {0, 1, 0});
+    got = to_vector(layer_norm(x, {3}, w, b, 0.0f));
+    expected = to_vector(cppgrad::Tensor({2, 3}, {-s, 1, 3 * s, -s, 1, 3 * s}));
+    for (size_t i = 0; i < got.size(); ++i) REQUIRE(got[i] == Approx(expected[i]).margin(1e-5));
+    REQUIRE(layer_norm(cppgrad::Tensor::randn({4, 2, 3}), {2, 3}).shape() == std::vector<size_t>{4, 2, 3});
+    REQUIRE_THROWS(layer_norm(x, {2}));
+
+    // Channels are columns of (N, C): batch statistics, then running stats in eval mode
+    auto bx = cppgrad::Tensor({3, 2}, {1, 10, 2, 20, 3, 30});
+    auto running_mean = cppgrad::Tensor::zeros({2});
+    auto running_var = cppgrad::Tensor::ones({2});
+    got = to_vector(batch_norm(bx, running_mean, running_var, { .eps = 0.0f }));
+    expected = to_vector(cppgrad::Tensor({3, 2}, {-s, -s, 0, 0, s, s}));
+    for (size_t i = 0; i < got.size(); ++i) REQUIRE(got[i] == Approx(expected[i]).margin(1e-5));
+    REQUIRE(to_vector(running_mean)[0] == Approx(0.2f));            // 0.9 * 0 + 0.1 * 2
+    REQUIRE(to_vector(running_var)[1] == Approx(0.9f + 0.1f * 100)); // unbiased batch variance 100
+    REQUIRE(running_mean.version() == 1);
+
+    auto eval = batch_norm(bx, running_mean, running_var, { .training = false, .eps = 0.0f });
+    REQUIRE(to_vector(eval)[0] == Approx((1 - 0.2f) / std::sqrt(0.9f + 0.1f)));
+    REQUIRE(running_mean.version() == 1);
+    REQUIRE_THROWS(batch_norm(bx, running_var, running_mean, cppgrad::Tensor::ones({3}), b));
+}
+
+TEST_CASE("conv2d and pooling over NCHW tensors", "[tensor][conv]") {
+    using cppgrad::ConvAlgorithm;
+    auto x = cppgrad::Tensor({1, 1, 3, 3}, {1, 2, 3, 4, 5, 6, 7, 8, 9});
+    auto w = cppgrad::Tensor({1, 1, 2, 2}, {1, 2, 0, 0});   // x[i][j] + 2 x[i][j+1]
+    auto b = cppgrad::Tensor::full({1}, 1.0f);
+
+    // Cross-correlation (no kernel flip), on both paths
+    auto expected = to_vector(cppgrad::Tensor({1, 1, 2, 2}, {6, 9, 15, 18}));
+    for (auto algorithm : {ConvAlgorithm::Im2col, ConvAlgorithm::Direct}) {
+        auto y = conv2d(x, w, b, { .algorithm = algorithm });
+        REQUIRE(y.shape() == std::vector<size_t>{1, 1, 2, 2});
+        REQUIRE(to_vector(y) == expected);
+    }
+    REQUIRE(conv2d(x, w, { .padding = 1 }).shape() == std::vector<size_t>{1, 1, 4, 4});
+    REQUIRE_THROWS(conv2d(x, w, { .dilation = 2, .algorithm = ConvAlgorithm::Im2col }));
+    REQUIRE_THROWS(conv2d(x, cppgrad::Tensor::ones({1, 2, 2, 2})));
+
+    // Grouped, strided and padded: both paths agree
+    auto xs = cppgrad::Tensor::randn({2, 4, 7, 7});
+    auto ws = cppgrad::Tensor::randn({6, 2, 3, 3});
+    cppgrad::Conv2dOptions opts{ .stride = 2, .padding = 1, .groups = 2 };
+    opts.algorithm = ConvAlgorithm::Im2col;
+    auto via_gemm = conv2d(xs, ws, opts);
+    opts.algorithm = ConvAlgorithm::Direct;
+    auto direct = conv2d(xs, ws, opts);
+    REQUIRE(via_gemm.shape() == std::vector<size_t>{2, 6, 4, 4});
+    auto g = to_vector(via_gemm), d = to_vector(direct);
+    for (size_t i = 0; i < g.size(); ++i) REQUIRE(g[i] == Approx(d[i]).margin(1e-4));
+
+    auto img = cppgrad::Tensor({1, 1, 4, 4}, {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16});
+    REQUIRE(to_vector(max_pool2d(img, 2)) == to_vector(cppgrad::Tensor({1, 1, 2, 2}, {6, 8, 14, 16})));
+    REQUIRE(to_vector(avg_pool2d(img, 2)) == to_vector(cppgrad::Tensor({1, 1, 2, 2}, {3.5f, 5.5f, 11.5f, 13.5f})));
+
+    // Padding never wins a max, even over negative inputs, but counts towards a mean
+    auto neg = cppgrad::Tensor({1, 1, 3, 3}, {-1, -2, -3, -4, -5, -6, -7, -8, -9});
+    REQUIRE(to_vector(max_pool2d(neg, 2, 2, 1)) == to_vector(cppgrad::Tensor({1, 1, 2, 2}, {-1, -3, -7, -9})));
+    REQUIRE(to_vector(avg_pool2d(neg, 2, 2, 1)) == to_vector(cppgrad::Tensor({1, 1, 2, 2}, {-0.25f, -1.25f, -2.75f, -7})));
+
+    // A window could lie entirely in wider padding
+    REQUIRE_THROWS(max_pool2d(neg, 2, 1, 2));
+}
+
+TEST_CASE("View operations: slice, transpose, reshape, squeeze", "[tensor][view]") {
+    auto m = cppgrad::Tensor({2,3}, {1,2,3,4,5,6});   // host order 1,4,2,5,3,6
+
+    REQUIRE(to_vector(m.slice(1, 1, 3)) == std::vector<float>{2,5,3,6});
+    REQUIRE(to_vector(m.slice(1, 0, 3, 2)) == std::vector<float>{1,4,3,6});
+    REQUIRE(to_vector(m.slice(0, -1, 2)) == std::vector<float>{4,5,6});
+    REQUIRE_THROWS(m.slice(1, 2, 2));
+
+    auto t = m.transpose();
+    REQUIRE(t.shape() == std::vector<size_t>{3,2});
+    REQUIRE_FALSE(t.is_contiguous());
+    REQUIRE_THROWS(t.view({6}));
+    REQUIRE(to_vector(t) == std::vector<float>{1,2,3,4,5,6});
+    REQUIRE(t.is_contiguous());   // materialized by the read above
+    REQUIRE(to_vector(m.transpose().transpose()) == to_vector(m));
+
+    REQUIRE(to_vector(m.view({3,2})) == to_vector(m));
+    REQUIRE(m.reshape({6}).shape() == std::vector<size_t>{6});
+    REQUIRE_THROWS(m.reshape({4}));
+
+    auto u = m.unsqueeze(0);
+    REQUIRE(u.data().dims() == af::dim4(1,2,3,1));
+    REQUIRE(u.squeeze().shape() == std::vector<size_t>{2,3});
+}
+
+TEST_CASE("Rank 5+ tensors fold onto ArrayFire dims", "[tensor][rank]") {
+    auto big = cppgrad::Tensor::ones({2,3,4,5,6});
+    REQUIRE(big.shape() == std::vector<size_t>{2,3,4,5,6});
+    REQUIRE(big.ndim() == 5);
+    REQUIRE(big.numel() == 720);
+    REQUIRE(big.data().dims() == af::dim4(2,3,4,30));
+
+    // Row-major values land in the same column-major order as the 2D case
+    auto t = cppgrad::Tensor({1,1,1,2,3}, {1,2,3,4,5,6});
+    REQUIRE(to_vector(t) == std::vector<float>{1,4,2,5,3,6});
+
+    // Reductions over folded axes
+    auto s4 = t.sum(4);
+    REQUIRE(s4.shape() == std::vector<size_t>{1,1,1,2});
+    REQUIRE(to_vector(s4) == std::vector<float>{6,15});
+    auto s3 = t.sum(3, true);
+    REQUIRE(s3.shape() == std::vector<size_t>{1,1,1,1,3});
+    REQUIRE(to_vector(s3) == std::vector<float>{5,7,9});
+    REQUIRE(to_vector(t.max(4)) == std::vector<float>{3,6});
+    REQUIRE(to_scalar(big.mean()) == Approx(1.0f));
+
+    // Broadcasting across folded axes
+    auto b = cppgrad::Tensor::ones({2,1,4,1,6}) + cppgrad::Tensor::full({4,5,1}, 2.0f);
+    REQUIRE(b.shape() == std::vector<size_t>{2,1,4,5,6});
+    for (auto v : to_vector(b)) REQUIRE(v == Approx(3.0f));
+
+    // Views keep working above rank 4
+    REQUIRE(big.unsqueeze(5).shape() == std::vector<size_t>{2,3,4,5,6,1});
+    REQUIRE(big.slice(4, 1, 3).shape() == std::vector<size_t>{2,3,4,5,2});
+    REQUIRE(big.reshape({6,4,30}).shape() == std::vector<size_t>{6,4,30});
+
+    // Permutes and transposes above rank 4 copy; check against host indexing
+    const std::vector<size_t> dims = {2,3,1,4,2};
+    std::vector<float> values(48);
+    for (size_t i = 0; i < values.size(); ++i) values[i] = static_cast<float>(i);
+    auto x = cppgrad::Tensor::from_array_column_major(dims, values, true);
+    const std::vector<unsigned> perm = {3,0,4,2,1};
+    auto p = x.permute(perm);
+    REQUIRE(p.shape() == std::vector<size_t>{4,2,2,1,3});
+    auto pv = to_vector(p);
+    size_t n = 0;
+    for (size_t i1 = 0; i1 < 3; ++i1)
+        for (size_t i4 = 0; i4 < 2; ++i4)
+            for (size_t i0 = 0; i0 < 2; ++i0)
+                for (size_t i3 = 0; i3 < 4; ++i3)
+                    REQUIRE(pv[n++] == values[i0 + 2 * (i1 + 3 * (i3 + 4 * i4))]);
+
+    // Backward applies the inverse permutation
+    auto w = cppgrad::Tensor::from_array_column_major(p.shape(), values);
+    (p * w).sum().backward();
+    std::vector<float> g(values.size());
+    x.grad().host(g.data());
+    n = 0;
+    for (size_t i1 = 0; i1 < 3; ++i1)
+        for (size_t i4 = 0; i4 < 2; ++i4)
+            for (size_t i0 = 0; i0 < 2; ++i0)
+                for (size_t i3 = 0; i3 < 4; ++i3)
+                    REQUIRE(g[i0 + 2 * (i1 + 3 * (i3 + 4 * i4))] == values[n++]);
+
+    auto tr = x.transpose(3, 4);
+    REQUIRE(tr.shape() == std::vector<size_t>{2,3,1,2,4});
+    REQUIRE(to_vector(tr.transpose(3, 4)) == values);
+    REQUIRE_THROWS(x.transpose(0, 5));
+}
+
+TEST_CASE("Shape: inline storage, heap spill and size-1 axes", "[tensor][shape]") {
+    cppgrad::Shape s = {2, 3};
+    s.push_back(4);
+    s.insert(s.begin(), 1);
+    REQUIRE(s == std::vector<size_t>{1, 2, 3, 4});
+    s.erase(s.begin() + 2);
+    REQUIRE(s == cppgrad::Shape{1, 2, 4});
+    REQUIRE(s.numel() == 8);
+
+    // Past the inline capacity the axes move to the heap and survive copies
+    cppgrad::Shape big(10, 2);
+    big.push_back(3);
+    cppgrad::Shape copy = big;
+    cppgrad::Shape moved = std::move(big);
+    REQUIRE(copy == moved);
+    REQUIRE(moved.size() == 11);
+    REQUIRE(moved[10] == 3);
+
+    // Size-1 axes are part of the shape
+    REQUIRE(cppgrad::Tensor::zeros({1, 5}).shape() != cppgrad::Tensor::zeros({5}).shape());
+    REQUIRE(cppgrad::Tensor::zeros({1, 5}).shape() == std::vector<size_t>{1, 5});
+}
+
+TEST_CASE("Memory pool: buffer reuse, statistics and cache release", "[tensor][memory]") {
+    cppgrad::MemoryPool::install();
+    REQUIRE(cppgrad::MemoryPool::is_installed());
+    cppgrad::MemoryPool::reset_peak();
+    auto before = cppgrad::memory_stats();
+
+    {
+        cppgrad::MemoryStepGuard step;
+        for (int i = 0; i < 4; ++i) {
+            auto a = cppgrad::Tensor::ones({64, 64});
+            auto b = a * 2.0f;
+            af::eval(b.data());
+        }
+    }
+
+    auto after = cppgrad::memory_stats();
+    REQUIRE(after.alloc_count > before.alloc_count);
+    REQUIRE(after.cache_hits > before.cache_hits);      // same-size results are recycled
+    REQUIRE(after.peak_bytes >= 64 * 64 * sizeof(float));
+    REQUIRE(after.reserved_bytes == after.current_bytes + after.cached_bytes);
+    REQUIRE(after.hit_rate() > 0.0);
+
+    cppgrad::MemoryPool::release_cached();
+    REQUIRE(cppgrad::memory_stats().cached_bytes == 0);
+}